@@ -9,6 +9,7 @@
 #include <takatori/util/maybe_shared_ptr.h>
 
 #include <yugawara/util/maybe_shared_lock.h>
+#include <yugawara/util/snapshot_guard.h>
 
 #include "provider.h"
 
@@ -16,7 +17,8 @@ namespace yugawara::aggregate {
 
 /**
  * @brief an implementation of provider that can configurable its contents.
- * @tparam Mutex the mutex type, must satisfy *DefaultConstructible* and *BasicLockable*
+ * @tparam Mutex the mutex type, must satisfy *DefaultConstructible* and *BasicLockable*,
+ *      or util::snapshot_mutex to read the contents without any locks
  * @note This class works as thread-safe only if the mutex works right
  */
 template<class Mutex>
@@ -40,6 +42,14 @@ public:
         parent_ { std::move(parent) }
     {}
 
+    [[nodiscard]] epoch_type epoch() const noexcept override {
+        auto result = declarations_.version();
+        if (parent_) {
+            result += parent_->epoch();
+        }
+        return result;
+    }
+
     using provider::each;
 
     void each(consumer_type const& consumer) const override {
@@ -66,8 +76,8 @@ public:
      */
     std::shared_ptr<declaration> const& add(std::shared_ptr<declaration> element) {
         key_type key { element->name() };
-        writer_lock_type lock { mutex_ };
-        auto iter = declarations_.emplace(std::move(key), std::move(element));
+        auto declarations = declarations_.write();
+        auto iter = declarations->emplace(std::move(key), std::move(element));
         return iter->second;
     }
 
@@ -87,12 +97,12 @@ public:
         auto&& name = element.name();
         auto&& id = element.definition_id();
 
-        writer_lock_type lock { mutex_ };
-        auto first = declarations_.lower_bound(name);
-        auto last = declarations_.upper_bound(name);
+        auto declarations = declarations_.write();
+        auto first = declarations->lower_bound(name);
+        auto last = declarations->upper_bound(name);
         for (auto iter = first; iter != last; ++iter) {
             if (auto&& found = iter->second; found && found->definition_id() == id) {
-                declarations_.erase(iter);
+                declarations->erase(iter);
                 return true;
             }
         }
@@ -108,12 +118,11 @@ private:
             std::less<>>;
 
     ::takatori::util::maybe_shared_ptr<provider const> parent_;
-    map_type declarations_;
-    mutable mutex_type mutex_ {};
+    util::snapshot_guard<map_type, mutex_type> declarations_ {};
 
     void internal_each(consumer_type const& consumer) const {
-        reader_lock_type lock { mutex_ };
-        for (auto&& [name, declaration] : declarations_) {
+        auto declarations = declarations_.read();
+        for (auto&& [name, declaration] : *declarations) {
             (void) name;
             consumer(declaration);
         }
@@ -123,9 +132,9 @@ private:
             std::string_view name,
             std::size_t parameter_count,
             consumer_type const& consumer) const {
-        reader_lock_type lock { mutex_ };
-        auto first = declarations_.lower_bound(name);
-        auto last = declarations_.upper_bound(name);
+        auto declarations = declarations_.read();
+        auto first = declarations->lower_bound(name);
+        auto last = declarations->upper_bound(name);
         for (auto iter = first; iter != last; ++iter) {
             if (auto&& found = iter->second;
                     found
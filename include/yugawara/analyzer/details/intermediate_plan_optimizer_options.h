@@ -1,8 +1,13 @@
 #pragma once
 
+#include <limits>
+
+#include <cstddef>
+
 #include <takatori/util/maybe_shared_ptr.h>
 
 #include <yugawara/analyzer/index_estimator.h>
+#include <yugawara/analyzer/exchange_column_layout.h>
 #include <yugawara/runtime_feature.h>
 
 namespace yugawara::analyzer::details {
@@ -40,6 +45,21 @@ public:
     intermediate_plan_optimizer_options& index_estimator(
             ::takatori::util::maybe_shared_ptr<analyzer::index_estimator const> estimator) noexcept;
 
+    /**
+     * @brief returns the provider of physical shapes of column values.
+     * @details This is used to estimate the data size of join inputs.
+     * @return the column shape provider
+     * @return empty if it is absent
+     */
+    [[nodiscard]] exchange_column_shape_provider const& exchange_column_shapes() const noexcept;
+
+    /**
+     * @brief sets the provider of physical shapes of column values.
+     * @param shapes the column shape provider
+     * @return this
+     */
+    intermediate_plan_optimizer_options& exchange_column_shapes(exchange_column_shape_provider shapes);
+
     /**
      * @brief returns whether to enable disjunction range hinting.
      * @return true if disjunction range hinting is enabled
@@ -61,12 +81,83 @@ public:
     /// @copydoc enable_external_variable_inlining()
     [[nodiscard]] bool enable_external_variable_inlining() const noexcept;
 
+    /**
+     * @brief returns whether to push down projections.
+     * @details if enabled, the optimizer decomposes projections, and then moves each of them into the join inputs
+     *      if it is possible.
+     * @return true if projection pushdown is enabled
+     * @return false otherwise
+     */
+    [[nodiscard]] bool& enable_projection_pushdown() noexcept;
+
+    /// @copydoc enable_projection_pushdown()
+    [[nodiscard]] bool enable_projection_pushdown() const noexcept;
+
+    /**
+     * @brief returns the max data size of the build side input of broadcast joins, in bytes.
+     * @details The join inputs whose estimated data size exceeds this limit are never broadcast.
+     * @return the max data size of broadcast join inputs
+     */
+    [[nodiscard]] std::size_t& broadcast_build_size_limit() noexcept;
+
+    /// @copydoc broadcast_build_size_limit()
+    [[nodiscard]] std::size_t broadcast_build_size_limit() const noexcept;
+
+    /**
+     * @brief returns the estimated number of consumers of each broadcast exchange.
+     * @return the estimated number of consumers of broadcast exchanges
+     */
+    [[nodiscard]] std::size_t& broadcast_fan_out() noexcept;
+
+    /// @copydoc broadcast_fan_out()
+    [[nodiscard]] std::size_t broadcast_fan_out() const noexcept;
+
+    /**
+     * @brief returns the max number of rows in join inputs which are always acceptable for broadcast.
+     * @return the max number of rows in join inputs which are always acceptable for broadcast
+     */
+    [[nodiscard]] std::size_t& broadcast_row_threshold() noexcept;
+
+    /// @copydoc broadcast_row_threshold()
+    [[nodiscard]] std::size_t broadcast_row_threshold() const noexcept;
+
+    /**
+     * @brief returns whether to eliminate common sub-expressions.
+     * @details if enabled, the optimizer computes the repeated sub-expressions only once for each row.
+     * @return true if common sub-expression elimination is enabled
+     * @return false otherwise
+     */
+    [[nodiscard]] bool& enable_common_subexpression_elimination() noexcept;
+
+    /// @copydoc enable_common_subexpression_elimination()
+    [[nodiscard]] bool enable_common_subexpression_elimination() const noexcept;
+
+    /**
+     * @brief returns whether to hoist row-invariant sub-expressions.
+     * @details if enabled, the optimizer replaces sub-expressions which only consist of constants and
+     *      external variables with frame variables, and then exposes their declarations.
+     * @return true if invariant expression hoisting is enabled
+     * @return false otherwise
+     * @see intermediate_plan_optimizer::invariants()
+     */
+    [[nodiscard]] bool& enable_invariant_hoisting() noexcept;
+
+    /// @copydoc enable_invariant_hoisting()
+    [[nodiscard]] bool enable_invariant_hoisting() const noexcept;
+
 private:
     ::takatori::util::maybe_shared_ptr<analyzer::index_estimator const> index_estimator_ {};
     runtime_feature_set runtime_features_ { runtime_feature_all };
+    exchange_column_shape_provider exchange_column_shapes_ {};
 
     bool enable_disjunction_range_hinting_ {};
     bool enable_external_variable_inlining_ {};
+    bool enable_projection_pushdown_ {};
+    std::size_t broadcast_build_size_limit_ { std::numeric_limits<std::size_t>::max() };
+    std::size_t broadcast_fan_out_ { 4 };
+    std::size_t broadcast_row_threshold_ { 1'000 };
+    bool enable_common_subexpression_elimination_ {};
+    bool enable_invariant_hoisting_ {};
 };
 
 } // namespace yugawara::analyzer::details
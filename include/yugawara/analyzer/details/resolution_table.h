@@ -0,0 +1,246 @@
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace yugawara::analyzer::details {
+
+/**
+ * @brief a flat table which maps keys to their resolution.
+ * @details The entries are stored densely, and are addressed by their ordinals.
+ *      The ordinals of erased entries are reused by the succeeding insertions, so that repeated insertions and
+ *      erasures do not grow the table.
+ *      Lookup uses a compact open-addressing index (linear probing) of the ordinals, which also keeps
+ *      the hash code of each entry, so that the key equivalence is rarely tested and the index can be
+ *      rebuilt without re-computing the hash codes.
+ *
+ *      Like `std::unordered_map`, references to the stored values are never invalidated until the
+ *      corresponded entry is erased or the table is cleared.
+ * @tparam Key the key type
+ * @tparam Value the value type
+ * @tparam Hash the hash function of keys
+ * @tparam KeyEqual the equivalence function of keys
+ */
+template<class Key, class Value, class Hash = std::hash<Key>, class KeyEqual = std::equal_to<>>
+class resolution_table {
+public:
+    /// @brief the key type.
+    using key_type = Key;
+
+    /// @brief the mapped value type.
+    using mapped_type = Value;
+
+    /// @brief the size type.
+    using size_type = std::size_t;
+
+    /**
+     * @brief returns the number of entries in this table.
+     * @return the number of entries
+     */
+    [[nodiscard]] size_type size() const noexcept {
+        return size_;
+    }
+
+    /**
+     * @brief returns the value for the given key.
+     * @param key the search key
+     * @return the corresponded value
+     * @return nullptr if there is no such an entry
+     */
+    [[nodiscard]] mapped_type const* find(key_type const& key) const {
+        if (auto slot = find_slot(key, hash_(key))) {
+            return std::addressof(entries_[slots_[*slot] - 1]->second);
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief puts a new entry only if there is no entry for the given key.
+     * @param key the entry key
+     * @param value the entry value
+     * @return the stored value, and whether or not the value has been added
+     */
+    std::pair<mapped_type&, bool> try_emplace(key_type const& key, mapped_type&& value) {
+        auto hash = hash_(key);
+        if (auto slot = find_slot(key, hash)) {
+            return { entries_[slots_[*slot] - 1]->second, false };
+        }
+        return { insert(key, hash, std::move(value)), true };
+    }
+
+    /**
+     * @brief puts an entry, or replaces the existing value for the given key.
+     * @param key the entry key
+     * @param value the entry value
+     * @return the stored value
+     */
+    mapped_type& insert_or_assign(key_type const& key, mapped_type value) {
+        auto hash = hash_(key);
+        if (auto slot = find_slot(key, hash)) {
+            auto&& stored = entries_[slots_[*slot] - 1]->second;
+            stored = std::move(value);
+            return stored;
+        }
+        return insert(key, hash, std::move(value));
+    }
+
+    /**
+     * @brief removes the entry for the given key.
+     * @details This releases both the key and the value of the entry, and its ordinal will be reused.
+     * @param key the entry key
+     * @return true if the entry was removed
+     * @return false if there is no such an entry
+     */
+    bool erase(key_type const& key) {
+        auto found = find_slot(key, hash_(key));
+        if (!found) {
+            return false;
+        }
+        auto ordinal = slots_[*found] - 1;
+        remove_slot(*found);
+        hashes_[ordinal].alive = false;
+        entries_[ordinal].reset();
+        free_.push_back(ordinal);
+        --size_;
+        return true;
+    }
+
+    /**
+     * @brief removes all entries.
+     */
+    void clear() noexcept {
+        entries_.clear();
+        hashes_.clear();
+        free_.clear();
+        slots_.clear();
+        bits_ = 0;
+        size_ = 0;
+    }
+
+    /**
+     * @brief invokes the consumer for each entry, in order of their ordinals.
+     * @tparam Consumer the consumer type, which accepts `(key_type const&, mapped_type const&)`
+     * @param consumer the consumer
+     */
+    template<class Consumer>
+    void each(Consumer&& consumer) const {
+        for (size_type i = 0, n = entries_.size(); i < n; ++i) {
+            if (hashes_[i].alive) {
+                auto&& entry = *entries_[i];
+                consumer(entry.first, entry.second);
+            }
+        }
+    }
+
+private:
+    struct hash_entry {
+        std::size_t hash;
+        bool alive;
+    };
+
+    static constexpr size_type min_bits = 3;
+
+    // NOTE: deque never moves its elements on push_back()
+    std::deque<std::optional<std::pair<key_type, mapped_type>>> entries_ {};
+    std::vector<hash_entry> hashes_ {};
+
+    // the ordinals of erased entries
+    std::vector<size_type> free_ {};
+
+    // ordinal + 1 of each entry, or 0 if the slot is empty
+    std::vector<size_type> slots_ {};
+    size_type bits_ { 0 };
+    size_type size_ { 0 };
+
+    Hash hash_ {};
+    KeyEqual equal_ {};
+
+    [[nodiscard]] size_type home(std::size_t hash) const noexcept {
+        // Fibonacci hashing, because pointer hashes often have zeros in their lower bits
+        return static_cast<size_type>((static_cast<std::uint64_t>(hash) * 0x9e3779b97f4a7c15ULL) >> (64U - bits_));
+    }
+
+    [[nodiscard]] size_type mask() const noexcept {
+        return slots_.size() - 1;
+    }
+
+    [[nodiscard]] std::optional<size_type> find_slot(key_type const& key, std::size_t hash) const {
+        if (size_ == 0) {
+            return {};
+        }
+        for (auto index = home(hash);; index = (index + 1) & mask()) {
+            auto slot = slots_[index];
+            if (slot == 0) {
+                return {};
+            }
+            auto&& candidate = hashes_[slot - 1];
+            if (candidate.hash == hash && equal_(entries_[slot - 1]->first, key)) {
+                return index;
+            }
+        }
+    }
+
+    mapped_type& insert(key_type const& key, std::size_t hash, mapped_type&& value) {
+        if ((size_ + 1) * 2 > slots_.size()) {
+            rehash(bits_ == 0 ? min_bits : bits_ + 1);
+        }
+        size_type ordinal {};
+        if (free_.empty()) {
+            ordinal = entries_.size();
+            entries_.emplace_back(std::in_place, key, std::move(value));
+            hashes_.push_back({ hash, true });
+        } else {
+            ordinal = free_.back();
+            entries_[ordinal].emplace(key, std::move(value));
+            free_.pop_back();
+            hashes_[ordinal] = { hash, true };
+        }
+        put_slot(hash, ordinal + 1);
+        ++size_;
+        return entries_[ordinal]->second;
+    }
+
+    void put_slot(std::size_t hash, size_type slot) {
+        auto index = home(hash);
+        while (slots_[index] != 0) {
+            index = (index + 1) & mask();
+        }
+        slots_[index] = slot;
+    }
+
+    void remove_slot(size_type index) {
+        // backward shift deletion
+        slots_[index] = 0;
+        for (auto next = (index + 1) & mask(); slots_[next] != 0; next = (next + 1) & mask()) {
+            auto desired = home(hashes_[slots_[next] - 1].hash);
+            // move the entry only if its desired position is not in (index, next]
+            bool stay = index <= next
+                    ? (index < desired && desired <= next)
+                    : (index < desired || desired <= next);
+            if (!stay) {
+                slots_[index] = slots_[next];
+                slots_[next] = 0;
+                index = next;
+            }
+        }
+    }
+
+    void rehash(size_type bits) {
+        bits_ = bits;
+        slots_.assign(static_cast<size_type>(1) << bits, 0);
+        for (size_type i = 0, n = hashes_.size(); i < n; ++i) {
+            if (hashes_[i].alive) {
+                put_slot(hashes_[i].hash, i + 1);
+            }
+        }
+    }
+};
+
+} // namespace yugawara::analyzer::details
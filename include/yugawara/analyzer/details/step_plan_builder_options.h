@@ -73,10 +73,23 @@ public:
      */
     ::takatori::util::optional_ptr<aggregate_info const> find(::takatori::relation::intermediate::aggregate const& expr) const;
 
+    /**
+     * @brief returns whether or not redundant exchange steps are fused.
+     * @details If enabled, pass-through `forward` exchanges are removed, limits are moved into the preceding
+     *      `group` exchanges as top-N, and adjacent `group` exchanges with the same group keys are merged.
+     * @return true if exchange fusion is enabled
+     * @return false otherwise
+     */
+    [[nodiscard]] bool& enable_exchange_fusion() noexcept;
+
+    /// @copydoc enable_exchange_fusion()
+    [[nodiscard]] bool enable_exchange_fusion() const noexcept;
+
 private:
     join_hint_map join_hints_;
     aggregate_hint_map aggregate_hints_;
     runtime_feature_set runtime_features_ { runtime_feature_all };
+    bool enable_exchange_fusion_ { false };
 };
 
 } // namespace yugawara::analyzer::details
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <ostream>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <takatori/type/data.h>
+#include <takatori/plan/exchange.h>
+
+namespace yugawara::analyzer {
+
+/**
+ * @brief provides the record layout of columns in individual exchange steps.
+ * @details The columns of each exchange step are arranged as following order:
+ *
+ *      1. key columns, in order of group keys and then sort keys
+ *      2. the rest fixed-width columns, in descending order of their alignment
+ *      3. the rest variable-length columns
+ *
+ *      The runtime can compare the leading key_prefix_size() bytes of the encoded records using `memcmp`,
+ *      if the key columns are encoded in an order-preserving manner.
+ */
+class exchange_column_layout {
+public:
+    /**
+     * @brief creates a new instance.
+     */
+    constexpr exchange_column_layout() = default;
+
+    /**
+     * @brief creates a new instance.
+     * @param key_count the number of leading key columns
+     * @param key_prefix_size the number of bytes of leading fixed-width key columns
+     */
+    constexpr exchange_column_layout(std::size_t key_count, std::size_t key_prefix_size) noexcept :
+        key_count_ { key_count },
+        key_prefix_size_ { key_prefix_size }
+    {}
+
+    /**
+     * @brief returns the number of leading key columns.
+     * @return the number of key columns
+     */
+    [[nodiscard]] constexpr std::size_t key_count() const noexcept {
+        return key_count_;
+    }
+
+    /**
+     * @brief returns the total number of bytes of the leading fixed-width key columns.
+     * @details This only counts the key columns until the first variable-length key column.
+     * @return the number of bytes of the fixed-size key prefix
+     * @return 0 if there are no such key columns
+     */
+    [[nodiscard]] constexpr std::size_t key_prefix_size() const noexcept {
+        return key_prefix_size_;
+    }
+
+private:
+    std::size_t key_count_ {};
+    std::size_t key_prefix_size_ {};
+};
+
+/**
+ * @brief the physical shape of fixed-width column values in exchange records.
+ */
+struct exchange_column_shape {
+    /// @brief the number of bytes.
+    std::size_t size;
+    /// @brief the alignment, must be a power of 2.
+    std::size_t alignment;
+};
+
+/**
+ * @brief provides the physical shape of column values of the given type in exchange records.
+ * @details The shape depends on how the runtime encodes the individual values,
+ *      so that the runtime must provide it.
+ *      The provider returns empty if values of the type are variable-length.
+ */
+using exchange_column_shape_provider = std::function<
+        std::optional<exchange_column_shape>(::takatori::type::data const&)>;
+
+/// @brief a map of exchange column layouts.
+using exchange_column_layout_map = std::unordered_map<
+        ::takatori::plan::exchange const*,
+        exchange_column_layout,
+        std::hash<::takatori::plan::exchange const*>,
+        std::equal_to<>>;
+
+/**
+ * @brief a set of exchanges whose input records have been already partitioned by their group keys.
+ * @details The runtime can regroup the input records of such exchanges in each partition,
+ *      instead of transferring them to the other partitions.
+ */
+using partitioned_exchange_set = std::unordered_set<
+        ::takatori::plan::exchange const*,
+        std::hash<::takatori::plan::exchange const*>,
+        std::equal_to<>>;
+
+/**
+ * @brief appends string representation of the given value.
+ * @param out the target output
+ * @param value the target value
+ * @return the output stream
+ */
+inline std::ostream& operator<<(std::ostream& out, exchange_column_layout const& value) {
+    return out << "exchange_column_layout("
+               << "key_count=" << value.key_count() << ", "
+               << "key_prefix_size=" << value.key_prefix_size() << ")";
+}
+
+} // namespace yugawara::analyzer
@@ -23,6 +23,13 @@
 
 namespace yugawara::analyzer {
 
+namespace details {
+
+/// @private
+class retained_expressions;
+
+} // namespace details
+
 /**
  * @brief computes each type of expressions.
  */
@@ -83,6 +90,24 @@ public:
      */
     expression_analyzer& allow_unresolved(bool allow) noexcept;
 
+    /**
+     * @brief retains the current resolutions of compound expressions, and then clears the expression mapping.
+     * @details The succeeding resolve() reuses the retained resolution of unary, binary, and comparison
+     *      expressions only if the expression object still has the same operator and the same operand types.
+     *      Otherwise, the expression is resolved again.
+     *
+     *      This is designed for re-analyzing a plan after optimization, because most of the expressions are
+     *      kept or just moved by the optimizer.
+     *      The expressions in the current mapping must be alive while calling this.
+     * @see clear_retained_expressions()
+     */
+    void retain_expressions();
+
+    /**
+     * @brief discards the resolutions retained by retain_expressions().
+     */
+    void clear_retained_expressions() noexcept;
+
     /**
      * @brief extracts the type of the given resolution.
      * @param resolution the target resolution
@@ -225,6 +250,7 @@ private:
     ::takatori::util::maybe_shared_ptr<variable_mapping> variables_;
     bool allow_unresolved_ { true };
     std::vector<diagnostic_type> diagnostics_;
+    std::shared_ptr<details::retained_expressions> retained_ {};
 };
 
 } // namespace yugawara::analyzer
@@ -2,13 +2,14 @@
 
 #include <functional>
 #include <memory>
-#include <unordered_map>
 
 #include <takatori/scalar/expression.h>
 #include <takatori/type/data.h>
 
 #include "expression_resolution.h"
 
+#include "details/resolution_table.h"
+
 namespace yugawara::analyzer {
 
 /**
@@ -68,11 +69,9 @@ public:
     void clear() noexcept;
 
 private:
-    std::unordered_map<
+    details::resolution_table<
             ::takatori::scalar::expression const*,
-            expression_resolution,
-            std::hash<::takatori::scalar::expression const*>,
-            std::equal_to<>> mapping_;
+            expression_resolution> mapping_;
 };
 
 } // namespace yugawara::analyzer
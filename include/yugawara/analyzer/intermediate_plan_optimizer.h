@@ -1,7 +1,11 @@
 #pragma once
 
+#include <vector>
+
 #include <takatori/relation/graph.h>
 
+#include <yugawara/analyzer/invariant_declaration.h>
+
 #include "details/intermediate_plan_optimizer_options.h"
 
 namespace yugawara::analyzer {
@@ -43,8 +47,16 @@ public:
      */
     void operator()(::takatori::relation::graph_type& graph);
 
+    /**
+     * @brief returns the row-invariant values which were hoisted from the last optimized plan.
+     * @details This is always empty unless options_type::enable_invariant_hoisting() is enabled.
+     * @return the declarations of row-invariant values
+     */
+    [[nodiscard]] std::vector<invariant_declaration>& invariants() noexcept;
+
 private:
     options_type options_;
+    std::vector<invariant_declaration> invariants_ {};
 };
 
 } // namespace yugawara::analyzer
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <memory>
+#include <ostream>
+
+#include <takatori/descriptor/variable.h>
+#include <takatori/scalar/expression.h>
+
+namespace yugawara::analyzer {
+
+/**
+ * @brief a declaration of row-invariant value, which is computed once per statement execution.
+ * @details The optimizer may replace row-invariant sub-expressions, which only consist of constants and
+ *      external variables, with references to the declared variable.
+ *      The runtime must evaluate value() lazily, when the variable is first referred in the statement execution,
+ *      and then it must bind the result to variable() for the rest of the statement execution.
+ *      The runtime must not evaluate value() if the variable is never referred, because it may raise an error
+ *      which the original statement would never raise, for example, division by zero in an unreachable branch.
+ *      If the evaluation raises an error, the runtime raises it at the referring position.
+ *
+ *      The declared variable is a frame variable, which is available in the whole statement.
+ */
+class invariant_declaration {
+public:
+    /**
+     * @brief creates a new instance.
+     * @param variable the declared variable
+     * @param value the row-invariant value of the variable
+     */
+    invariant_declaration(
+            ::takatori::descriptor::variable variable,
+            std::unique_ptr<::takatori::scalar::expression> value) noexcept;
+
+    /**
+     * @brief returns the declared variable.
+     * @return the declared variable
+     */
+    [[nodiscard]] ::takatori::descriptor::variable const& variable() const noexcept;
+
+    /**
+     * @brief returns the row-invariant value of the variable.
+     * @return the variable value
+     */
+    [[nodiscard]] ::takatori::scalar::expression& value() noexcept;
+
+    /// @copydoc value()
+    [[nodiscard]] ::takatori::scalar::expression const& value() const noexcept;
+
+private:
+    ::takatori::descriptor::variable variable_;
+    std::unique_ptr<::takatori::scalar::expression> value_;
+};
+
+/**
+ * @brief appends string representation of the given value.
+ * @param out the target output
+ * @param value the target value
+ * @return the output stream
+ */
+std::ostream& operator<<(std::ostream& out, invariant_declaration const& value);
+
+} // namespace yugawara::analyzer
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <ostream>
+
+namespace yugawara::analyzer {
+
+/**
+ * @brief scheduling hints of a process step.
+ * @see step_plan_scheduler
+ */
+class process_schedule {
+public:
+    /// @brief the size type.
+    using size_type = std::size_t;
+
+    /**
+     * @brief creates a new instance.
+     * @param level the topological level of the process
+     * @param critical whether or not the process is on the critical path
+     * @param estimated_rows the estimated number of input rows, or empty if it is unknown
+     * @param parallelism the suggested degree of parallelism
+     */
+    constexpr process_schedule(
+            size_type level,
+            bool critical,
+            std::optional<size_type> estimated_rows,
+            size_type parallelism) noexcept :
+        level_ { level },
+        critical_ { critical },
+        estimated_rows_ { estimated_rows },
+        parallelism_ { parallelism }
+    {}
+
+    /**
+     * @brief returns the topological level of the process.
+     * @details Processes without any upstream processes are level `0`, and the others are the next level of
+     *      their deepest upstream. The processes in the same level never depend on each other.
+     * @return the topological level
+     */
+    [[nodiscard]] constexpr size_type level() const noexcept {
+        return level_;
+    }
+
+    /**
+     * @brief returns whether or not the process is on the critical path of the step plan.
+     * @return true if the process is on the critical path
+     * @return false otherwise
+     */
+    [[nodiscard]] constexpr bool critical() const noexcept {
+        return critical_;
+    }
+
+    /**
+     * @brief returns the estimated number of rows which the process will receive.
+     * @return the estimated number of rows
+     * @return empty if it is unknown
+     */
+    [[nodiscard]] constexpr std::optional<size_type> estimated_rows() const noexcept {
+        return estimated_rows_;
+    }
+
+    /**
+     * @brief returns the suggested degree of parallelism of the process.
+     * @return the suggested degree of parallelism, always greater than `0`
+     */
+    [[nodiscard]] constexpr size_type parallelism() const noexcept {
+        return parallelism_;
+    }
+
+private:
+    size_type level_;
+    bool critical_;
+    std::optional<size_type> estimated_rows_;
+    size_type parallelism_;
+};
+
+/**
+ * @brief appends string representation of the given value.
+ * @param out the target output
+ * @param value the target value
+ * @return the output stream
+ */
+inline std::ostream& operator<<(std::ostream& out, process_schedule const& value) {
+    out << "process_schedule("
+        << "level=" << value.level() << ", "
+        << "critical=" << value.critical() << ", "
+        << "estimated_rows=";
+    if (auto rows = value.estimated_rows()) {
+        out << *rows;
+    } else {
+        out << "(unknown)";
+    }
+    return out << ", "
+               << "parallelism=" << value.parallelism() << ")";
+}
+
+} // namespace yugawara::analyzer
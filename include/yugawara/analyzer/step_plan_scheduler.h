@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstddef>
+#include <unordered_map>
+
+#include <takatori/plan/graph.h>
+#include <takatori/plan/process.h>
+
+#include <takatori/util/optional_ptr.h>
+
+#include "process_schedule.h"
+#include "index_estimator.h"
+
+namespace yugawara::analyzer {
+
+/**
+ * @brief computes scheduling hints of process steps in step plans.
+ * @details This annotates each process with the following properties:
+ *
+ *      - the topological level, and whether or not it is on the critical path
+ *      - the estimated number of input rows
+ *      - the suggested degree of parallelism
+ *
+ *      The number of rows is estimated by the given index estimator for `scan` and `find` operators,
+ *      or the number of rows of `values` operators.
+ *      The processes which start with `take_*` operators receive the all rows of their upstream processes,
+ *      that is, the estimation is an upper bound of the actual number of rows.
+ *      If any upstream estimation is unknown, the downstream estimation also becomes unknown.
+ *
+ *      The critical path is the heaviest path from a source process to a sink process, where each process
+ *      weighs its estimated number of rows, or `1` if it is unknown.
+ *      If there are several heaviest paths, this prefers the one which ends with the deepest process,
+ *      and then the one which ends with the first process in the step plan.
+ *      Similarly, each process on the path prefers the first heaviest upstream process.
+ * @see step_plan_builder
+ */
+class step_plan_scheduler {
+public:
+    /// @brief the size type.
+    using size_type = process_schedule::size_type;
+
+    /// @brief scheduling information.
+    using info = process_schedule;
+
+    /// @brief scheduling information map type.
+    using info_map = std::unordered_map<
+            ::takatori::plan::process const*,
+            info,
+            ::std::hash<::takatori::plan::process const*>,
+            ::std::equal_to<>>;
+
+    /// @brief the default value of max degree of parallelism.
+    static constexpr size_type default_max_parallelism = 1;
+
+    /// @brief the default number of rows which each worker processes.
+    static constexpr size_type default_rows_per_worker = 100'000;
+
+    /**
+     * @brief creates a new instance.
+     */
+    step_plan_scheduler() = default;
+
+    /**
+     * @brief creates a new instance.
+     * @param max_parallelism the max degree of parallelism, must be greater than `0`
+     * @param rows_per_worker the number of rows which each worker processes, must be greater than `0`
+     * @param index_estimator the index estimator for scan and find operators, or empty to not estimate them
+     * @attention the specified estimator must not be disposed while using this object
+     */
+    step_plan_scheduler(
+            size_type max_parallelism,
+            size_type rows_per_worker,
+            ::takatori::util::optional_ptr<index_estimator const> index_estimator = {}) noexcept;
+
+    /**
+     * @brief returns the max degree of parallelism.
+     * @return the max degree of parallelism
+     */
+    [[nodiscard]] size_type max_parallelism() const noexcept;
+
+    /**
+     * @brief returns the number of rows which each worker processes.
+     * @return the number of rows per worker
+     */
+    [[nodiscard]] size_type rows_per_worker() const noexcept;
+
+    /**
+     * @brief computes scheduling hints of the process steps in the given step plan.
+     * @param graph the target step plan, which must be built by step_plan_builder
+     * @return the scheduling hints of the individual process steps
+     */
+    [[nodiscard]] info_map operator()(::takatori::plan::graph_type const& graph) const;
+
+private:
+    size_type max_parallelism_ { default_max_parallelism };
+    size_type rows_per_worker_ { default_rows_per_worker };
+    ::takatori::util::optional_ptr<index_estimator const> index_estimator_ {};
+};
+
+} // namespace yugawara::analyzer
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstddef>
+#include <ostream>
+#include <unordered_map>
+
+#include <takatori/descriptor/variable.h>
+
+#include <takatori/util/optional_ptr.h>
+
+#include "variable_slot.h"
+
+namespace yugawara::analyzer {
+
+/**
+ * @brief provides the row record layout of variables which are alive in each block.
+ * @details All blocks in the same block graph share the same record layout, and each variable always occupies
+ *      the same slot while it is alive. On the other hand, individual slots can be shared by variables whose
+ *      lifetimes do not overlap.
+ * @see variable_layout_planner
+ */
+class variable_layout {
+public:
+    /// @brief the map type of variable slots.
+    using slot_map = std::unordered_map<
+            ::takatori::descriptor::variable,
+            variable_slot,
+            std::hash<::takatori::descriptor::variable>,
+            std::equal_to<>>;
+
+    /**
+     * @brief creates a new empty instance.
+     */
+    variable_layout() = default;
+
+    /**
+     * @brief creates a new instance.
+     * @param record_size the number of bytes of the whole record
+     * @param record_alignment the alignment of the whole record
+     */
+    variable_layout(std::size_t record_size, std::size_t record_alignment) noexcept;
+
+    /**
+     * @brief returns the number of bytes of the whole record.
+     * @return the record size
+     */
+    [[nodiscard]] std::size_t record_size() const noexcept;
+
+    /**
+     * @brief returns the alignment of the whole record.
+     * @return the record alignment
+     */
+    [[nodiscard]] std::size_t record_alignment() const noexcept;
+
+    /**
+     * @brief returns the slots of variables which are alive in this block.
+     * @details This includes the following kind of variables:
+     *
+     *      - binding::variable_info_kind::stream_variable
+     *      - binding::variable_info_kind::local_variable
+     * @return the variable slots
+     */
+    [[nodiscard]] slot_map& slots() noexcept;
+
+    /// @copydoc slots()
+    [[nodiscard]] slot_map const& slots() const noexcept;
+
+    /**
+     * @brief returns the slot of the given variable.
+     * @param variable the target variable
+     * @return the corresponded slot
+     * @return empty if the variable is not alive in this block
+     */
+    [[nodiscard]] ::takatori::util::optional_ptr<variable_slot const> find(
+            ::takatori::descriptor::variable const& variable) const;
+
+private:
+    std::size_t record_size_ {};
+    std::size_t record_alignment_ { 1 };
+    slot_map slots_ {};
+};
+
+/**
+ * @brief appends a string representation of the given value.
+ * @param out the target output stream
+ * @param value the target value
+ * @return the output stream
+ */
+std::ostream& operator<<(std::ostream& out, variable_layout const& value);
+
+} // namespace yugawara::analyzer
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <unordered_map>
+
+#include <takatori/graph/graph.h>
+
+#include <takatori/descriptor/variable.h>
+
+#include "variable_layout.h"
+#include "variable_liveness_analyzer.h"
+#include "block.h"
+
+namespace yugawara::analyzer {
+
+/**
+ * @brief plans row record layout of variables in each block.
+ * @details This assigns each defined variable to a slot in the row record, so that variables whose lifetimes
+ *      do not overlap share the same slot.
+ *      The lifetime of each variable is computed in units of blocks, from the defining block to the last block
+ *      which the variable is alive, in the depth-first order of the block graph.
+ *
+ *      Then, the slots are ordered by their alignment to minimize padding between them.
+ * @see variable_liveness_analyzer
+ * @see variable_layout
+ */
+class variable_layout_planner {
+public:
+    /**
+     * @brief the physical shape of variable values.
+     */
+    struct shape {
+        /// @brief the number of bytes.
+        std::size_t size;
+        /// @brief the alignment, must be a power of 2.
+        std::size_t alignment;
+    };
+
+    /// @brief provides the physical shape of each variable.
+    using shape_provider = std::function<shape(::takatori::descriptor::variable const&)>;
+
+    /// @brief layout information.
+    using info = variable_layout;
+
+    /// @brief layout information map type.
+    using info_map = std::unordered_map<
+            block const*,
+            info,
+            ::std::hash<block const*>,
+            ::std::equal_to<>>;
+
+    /**
+     * @brief creates a new instance.
+     * @param blocks the analysis target blocks, which must be built by block_builder
+     * @param liveness the liveness analyzer of the target blocks
+     * @param shapes provides the physical shape of each variable
+     * @attention the specified graph and analyzer must not modify nor be disposed while analyzing
+     */
+    variable_layout_planner(
+            ::takatori::graph::graph<block> const& blocks,
+            variable_liveness_analyzer& liveness,
+            shape_provider shapes);
+
+    /**
+     * @brief inspects the given block and returns its record layout.
+     * @param target the target block
+     * @return the record layout of the block
+     * @throws std::invalid_argument if the specified block is out of the scope of this planner
+     * @throws std::domain_error if some block contains semantic error
+     */
+    [[nodiscard]] info const& inspect(block const& target);
+
+private:
+    ::takatori::graph::graph<block> const& graph_;
+    variable_liveness_analyzer& liveness_;
+    shape_provider shapes_;
+    std::optional<info_map> blocks_ {};
+
+    void plan();
+};
+
+} // namespace yugawara::analyzer
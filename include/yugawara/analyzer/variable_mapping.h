@@ -2,7 +2,6 @@
 
 #include <functional>
 #include <memory>
-#include <unordered_map>
 
 #include <takatori/descriptor/variable.h>
 #include <takatori/type/data.h>
@@ -10,6 +9,8 @@
 
 #include "variable_resolution.h"
 
+#include "details/resolution_table.h"
+
 namespace yugawara::analyzer {
 
 /**
@@ -69,11 +70,9 @@ public:
     void clear() noexcept;
 
 private:
-    std::unordered_map<
+    details::resolution_table<
             ::takatori::descriptor::variable,
-            variable_resolution,
-            std::hash<::takatori::descriptor::variable>,
-            std::equal_to<>> mapping_;
+            variable_resolution> mapping_;
 };
 
 } // namespace yugawara::analyzer
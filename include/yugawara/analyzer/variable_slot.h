@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstddef>
+#include <ostream>
+
+namespace yugawara::analyzer {
+
+/**
+ * @brief a slot of variable in the row records.
+ * @see variable_layout
+ */
+class variable_slot {
+public:
+    /**
+     * @brief creates a new instance.
+     * @param offset the byte offset from head of the record
+     * @param size the number of bytes of the variable value
+     * @param alignment the alignment of the variable value
+     */
+    constexpr variable_slot(std::size_t offset, std::size_t size, std::size_t alignment) noexcept :
+        offset_ { offset },
+        size_ { size },
+        alignment_ { alignment }
+    {}
+
+    /**
+     * @brief returns the byte offset from head of the record.
+     * @return the byte offset
+     */
+    [[nodiscard]] constexpr std::size_t offset() const noexcept {
+        return offset_;
+    }
+
+    /**
+     * @brief returns the number of bytes of the variable value.
+     * @return the value size
+     */
+    [[nodiscard]] constexpr std::size_t size() const noexcept {
+        return size_;
+    }
+
+    /**
+     * @brief returns the alignment of the variable value.
+     * @return the value alignment
+     */
+    [[nodiscard]] constexpr std::size_t alignment() const noexcept {
+        return alignment_;
+    }
+
+private:
+    std::size_t offset_;
+    std::size_t size_;
+    std::size_t alignment_;
+};
+
+/**
+ * @brief returns whether or not the two slots are equivalent.
+ * @param a the first slot
+ * @param b the second slot
+ * @return true if a == b
+ * @return false otherwise
+ */
+constexpr bool operator==(variable_slot const& a, variable_slot const& b) noexcept {
+    return a.offset() == b.offset()
+        && a.size() == b.size()
+        && a.alignment() == b.alignment();
+}
+
+/**
+ * @brief returns whether or not the two slots are different.
+ * @param a the first slot
+ * @param b the second slot
+ * @return true if a != b
+ * @return false otherwise
+ */
+constexpr bool operator!=(variable_slot const& a, variable_slot const& b) noexcept {
+    return !(a == b);
+}
+
+/**
+ * @brief appends string representation of the given value.
+ * @param out the target output
+ * @param value the target value
+ * @return the output stream
+ */
+inline std::ostream& operator<<(std::ostream& out, variable_slot const& value) {
+    return out << "variable_slot("
+               << "offset=" << value.offset() << ", "
+               << "size=" << value.size() << ", "
+               << "alignment=" << value.alignment() << ")";
+}
+
+} // namespace yugawara::analyzer
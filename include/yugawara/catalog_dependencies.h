@@ -0,0 +1,150 @@
+#pragma once
+
+#include <vector>
+
+#include <takatori/util/sequence_view.h>
+
+#include <yugawara/storage/relation.h>
+#include <yugawara/storage/index.h>
+#include <yugawara/variable/declaration.h>
+#include <yugawara/function/declaration.h>
+#include <yugawara/aggregate/declaration.h>
+
+namespace yugawara {
+
+/**
+ * @brief the catalog elements which a compiled statement depends on.
+ * @details Clients can use this to decide which compiled statements must be discarded
+ *      after the individual catalog elements were modified.
+ *      This only holds the identity of each element, so that clients must not dereference the elements
+ *      after they were removed from the catalog.
+ * @see compiler_result::dependencies()
+ */
+class catalog_dependencies {
+public:
+    /**
+     * @brief creates a new empty instance.
+     */
+    catalog_dependencies() = default;
+
+    /**
+     * @brief adds a relation, like a table.
+     * @param element the target relation
+     * @return this
+     */
+    catalog_dependencies& add(storage::relation const& element);
+
+    /**
+     * @brief adds an index and its table.
+     * @param element the target index
+     * @return this
+     */
+    catalog_dependencies& add(storage::index const& element);
+
+    /**
+     * @brief adds an external variable.
+     * @param element the target variable declaration
+     * @return this
+     */
+    catalog_dependencies& add(variable::declaration const& element);
+
+    /**
+     * @brief adds a scalar function.
+     * @param element the target function declaration
+     * @return this
+     */
+    catalog_dependencies& add(function::declaration const& element);
+
+    /**
+     * @brief adds an aggregate function.
+     * @param element the target function declaration
+     * @return this
+     */
+    catalog_dependencies& add(aggregate::declaration const& element);
+
+    /**
+     * @brief returns whether or not this depends on the given relation.
+     * @param element the target relation
+     * @return true if this depends on the relation
+     * @return false otherwise
+     */
+    [[nodiscard]] bool depends_on(storage::relation const& element) const noexcept;
+
+    /**
+     * @brief returns whether or not this depends on the given index.
+     * @param element the target index
+     * @return true if this depends on the index
+     * @return false otherwise
+     */
+    [[nodiscard]] bool depends_on(storage::index const& element) const noexcept;
+
+    /**
+     * @brief returns whether or not this depends on the given external variable.
+     * @param element the target variable declaration
+     * @return true if this depends on the variable
+     * @return false otherwise
+     */
+    [[nodiscard]] bool depends_on(variable::declaration const& element) const noexcept;
+
+    /**
+     * @brief returns whether or not this depends on the given scalar function.
+     * @param element the target function declaration
+     * @return true if this depends on the function
+     * @return false otherwise
+     */
+    [[nodiscard]] bool depends_on(function::declaration const& element) const noexcept;
+
+    /**
+     * @brief returns whether or not this depends on the given aggregate function.
+     * @param element the target function declaration
+     * @return true if this depends on the function
+     * @return false otherwise
+     */
+    [[nodiscard]] bool depends_on(aggregate::declaration const& element) const noexcept;
+
+    /**
+     * @brief returns the dependent relations.
+     * @return the dependent relations
+     */
+    [[nodiscard]] ::takatori::util::sequence_view<storage::relation const* const> relations() const noexcept;
+
+    /**
+     * @brief returns the dependent indices.
+     * @return the dependent indices
+     */
+    [[nodiscard]] ::takatori::util::sequence_view<storage::index const* const> indices() const noexcept;
+
+    /**
+     * @brief returns the dependent external variables.
+     * @return the dependent variable declarations
+     */
+    [[nodiscard]] ::takatori::util::sequence_view<variable::declaration const* const> variables() const noexcept;
+
+    /**
+     * @brief returns the dependent scalar functions.
+     * @return the dependent function declarations
+     */
+    [[nodiscard]] ::takatori::util::sequence_view<function::declaration const* const> functions() const noexcept;
+
+    /**
+     * @brief returns the dependent aggregate functions.
+     * @return the dependent function declarations
+     */
+    [[nodiscard]] ::takatori::util::sequence_view<aggregate::declaration const* const> aggregates() const noexcept;
+
+    /**
+     * @brief returns whether or not this does not depend on any catalog elements.
+     * @return true if this is empty
+     * @return false otherwise
+     */
+    [[nodiscard]] bool empty() const noexcept;
+
+private:
+    std::vector<storage::relation const*> relations_ {};
+    std::vector<storage::index const*> indices_ {};
+    std::vector<variable::declaration const*> variables_ {};
+    std::vector<function::declaration const*> functions_ {};
+    std::vector<aggregate::declaration const*> aggregates_ {};
+};
+
+} // namespace yugawara
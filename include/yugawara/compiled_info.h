@@ -5,6 +5,7 @@
 
 #include <takatori/type/data.h>
 #include <takatori/descriptor/variable.h>
+#include <takatori/plan/exchange.h>
 #include <takatori/scalar/expression.h>
 #include <takatori/serializer/object_scanner.h>
 #include <takatori/util/optional_ptr.h>
@@ -12,6 +13,7 @@
 #include <yugawara/serializer/object_scanner.h>
 #include <yugawara/analyzer/expression_mapping.h>
 #include <yugawara/analyzer/variable_mapping.h>
+#include <yugawara/analyzer/exchange_column_layout.h>
 
 namespace yugawara {
 
@@ -34,6 +36,30 @@ public:
             std::shared_ptr<analyzer::expression_mapping const> expression_mapping,
             std::shared_ptr<analyzer::variable_mapping const> variable_mapping) noexcept;
 
+    /**
+     * @brief creates a new instance.
+     * @param expression_mapping information of individual expressions
+     * @param variable_mapping information of individual variables
+     * @param exchange_layouts column layout of individual exchange steps
+     */
+    compiled_info(
+            std::shared_ptr<analyzer::expression_mapping const> expression_mapping,
+            std::shared_ptr<analyzer::variable_mapping const> variable_mapping,
+            std::shared_ptr<analyzer::exchange_column_layout_map const> exchange_layouts) noexcept;
+
+    /**
+     * @brief creates a new instance.
+     * @param expression_mapping information of individual expressions
+     * @param variable_mapping information of individual variables
+     * @param exchange_layouts column layout of individual exchange steps
+     * @param partitioned_exchanges exchange steps whose input records have been already partitioned
+     */
+    compiled_info(
+            std::shared_ptr<analyzer::expression_mapping const> expression_mapping,
+            std::shared_ptr<analyzer::variable_mapping const> variable_mapping,
+            std::shared_ptr<analyzer::exchange_column_layout_map const> exchange_layouts,
+            std::shared_ptr<analyzer::partitioned_exchange_set const> partitioned_exchanges) noexcept;
+
     // FIXME: nullity and more
 
     /**
@@ -56,6 +82,28 @@ public:
      */
     [[nodiscard]] ::takatori::type::data const& type_of(::takatori::descriptor::variable const& variable) const;
 
+    /**
+     * @brief returns the column layout of the given exchange step.
+     * @param exchange the target exchange step
+     * @return the column layout of the exchange
+     * @return empty if the exchange columns were not arranged
+     * @see compiler_options::enable_exchange_column_arrangement()
+     */
+    [[nodiscard]] ::takatori::util::optional_ptr<analyzer::exchange_column_layout const> exchange_layout_of(
+            ::takatori::plan::exchange const& exchange) const;
+
+    /**
+     * @brief returns whether or not the input records of the given exchange step have been already partitioned
+     *      by its group keys.
+     * @details If it is true, the runtime can group the input records in each partition,
+     *      without transferring them to the other partitions.
+     * @param exchange the target exchange step
+     * @return true if the input records have been already partitioned
+     * @return false otherwise, or the partitioning was not analyzed
+     * @see compiler_options::enable_partitioning_analysis()
+     */
+    [[nodiscard]] bool is_partitioned(::takatori::plan::exchange const& exchange) const;
+
     /**
      * @brief returns the all expressions analyzed by the compiler.
      * @return the expression mappings
@@ -77,6 +125,8 @@ public:
 private:
     std::shared_ptr<analyzer::expression_mapping const> expression_mapping_ {};
     std::shared_ptr<analyzer::variable_mapping const> variable_mapping_ {};
+    std::shared_ptr<analyzer::exchange_column_layout_map const> exchange_layouts_ {};
+    std::shared_ptr<analyzer::partitioned_exchange_set const> partitioned_exchanges_ {};
 };
 
 } // namespace yugawara
@@ -56,7 +56,9 @@ public:
      * @param statement the target statement
      * @return the compilation result
      * @return an invalid result object if compilation was failed
-     * @attention This may take a copy of the arguments
+     * @note This only moves the top-level statement object into the result,
+     *      and takes over its elements (e.g. execution plans or tuples to write) without copying them.
+     *      Use the `std::unique_ptr` overload to hand over an existing statement object as is.
      */
     [[nodiscard]] result_type operator()(options_type const& options, ::takatori::statement::statement&& statement);
 
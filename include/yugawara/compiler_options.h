@@ -2,9 +2,12 @@
 
 #include <memory>
 
+#include <cstddef>
+
 #include <takatori/util/maybe_shared_ptr.h>
 
 #include <yugawara/analyzer/index_estimator.h>
+#include <yugawara/analyzer/exchange_column_layout.h>
 #include <yugawara/storage/prototype_processor.h>
 
 #include "runtime_feature.h"
@@ -41,6 +44,60 @@ public:
      */
     static constexpr bool default_enable_external_variable_inlining = false;
 
+    /**
+     * @brief the default value for enabling projection pushdown.
+     * @see enable_projection_pushdown()
+     */
+    static constexpr bool default_enable_projection_pushdown = true;
+
+    /**
+     * @brief the default value of the max data size of broadcast join inputs, in bytes.
+     * @see broadcast_build_size_limit()
+     */
+    static constexpr std::size_t default_broadcast_build_size_limit = 256UL * 1024UL * 1024UL;
+
+    /**
+     * @brief the default value of the estimated number of consumers of each broadcast exchange.
+     * @see broadcast_fan_out()
+     */
+    static constexpr std::size_t default_broadcast_fan_out = 4;
+
+    /**
+     * @brief the default value of the max number of rows in join inputs which are always acceptable for broadcast.
+     * @see broadcast_row_threshold()
+     */
+    static constexpr std::size_t default_broadcast_row_threshold = 1'000;
+
+    /**
+     * @brief the default value for enabling common sub-expression elimination.
+     * @see enable_common_subexpression_elimination()
+     */
+    static constexpr bool default_enable_common_subexpression_elimination = true;
+
+    /**
+     * @brief the default value for enabling invariant expression hoisting.
+     * @see enable_invariant_hoisting()
+     */
+    static constexpr bool default_enable_invariant_hoisting = false;
+
+    /**
+     * @brief the default value for enabling exchange column arrangement.
+     * @see enable_exchange_column_arrangement()
+     */
+    static constexpr bool default_enable_exchange_column_arrangement = true;
+
+    /**
+     * @brief the default value for enabling partitioning analysis of exchanges.
+     * @see enable_partitioning_analysis()
+     */
+    static constexpr bool default_enable_partitioning_analysis = true;
+
+    /**
+     * @brief the default value for enabling exchange fusion.
+     * @see enable_exchange_fusion()
+     */
+    static constexpr bool default_enable_exchange_fusion = true;
+
     /**
      * @brief creates a new instance with default options.
      * @param runtime_features the supported runtime features
@@ -133,14 +190,160 @@ public:
     /// @copydoc enable_external_variable_inlining()
     [[nodiscard]] bool enable_external_variable_inlining() const noexcept;
 
+    /**
+     * @brief returns whether to push down projections.
+     * @details If enabled, the optimizer computes each projected column in the join input which provides
+     *      all of its source columns, so that the runtime can exchange the computed column instead of the sources.
+     *      The columns are never computed in the null-supplying side of outer joins.
+     *      The columns which may raise errors are only computed in the left input of left outer joins,
+     *      so that they are never evaluated for the rows which the join discards.
+     * @return true if projection pushdown is enabled
+     * @return false otherwise
+     */
+    [[nodiscard]] bool& enable_projection_pushdown() noexcept;
+
+    /// @copydoc enable_projection_pushdown()
+    [[nodiscard]] bool enable_projection_pushdown() const noexcept;
+
+    /**
+     * @brief returns the max data size of the build side input of broadcast joins, in bytes.
+     * @details The optimizer never broadcasts join inputs whose estimated data size exceeds this limit,
+     *      and then such joins are built as co-group based joins instead.
+     *      This only affects the join inputs whose data size can be estimated: the number of rows is provided by
+     *      index_estimator(), and the row size is computed from exchange_column_shapes().
+     * @return the max data size of broadcast join inputs
+     */
+    [[nodiscard]] std::size_t& broadcast_build_size_limit() noexcept;
+
+    /// @copydoc broadcast_build_size_limit()
+    [[nodiscard]] std::size_t broadcast_build_size_limit() const noexcept;
+
+    /**
+     * @brief returns the estimated number of consumers of each broadcast exchange.
+     * @details Each consumer receives a copy of the broadcast input, so that the optimizer estimates
+     *      the shipping volume of broadcast joins as the build side data size multiplied by this value.
+     *      Please set the degree of parallelism of the target runtime.
+     * @return the estimated number of consumers of broadcast exchanges
+     */
+    [[nodiscard]] std::size_t& broadcast_fan_out() noexcept;
+
+    /// @copydoc broadcast_fan_out()
+    [[nodiscard]] std::size_t broadcast_fan_out() const noexcept;
+
+    /**
+     * @brief returns the max number of rows in join inputs which are always acceptable for broadcast.
+     * @details If both join inputs are estimated to have fewer rows than this, the optimizer does not compare
+     *      the shipping volume of broadcast and co-group exchanges, and prefers broadcast ones.
+     *      Even in that case, broadcast_build_size_limit() is still applied.
+     * @return the max number of rows in join inputs which are always acceptable for broadcast
+     */
+    [[nodiscard]] std::size_t& broadcast_row_threshold() noexcept;
+
+    /// @copydoc broadcast_row_threshold()
+    [[nodiscard]] std::size_t broadcast_row_threshold() const noexcept;
+
+    /**
+     * @brief returns whether to eliminate common sub-expressions.
+     * @details If enabled, the optimizer binds the repeated sub-expressions to stream variables,
+     *      so that the runtime computes them only once for each row.
+     * @return true if common sub-expression elimination is enabled
+     * @return false otherwise
+     */
+    [[nodiscard]] bool& enable_common_subexpression_elimination() noexcept;
+
+    /// @copydoc enable_common_subexpression_elimination()
+    [[nodiscard]] bool enable_common_subexpression_elimination() const noexcept;
+
+    /**
+     * @brief returns whether to hoist row-invariant sub-expressions.
+     * @details If enabled, the optimizer replaces sub-expressions which only consist of constants and
+     *      external variables with frame variables, so that the runtime can evaluate them once per statement.
+     *      Function calls are only hoisted if the function is declared as deterministic.
+     *      The declarations of such variables are available in compiler_result::invariants(),
+     *      and the runtime must evaluate each of them lazily, when the variable is first referred.
+     * @return true if invariant expression hoisting is enabled
+     * @return false otherwise
+     */
+    [[nodiscard]] bool& enable_invariant_hoisting() noexcept;
+
+    /// @copydoc enable_invariant_hoisting()
+    [[nodiscard]] bool enable_invariant_hoisting() const noexcept;
+
+    /**
+     * @brief returns whether to arrange exchange columns.
+     * @details If enabled, the compiler reorders the columns of exchange steps so that the key columns come first,
+     *      and then the fixed-width columns precede the variable-length ones.
+     *      The fixed-width columns are determined by exchange_column_shapes().
+     *      The resulting layout is available via compiled_info::exchange_layout_of().
+     * @return true if exchange column arrangement is enabled
+     * @return false otherwise
+     */
+    [[nodiscard]] bool& enable_exchange_column_arrangement() noexcept;
+
+    /// @copydoc enable_exchange_column_arrangement()
+    [[nodiscard]] bool enable_exchange_column_arrangement() const noexcept;
+
+    /**
+     * @brief returns the provider of physical shapes of exchange column values.
+     * @details The exchange column arrangement treats columns without the provided shape as variable-length.
+     *      The optimizer also uses it to estimate the data size of join inputs.
+     * @return the exchange column shape provider
+     * @return empty if it is absent, then all columns are treated as variable-length
+     * @see enable_exchange_column_arrangement()
+     */
+    [[nodiscard]] analyzer::exchange_column_shape_provider const& exchange_column_shapes() const noexcept;
+
+    /**
+     * @brief sets the provider of physical shapes of exchange column values.
+     * @param shapes the exchange column shape provider
+     * @return this
+     */
+    compiler_options& exchange_column_shapes(analyzer::exchange_column_shape_provider shapes);
+
+    /**
+     * @brief returns whether to analyze the partitioning of exchange inputs.
+     * @details If enabled, the compiler detects group exchanges whose input records have been already
+     *      partitioned by the same keys in the upstream exchanges.
+     *      The result is available via compiled_info::is_partitioned().
+     * @return true if partitioning analysis is enabled
+     * @return false otherwise
+     */
+    [[nodiscard]] bool& enable_partitioning_analysis() noexcept;
+
+    /// @copydoc enable_partitioning_analysis()
+    [[nodiscard]] bool enable_partitioning_analysis() const noexcept;
+
+    /**
+     * @brief returns whether to fuse redundant exchange steps.
+     * @details If enabled, the compiler removes pass-through `forward` exchanges,
+     *      moves limits into the preceding `group` exchanges, and merges adjacent `group` exchanges
+     *      with the same group keys.
+     * @return true if exchange fusion is enabled
+     * @return false otherwise
+     */
+    [[nodiscard]] bool& enable_exchange_fusion() noexcept;
+
+    /// @copydoc enable_exchange_fusion()
+    [[nodiscard]] bool enable_exchange_fusion() const noexcept;
+
 private:
     runtime_feature_set runtime_features_ { default_runtime_features };
     restricted_feature_set restricted_features_ { default_restricted_features };
     ::takatori::util::maybe_shared_ptr<::yugawara::storage::prototype_processor> storage_processor_ {};
     ::takatori::util::maybe_shared_ptr<analyzer::index_estimator const> index_estimator_ {};
+    analyzer::exchange_column_shape_provider exchange_column_shapes_ {};
 
     bool enable_disjunction_range_hinting_ { default_enable_disjunction_range_hinting };
     bool enable_external_variable_inlining_ { default_enable_external_variable_inlining };
+    bool enable_projection_pushdown_ { default_enable_projection_pushdown };
+    std::size_t broadcast_build_size_limit_ { default_broadcast_build_size_limit };
+    std::size_t broadcast_fan_out_ { default_broadcast_fan_out };
+    std::size_t broadcast_row_threshold_ { default_broadcast_row_threshold };
+    bool enable_common_subexpression_elimination_ { default_enable_common_subexpression_elimination };
+    bool enable_invariant_hoisting_ { default_enable_invariant_hoisting };
+    bool enable_exchange_column_arrangement_ { default_enable_exchange_column_arrangement };
+    bool enable_partitioning_analysis_ { default_enable_partitioning_analysis };
+    bool enable_exchange_fusion_ { default_enable_exchange_fusion };
 };
 
 } // namespace yugawara
@@ -15,7 +15,9 @@
 #include <yugawara/serializer/object_scanner.h>
 #include <yugawara/analyzer/expression_mapping.h>
 #include <yugawara/analyzer/variable_mapping.h>
+#include <yugawara/analyzer/invariant_declaration.h>
 
+#include "catalog_dependencies.h"
 #include "diagnostic.h"
 #include "compiler_code.h"
 #include "compiled_info.h"
@@ -51,6 +53,17 @@ public:
             std::unique_ptr<::takatori::statement::statement> statement,
             info_type info) noexcept;
 
+    /**
+     * @brief creates a new instance.
+     * @param statement the compiled statement
+     * @param info the compiled information
+     * @param invariants the row-invariant values which are referred from the compiled statement
+     */
+    compiler_result(
+            std::unique_ptr<::takatori::statement::statement> statement,
+            info_type info,
+            std::vector<analyzer::invariant_declaration> invariants) noexcept;
+
     /**
      * @brief creates a new instance which represents a compilation error.
      * @param diagnostics diagnostics of the error
@@ -106,6 +119,26 @@ public:
     /// @copydoc info()
     [[nodiscard]] info_type const& info() const noexcept;
 
+    /**
+     * @brief returns the row-invariant values which are referred from the compiled statement.
+     * @details The runtime must evaluate each value when the corresponding frame variable is first referred,
+     *      as described in analyzer::invariant_declaration.
+     *      This is always empty unless compiler_options::enable_invariant_hoisting() is enabled.
+     * @return the declarations of row-invariant values
+     */
+    [[nodiscard]] ::takatori::util::sequence_view<analyzer::invariant_declaration const> invariants() const noexcept;
+
+    /**
+     * @brief returns the catalog elements which the compiled statement depends on.
+     * @details Clients can keep the result with a cached statement, and then discard the statement
+     *      if any of the dependent elements are removed or replaced in the catalog.
+     *      This is computed on demand, so that clients should take a copy of the result instead of calling this repeatedly.
+     * @return the dependent catalog elements
+     * @return empty if this compilation was failed
+     * @see schema::declaration::epoch()
+     */
+    [[nodiscard]] catalog_dependencies dependencies() const;
+
     /**
      * @brief returns the diagnostic information.
      * @return the diagnostic information of the compiled result.
@@ -134,6 +167,7 @@ private:
     // successfully information
     std::unique_ptr<::takatori::statement::statement> statement_ {};
     info_type info_ {};
+    std::vector<analyzer::invariant_declaration> invariants_ {};
 
     // erroneous information
     std::vector<diagnostic_type> diagnostics_ {};
@@ -1,14 +1,23 @@
 #pragma once
 
+#include <algorithm>
 #include <functional>
+#include <list>
 #include <map>
 #include <memory>
+#include <optional>
 #include <string>
 #include <string_view>
+#include <unordered_map>
+#include <vector>
 
+#include <takatori/type/data.h>
 #include <takatori/util/maybe_shared_ptr.h>
 
+#include <yugawara/type/conversion.h>
 #include <yugawara/util/maybe_shared_lock.h>
+#include <yugawara/util/snapshot_guard.h>
+#include <yugawara/util/ternary.h>
 
 #include "provider.h"
 
@@ -16,7 +25,13 @@ namespace yugawara::function {
 
 /**
  * @brief an implementation of provider that can configurable its contents.
- * @tparam Mutex the mutex type, must satisfy *DefaultConstructible* and *BasicLockable*
+ * @details This indexes the declarations by their name and the number of parameters,
+ *      and also caches the results of find() unless the mutex type is util::snapshot_mutex.
+ *      The cached results are looked up under the shared lock if the mutex type is `std::shared_mutex`.
+ *      The cache is first-in first-out: when it is full, the entry cached first is evicted,
+ *      regardless of how often it was hit.
+ * @tparam Mutex the mutex type, must satisfy *DefaultConstructible* and *BasicLockable*,
+ *      or util::snapshot_mutex to read the contents without any locks
  * @note This class works as thread-safe only if the mutex works right
  */
 template<class Mutex>
@@ -31,17 +46,40 @@ public:
     /// @brief the readers lock type.
     using reader_lock_type = util::maybe_shared_lock<mutex_type>;
 
+    /// @brief the argument type list type.
+    using argument_types_type = std::vector<std::shared_ptr<::takatori::type::data const>>;
+
+    /// @brief the default max number of cached results of find().
+    static constexpr std::size_t default_cache_capacity = 1'024;
+
     /**
      * @brief creates a new object.
      * @param parent the parent provider (nullable)
+     * @param cache_capacity the max number of cached results of find(), or 0 to disable the cache
      */
     explicit basic_configurable_provider(
-            ::takatori::util::maybe_shared_ptr<provider const> parent = {}) noexcept :
-        parent_ { std::move(parent) }
+            ::takatori::util::maybe_shared_ptr<provider const> parent = {},
+            std::size_t cache_capacity = default_cache_capacity) noexcept :
+        parent_ { std::move(parent) },
+        cache_capacity_ { cache_capacity }
     {}
 
+    [[nodiscard]] epoch_type epoch() const noexcept override {
+        auto result = contents_.version();
+        if (parent_) {
+            result += parent_->epoch();
+        }
+        return result;
+    }
+
     using provider::each;
 
+    /**
+     * @brief provides all function declarations into the consumer.
+     * @details This provides the declarations in this provider ordered by their name,
+     *      and then ones in the parent provider.
+     * @param consumer the destination consumer
+     */
     void each(consumer_type const& consumer) const override {
         internal_each(consumer);
         if (parent_) {
@@ -49,6 +87,14 @@ public:
         }
     }
 
+    /**
+     * @brief provides function declarations into the consumer.
+     * @details This provides the declarations in this provider in order of their addition,
+     *      and then ones in the parent provider.
+     * @param name the target function name
+     * @param parameter_count the number of parameters in the target function
+     * @param consumer the destination consumer
+     */
     void each(
             std::string_view name,
             std::size_t parameter_count,
@@ -59,15 +105,69 @@ public:
         }
     }
 
+    /**
+     * @brief returns the most specific function declaration which is applicable to the given arguments.
+     * @details A declaration is applicable if each argument type is equivalent to the corresponding parameter type,
+     *      or it is convertible by the "parameter application conversion".
+     *      The declarations in this provider hide ones in the parent provider, that is,
+     *      this only looks up the parent provider if there are no applicable declarations in this provider.
+     *      If the parent is also this type of provider, its declarations hide ones in its ancestors in the same way.
+     * @param name the function name
+     * @param argument_types the argument types
+     * @return the most specific applicable declaration
+     * @return empty if there are no applicable declarations, or the most specific one is ambiguous
+     * @see type::is_parameter_application_convertible()
+     */
+    [[nodiscard]] std::shared_ptr<declaration const> find(
+            std::string_view name,
+            argument_types_type const& argument_types) const {
+        auto hash = hash_of(name, argument_types);
+        if constexpr (!lock_free_read) { // NOLINT
+            reader_lock_type lock { cache_mutex_ };
+            if (auto const* cached = find_cache(hash, name, argument_types);
+                    cached != nullptr && cached->version == contents_.version()) {
+                return cached->result;
+            }
+        }
+        {
+            auto contents = contents_.read();
+            auto version = contents_.version();
+            if (auto resolved = internal_find(*contents, name, argument_types)) {
+                if constexpr (!lock_free_read) { // NOLINT
+                    // caches only the results in this provider, because the parent may change independently
+                    writer_lock_type cache_lock { cache_mutex_ };
+                    put_cache(hash, version, name, argument_types, *resolved);
+                }
+                return std::move(*resolved);
+            }
+        }
+        if (parent_) {
+            if (auto const* parent = dynamic_cast<basic_configurable_provider const*>(parent_.get())) {
+                return parent->find(name, argument_types);
+            }
+            std::vector<std::shared_ptr<declaration const>> candidates {};
+            parent_->each(name, argument_types.size(), [&](std::shared_ptr<declaration const> const& found) {
+                candidates.emplace_back(found);
+            });
+            if (auto resolved = select(candidates, name, argument_types)) {
+                return std::move(*resolved);
+            }
+        }
+        return {};
+    }
+
     /**
      * @brief adds a function declaration.
      * @param element the the target declaration
      * @return the added element
      */
     std::shared_ptr<declaration> const& add(std::shared_ptr<declaration> element) {
-        key_type key { element->name() };
-        writer_lock_type lock { mutex_ };
-        auto iter = declarations_.emplace(std::move(key), std::move(element));
+        std::string name { element->name() };
+        auto parameter_count = element->parameter_types().size();
+        auto contents = contents_.write();
+        auto iter = contents->declarations.emplace(std::move(name), std::move(element));
+        rebuild_overloads(*contents, iter->first, parameter_count);
+        clear_cache();
         return iter->second;
     }
 
@@ -84,15 +184,17 @@ public:
      * @return false otherwise
      */
     bool remove(declaration const& element) {
-        auto&& name = element.name();
-        auto&& id = element.definition_id();
+        std::string name { element.name() };
+        auto parameter_count = element.parameter_types().size();
+        auto id = element.definition_id();
 
-        writer_lock_type lock { mutex_ };
-        auto first = declarations_.lower_bound(name);
-        auto last = declarations_.upper_bound(name);
+        auto contents = contents_.write();
+        auto [first, last] = contents->declarations.equal_range(name);
         for (auto iter = first; iter != last; ++iter) {
             if (auto&& found = iter->second; found && found->definition_id() == id) {
-                declarations_.erase(iter);
+                contents->declarations.erase(iter);
+                rebuild_overloads(*contents, name, parameter_count);
+                clear_cache();
                 return true;
             }
         }
@@ -100,21 +202,267 @@ public:
     }
 
 private:
-    using key_type = std::basic_string<char, std::char_traits<char>>;
+    using slot_type = std::size_t;
     using value_type = std::shared_ptr<declaration>;
-    using map_type = std::multimap<
-            key_type,
-            value_type,
-            std::less<>>;
+
+    static constexpr bool lock_free_read = util::is_snapshot_mutex_v<mutex_type>;
+
+    struct overload {
+        value_type element;
+        std::size_t specificity;
+    };
+
+    struct contents_type {
+        // the declarations, keyed by their name
+        std::multimap<std::string, value_type, std::less<>> declarations {};
+
+        // the declarations in individual slots, ordered by their specificity
+        std::unordered_map<slot_type, std::vector<overload>> overloads {};
+    };
+
+    using version_type = typename util::snapshot_guard<contents_type, mutex_type>::version_type;
+
+    struct cache_entry {
+        std::size_t hash;
+        // the contents version where the result was resolved, to ignore results from the old contents
+        version_type version;
+        std::string name;
+        argument_types_type argument_types;
+        std::shared_ptr<declaration const> result;
+    };
+
+    using cache_entry_list = std::list<cache_entry>;
 
     ::takatori::util::maybe_shared_ptr<provider const> parent_;
-    map_type declarations_;
-    mutable mutex_type mutex_ {};
+    util::snapshot_guard<contents_type, mutex_type> contents_ {};
+
+    std::size_t cache_capacity_;
+    // the cached entries from the oldest one
+    mutable cache_entry_list cache_entries_ {};
+    mutable std::unordered_multimap<std::size_t, typename cache_entry_list::iterator> cache_ {};
+    mutable mutex_type cache_mutex_ {};
+
+    [[nodiscard]] static slot_type slot_of(std::string_view name, std::size_t parameter_count) noexcept {
+        return std::hash<std::string_view> {}(name) * 31U + parameter_count;
+    }
+
+    [[nodiscard]] static std::size_t hash_of(
+            std::string_view name,
+            argument_types_type const& argument_types) noexcept {
+        std::size_t result = slot_of(name, argument_types.size());
+        for (auto&& type : argument_types) {
+            result *= 31U;
+            if (type) {
+                result += std::hash<::takatori::type::data> {}(*type);
+            }
+        }
+        return result;
+    }
+
+    [[nodiscard]] static bool matches(
+            declaration const& element,
+            std::string_view name,
+            std::size_t parameter_count) noexcept {
+        return element.parameter_types().size() == parameter_count && element.name() == name;
+    }
+
+    [[nodiscard]] static bool is_applicable(
+            ::takatori::type::data const& type,
+            ::takatori::type::data const& target) noexcept {
+        return type == target
+            || type::is_parameter_application_convertible(type, target) == util::ternary::yes;
+    }
+
+    [[nodiscard]] static bool is_applicable(
+            declaration const& element,
+            argument_types_type const& argument_types) noexcept {
+        auto&& parameters = element.parameter_types();
+        for (std::size_t i = 0, n = parameters.size(); i < n; ++i) {
+            if (!argument_types[i] || !is_applicable(*argument_types[i], parameters[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // returns whether or not the all parameters of `element` are also applicable to `other`
+    [[nodiscard]] static bool is_more_specific(declaration const& element, declaration const& other) noexcept {
+        auto&& parameters = element.parameter_types();
+        auto&& others = other.parameter_types();
+        for (std::size_t i = 0, n = parameters.size(); i < n; ++i) {
+            if (!is_applicable(parameters[i], others[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
 
+    [[nodiscard]] static declaration const& element_of(overload const& candidate) noexcept {
+        return *candidate.element;
+    }
+
+    [[nodiscard]] static declaration const& element_of(std::shared_ptr<declaration const> const& candidate) noexcept {
+        return *candidate;
+    }
+
+    [[nodiscard]] static std::shared_ptr<declaration const> share(overload const& candidate) {
+        return candidate.element;
+    }
+
+    [[nodiscard]] static std::shared_ptr<declaration const> share(std::shared_ptr<declaration const> const& candidate) {
+        return candidate;
+    }
+
+    template<class Candidates>
+    [[nodiscard]] static std::optional<std::shared_ptr<declaration const>> select(
+            Candidates const& candidates,
+            std::string_view name,
+            argument_types_type const& argument_types) {
+        auto applicable = [&](declaration const& element) {
+            return matches(element, name, argument_types.size()) && is_applicable(element, argument_types);
+        };
+        std::optional<std::shared_ptr<declaration const>> result {};
+        for (auto&& candidate : candidates) {
+            auto&& element = element_of(candidate);
+            if (!applicable(element)) {
+                continue;
+            }
+            if (!result || (is_more_specific(element, **result) && !is_more_specific(**result, element))) {
+                result = share(candidate);
+            }
+        }
+        if (!result) {
+            return {};
+        }
+        // the result must be more specific than any other applicable declarations
+        for (auto&& candidate : candidates) {
+            auto&& element = element_of(candidate);
+            if (std::addressof(element) == result->get() || !applicable(element)) {
+                continue;
+            }
+            if (!is_more_specific(**result, element) || is_more_specific(element, **result)) {
+                return std::shared_ptr<declaration const> {};
+            }
+        }
+        return result;
+    }
+
+    static void rebuild_overloads(contents_type& contents, std::string_view name, std::size_t parameter_count) {
+        auto slot = slot_of(name, parameter_count);
+        auto&& entries = contents.overloads[slot];
+
+        // keeps the declarations of the other names which share the same slot
+        entries.erase(
+                std::remove_if(entries.begin(), entries.end(), [&](overload const& entry) {
+                    return matches(*entry.element, name, parameter_count);
+                }),
+                entries.end());
+        auto [first, last] = contents.declarations.equal_range(name);
+        for (auto iter = first; iter != last; ++iter) {
+            if (auto&& element = iter->second; element && element->parameter_types().size() == parameter_count) {
+                entries.emplace_back(overload { element, 0 });
+            }
+        }
+        if (entries.empty()) {
+            contents.overloads.erase(slot);
+            return;
+        }
+        for (auto&& entry : entries) {
+            auto&& element = *entry.element;
+            entry.specificity = 0;
+            for (auto&& other : entries) {
+                if (entry.element != other.element
+                        && matches(*other.element, element.name(), element.parameter_types().size())
+                        && is_more_specific(element, *other.element)) {
+                    ++entry.specificity;
+                }
+            }
+        }
+        std::stable_sort(entries.begin(), entries.end(), [](overload const& a, overload const& b) {
+            return a.specificity > b.specificity;
+        });
+    }
+
+    [[nodiscard]] static std::optional<std::shared_ptr<declaration const>> internal_find(
+            contents_type const& contents,
+            std::string_view name,
+            argument_types_type const& argument_types) {
+        auto iter = contents.overloads.find(slot_of(name, argument_types.size()));
+        if (iter == contents.overloads.end()) {
+            return {};
+        }
+        return select(iter->second, name, argument_types);
+    }
+
+    [[nodiscard]] cache_entry* find_cache(
+            std::size_t hash,
+            std::string_view name,
+            argument_types_type const& argument_types) const {
+        auto [first, last] = cache_.equal_range(hash);
+        for (auto iter = first; iter != last; ++iter) {
+            if (auto&& entry = *iter->second;
+                    entry.name == name
+                    && std::equal(
+                            entry.argument_types.begin(), entry.argument_types.end(),
+                            argument_types.begin(), argument_types.end(),
+                            [](auto const& a, auto const& b) {
+                                return a == b || (a && b && *a == *b);
+                            })) {
+                return std::addressof(entry);
+            }
+        }
+        return nullptr;
+    }
+
+    void put_cache(
+            std::size_t hash,
+            version_type version,
+            std::string_view name,
+            argument_types_type const& argument_types,
+            std::shared_ptr<declaration const> result) const {
+        if (cache_capacity_ == 0) {
+            return;
+        }
+        if (auto* cached = find_cache(hash, name, argument_types)) {
+            // may be already cached by another thread, or resolved from the old contents
+            if (cached->version < version) {
+                cached->version = version;
+                cached->result = std::move(result);
+            }
+            return;
+        }
+        while (cache_entries_.size() >= cache_capacity_) {
+            evict_cache();
+        }
+        auto iter = cache_entries_.emplace(
+                cache_entries_.end(),
+                cache_entry { hash, version, std::string { name }, argument_types, std::move(result) });
+        cache_.emplace(hash, iter);
+    }
+
+    void evict_cache() const {
+        auto oldest = cache_entries_.begin();
+        auto [first, last] = cache_.equal_range(oldest->hash);
+        for (auto iter = first; iter != last; ++iter) {
+            if (iter->second == oldest) {
+                cache_.erase(iter);
+                break;
+            }
+        }
+        cache_entries_.erase(oldest);
+    }
+
+    void clear_cache() {
+        if constexpr (!lock_free_read) { // NOLINT
+            writer_lock_type lock { cache_mutex_ };
+            cache_.clear();
+            cache_entries_.clear();
+        }
+    }
 
     void internal_each(consumer_type const& consumer) const {
-        reader_lock_type lock { mutex_ };
-        for (auto&& [name, declaration] : declarations_) {
+        auto contents = contents_.read();
+        for (auto&& [name, declaration] : contents->declarations) {
             (void) name;
             consumer(declaration);
         }
@@ -124,14 +472,10 @@ private:
             std::string_view name,
             std::size_t parameter_count,
             consumer_type const& consumer) const {
-        reader_lock_type lock { mutex_ };
-        auto first = declarations_.lower_bound(name);
-        auto last = declarations_.upper_bound(name);
+        auto contents = contents_.read();
+        auto [first, last] = contents->declarations.equal_range(name);
         for (auto iter = first; iter != last; ++iter) {
-            if (auto&& found = iter->second;
-                    found
-                    && found->name() == name
-                    && found->parameter_types().size() == parameter_count) {
+            if (auto&& found = iter->second; found && matches(*found, name, parameter_count)) {
                 consumer(found);
             }
         }
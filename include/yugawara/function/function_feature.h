@@ -23,6 +23,13 @@ enum class function_feature {
      * @details the table-valued functions must have a special return type representing its table.
      */
     table_valued_function,
+
+    /**
+     * @brief represents functions which always return the same result for the same arguments.
+     * @details The optimizer may evaluate calls of such functions only once per statement execution,
+     *      if their arguments are row-invariant.
+     */
+    deterministic,
 };
 
 /**
@@ -31,7 +38,7 @@ enum class function_feature {
 using function_feature_set = ::takatori::util::enum_set<
         function_feature,
         function_feature::scalar_function,
-        function_feature::table_valued_function>;
+        function_feature::deterministic>;
 
 /**
  * @brief returns string representation of the value.
@@ -44,6 +51,7 @@ constexpr std::string_view to_string_view(function_feature value) noexcept {
     switch (value) {
         case kind::scalar_function: return "scalar_function"sv;
         case kind::table_valued_function: return "table_valued_function"sv;
+        case kind::deterministic: return "deterministic"sv;
     }
     std::abort();
 }
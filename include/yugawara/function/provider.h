@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <string_view>
@@ -16,6 +17,9 @@ public:
     /// @brief the declaration consumer type.
     using consumer_type = std::function<void(std::shared_ptr<declaration const> const&)>;
 
+    /// @brief the epoch type.
+    using epoch_type = std::uint64_t;
+
     /**
      * @brief creates a new instance.
      */
@@ -47,6 +51,17 @@ public:
             std::string_view name,
             std::size_t parameter_count,
             consumer_type const& consumer) const = 0;
+
+    /**
+     * @brief returns the current epoch of this provider.
+     * @details The epoch increases monotonically every time the contents of this provider or its parents are modified,
+     *      so that clients can detect the modification by comparing the epochs.
+     *      The default implementation always returns `0`, which means that the contents are never modified.
+     * @return the current epoch
+     */
+    [[nodiscard]] virtual epoch_type epoch() const noexcept {
+        return 0;
+    }
 };
 
 } // namespace yugawara::function
@@ -2,6 +2,8 @@
 
 #include <shared_mutex>
 
+#include <yugawara/util/snapshot_mutex.h>
+
 #include "basic_configurable_provider.h"
 
 namespace yugawara::schema {
@@ -12,4 +14,13 @@ namespace yugawara::schema {
  */
 using configurable_provider = basic_configurable_provider<std::shared_mutex>;
 
+/**
+ * @brief an implementation of schema declaration provider that can configure its contents,
+ *      and its readers never acquire locks.
+ * @details This is suitable if the contents are rarely modified, because individual modifications copy the contents.
+ * @note This class works as thread-safe.
+ * @see util::snapshot_mutex
+ */
+using snapshot_configurable_provider = basic_configurable_provider<util::snapshot_mutex>;
+
 } // namespace yugawara::schema
@@ -6,6 +6,7 @@
 #include <string>
 
 #include <cstddef>
+#include <cstdint>
 
 #include <takatori/util/optional_ptr.h>
 
@@ -33,6 +34,9 @@ public:
     /// @brief the schema description type.
     using description_type = std::string;
 
+    /// @brief the epoch type.
+    using epoch_type = std::uint64_t;
+
     /**
      * @brief creates a new object.
      * @param definition_id the schema definition ID
@@ -202,6 +206,15 @@ public:
      */
     declaration& type_provider(std::shared_ptr<type::provider> provider) noexcept;
 
+    /**
+     * @brief returns the current epoch of this schema.
+     * @details The epoch increases monotonically every time the contents of the providers in this schema are modified,
+     *      or the providers are replaced.
+     * @return the current epoch
+     * @see storage::provider::epoch()
+     */
+    [[nodiscard]] epoch_type epoch() const noexcept;
+
     /**
      * @brief returns the optional description of this element.
      * @return the description
@@ -239,9 +252,13 @@ private:
     std::shared_ptr<function::provider> function_provider_;
     std::shared_ptr<aggregate::provider> set_function_provider_;
     std::shared_ptr<type::provider> type_provider_;
+    epoch_type replaced_epoch_ { 0 };
     description_type description_;
     provider const* owner_ {};
 
+    template<class T>
+    void replace_provider(std::shared_ptr<T>& target, std::shared_ptr<T> provider) noexcept;
+
     friend provider;
 };
 
@@ -1,10 +1,13 @@
 #pragma once
 
+#include <algorithm>
 #include <functional>
 #include <map>
 #include <memory>
 #include <string>
 #include <string_view>
+#include <unordered_map>
+#include <vector>
 
 #include <takatori/util/clonable.h>
 #include <takatori/util/exception.h>
@@ -12,6 +15,7 @@
 #include <takatori/util/optional_ptr.h>
 
 #include <yugawara/util/maybe_shared_lock.h>
+#include <yugawara/util/snapshot_guard.h>
 
 #include "provider.h"
 
@@ -19,7 +23,8 @@ namespace yugawara::storage {
 
 /**
  * @brief an implementation of provider that can configurable its contents.
- * @tparam Mutex the mutex type, must satisfy *DefaultConstructible* and *BasicLockable*.
+ * @tparam Mutex the mutex type, must satisfy *DefaultConstructible* and *BasicLockable*,
+ *      or util::snapshot_mutex to read the contents without any locks
  * @note This class works as thread-safe only if the mutex works right
  */
 template<class Mutex>
@@ -43,8 +48,16 @@ public:
         parent_ { std::move(parent) }
     {}
 
+    [[nodiscard]] epoch_type epoch() const noexcept override {
+        auto result = contents_.version();
+        if (parent_) {
+            result += parent_->epoch();
+        }
+        return result;
+    }
+
     std::shared_ptr<relation const> find_relation(std::string_view id) const override {
-        return internal_find<&provider::find_relation>(relations_, id);
+        return internal_find<&provider::find_relation>(&contents_type::relations, id);
     }
 
     /**
@@ -53,7 +66,7 @@ public:
      * @note The hidden entries in parent provider will not occur in the consumer.
      */
     void each_relation(relation_consumer_type consumer) const override {
-        internal_each<&provider::each_relation>(relations_, consumer);
+        internal_each<&provider::each_relation>(&contents_type::relations, consumer);
     }
 
     /**
@@ -66,14 +79,14 @@ public:
      * @note This operation may **hide** elements defined in parent providers if `overwrite=true`
      */
     std::shared_ptr<relation const> add_relation(std::shared_ptr<relation const> element, bool overwrite = false) {
-        internal_add<&provider::find_relation>(relations_, element, overwrite);
+        internal_add<&provider::find_relation>(&contents_type::relations, element, overwrite);
         return element;
     }
 
     /// @copydoc add_relation(std::shared_ptr<relation>, bool)
     std::shared_ptr<relation> add_relation(relation&& element, bool overwrite = false) {
         auto shared = takatori::util::clone_shared(std::move(element));
-        internal_add<&provider::find_relation>(relations_, shared, overwrite);
+        internal_add<&provider::find_relation>(&contents_type::relations, shared, overwrite);
         return shared;
     }
 
@@ -87,13 +100,13 @@ public:
      * @note This operation may **hide** elements defined in parent providers if `overwrite=true`
      */
     std::shared_ptr<table> add_table(std::shared_ptr<table> element, bool overwrite = false) {
-        internal_add<&provider::find_table>(relations_, element, overwrite);
+        internal_add<&provider::find_table>(&contents_type::relations, element, overwrite);
         return element;
     }
 
     /// @copydoc add_table(std::shared_ptr<table>, bool)
     std::shared_ptr<table const> add_table(std::shared_ptr<table const> element, bool overwrite = false) {
-        internal_add<&provider::find_table>(relations_, element, overwrite);
+        internal_add<&provider::find_table>(&contents_type::relations, element, overwrite);
         return element;
     }
 
@@ -164,11 +177,11 @@ public:
      * @return false if there is no such a relation
      */
     bool remove_relation(std::string_view id) {
-        return internal_remove(relations_, id);
+        return internal_remove(&contents_type::relations, id);
     }
 
     [[nodiscard]] std::shared_ptr<class index const> find_index(std::string_view id) const override {
-        return internal_find<&provider::find_index>(indices_, id);
+        return internal_find<&provider::find_index>(&contents_type::indices, id);
     }
 
     /**
@@ -177,30 +190,40 @@ public:
      * @note The hidden entries in parent provider will not occur in the consumer.
      */
     void each_index(index_consumer_type const& consumer) const override {
-        internal_each<&provider::each_index>(indices_, consumer);
+        internal_each<&provider::each_index>(&contents_type::indices, consumer);
     }
 
-    std::shared_ptr<index const> find_primary_index(class table const& table) const override {
-        reader_lock_type lock { mutex_ };
-
-        // NOTE: we assume almost primary index name equals to its table name
-        if (auto it = indices_.find(table.simple_name()); it != indices_.end()) {
-            auto&& idx = *it->second;
-            if (std::addressof(idx.table()) == std::addressof(table)
-                    && idx.features().contains(index_feature::primary)) {
-                return it->second;
+    /**
+     * @brief provides all indices for the given table in this provider or its parents.
+     * @param table the target table
+     * @param consumer the destination consumer, which accepts pairs of element ID and element
+     * @note The hidden entries in parent provider will not occur in the consumer.
+     */
+    void each_table_index(class table const& table, index_consumer_type const& consumer) const override {
+        auto contents = contents_.read();
+        if (auto it = contents->table_indices.find(std::addressof(table)); it != contents->table_indices.end()) {
+            for (auto&& element : it->second.indices) {
+                consumer(element->simple_name(), element);
             }
         }
-        // If there is no such the index, then we find for all indices
-        for (auto&& entry : indices_) {
-            auto&& idx = *entry.second;
-            if (std::addressof(idx.table()) == std::addressof(table)
-                    && idx.features().contains(index_feature::primary)) {
-                return entry.second;
-            }
+        if (parent_) {
+            parent_->each_table_index(table, [&](std::string_view id, std::shared_ptr<index const> const& element) {
+                // filter elements defined in this provider
+                if (auto iter = contents->indices.find(id); iter == contents->indices.end()) {
+                    consumer(id, element);
+                }
+            });
+        }
+    }
+
+    std::shared_ptr<index const> find_primary_index(class table const& table) const override {
+        auto contents = contents_.read();
+        if (auto it = contents->table_indices.find(std::addressof(table));
+                it != contents->table_indices.end() && it->second.primary) {
+            return it->second.primary;
         }
         if (parent_) {
-            return find_primary_index(table);
+            return parent_->find_primary_index(table);
         }
         return {};
     }
@@ -214,13 +237,13 @@ public:
      * @note This operation may **hide** elements defined in parent providers if `overwrite=true`
      */
     std::shared_ptr<index> add_index(std::shared_ptr<index> element, bool overwrite = false) {
-        internal_add<&provider::find_index>(indices_, element, overwrite);
+        internal_add<&provider::find_index>(&contents_type::indices, element, overwrite);
         return element;
     }
 
     /// @copydoc add_index(std::shared_ptr<index>, bool)
     std::shared_ptr<index const> add_index(std::shared_ptr<index const> element, bool overwrite = false) {
-        internal_add<&provider::find_index>(indices_, element, overwrite);
+        internal_add<&provider::find_index>(&contents_type::indices, element, overwrite);
         return element;
     }
 
@@ -263,11 +286,11 @@ public:
      * @return false if there is no such an index
      */
     bool remove_index(std::string_view id) {
-        return internal_remove(indices_, id);
+        return internal_remove(&contents_type::indices, id);
     }
 
     [[nodiscard]] std::shared_ptr<class sequence const> find_sequence(std::string_view id) const override {
-        return internal_find<&provider::find_sequence>(sequences_, id);
+        return internal_find<&provider::find_sequence>(&contents_type::sequences, id);
     }
 
     /**
@@ -276,7 +299,7 @@ public:
      * @note The hidden entries in parent provider will not occur in the consumer.
      */
     void each_sequence(sequence_consumer_type const& consumer) const override {
-        internal_each<&provider::each_sequence>(sequences_, consumer);
+        internal_each<&provider::each_sequence>(&contents_type::sequences, consumer);
     }
 
     /**
@@ -288,13 +311,13 @@ public:
      * @note This operation may **hide** elements defined in parent providers if `overwrite=true`
      */
     std::shared_ptr<sequence> add_sequence(std::shared_ptr<sequence> element, bool overwrite = false) {
-        internal_add<&provider::find_sequence>(sequences_, element, overwrite);
+        internal_add<&provider::find_sequence>(&contents_type::sequences, element, overwrite);
         return element;
     }
 
     /// @copydoc add_sequence(std::shared_ptr<sequence>, bool)
     std::shared_ptr<sequence const> add_sequence(std::shared_ptr<sequence const> element, bool overwrite = false) {
-        internal_add<&provider::find_sequence>(sequences_, element, overwrite);
+        internal_add<&provider::find_sequence>(&contents_type::sequences, element, overwrite);
         return element;
     }
 
@@ -311,7 +334,7 @@ public:
      * @return false if there is no such a sequence
      */
     bool remove_sequence(std::string_view id) {
-        return internal_remove(sequences_, id);
+        return internal_remove(&contents_type::sequences, id);
     }
 
     /**
@@ -340,20 +363,35 @@ private:
             std::shared_ptr<sequence const>,
             std::less<>>;
 
+    struct table_index_entry {
+        // ordered by their IDs
+        std::vector<std::shared_ptr<index const>> indices {};
+        std::shared_ptr<index const> primary {};
+    };
+
+    using table_index_map_type = std::unordered_map<
+            class table const*,
+            table_index_entry>;
+
+    struct contents_type {
+        relation_map_type relations {};
+        index_map_type indices {};
+        table_index_map_type table_indices {};
+        sequence_map_type sequences {};
+    };
+
     ::takatori::util::maybe_shared_ptr<provider const> parent_;
-    relation_map_type relations_;
-    index_map_type indices_;
-    sequence_map_type sequences_;
-    mutable mutex_type mutex_ {};
+    util::snapshot_guard<contents_type, mutex_type> contents_ {};
 
     template<class Container>
     using element_type = typename Container::value_type::second_type::element_type;
 
     template<auto Find, class Container>
     [[nodiscard]] std::shared_ptr<element_type<Container> const> internal_find(
-            Container& container,
+            Container contents_type::* member,
             std::string_view id) const {
-        reader_lock_type lock { mutex_ };
+        auto contents = contents_.read();
+        auto&& container = (*contents).*member;
         // child first
         if (auto iter = container.find(id); iter != container.end()) {
             return iter->second;
@@ -367,9 +405,10 @@ private:
 
     template<auto Each, class Container>
     void internal_each(
-            Container& container,
+            Container contents_type::* member,
             consumer_type<element_type<Container>> const& consumer) const {
-        reader_lock_type lock { mutex_ };
+        auto contents = contents_.read();
+        auto&& container = (*contents).*member;
         for (auto&& entry : container) {
             consumer(entry.first, entry.second);
         }
@@ -388,9 +427,12 @@ private:
                                            || std::is_same_v<sequence, std::remove_const_t<E>>
                                             ;
 
+    template<class E>
+    static constexpr bool is_table_index_target_v = std::is_same_v<index, std::remove_const_t<E>>;
+
     template<auto Find, class Container>
     void internal_add(
-            Container& container,
+            Container contents_type::* member,
             std::shared_ptr<element_type<Container> const> element,
             bool overwrite) {
         using element_type = element_type<Container>;
@@ -399,13 +441,22 @@ private:
         auto id = element->simple_name();
         key_type key { id };
 
-        writer_lock_type lock { mutex_ };
+        auto contents = contents_.write();
+        auto&& container = (*contents).*member;
         if (overwrite) {
+            if constexpr (is_table_index_target_v<element_type>) { // NOLINT
+                if (auto iter = container.find(key); iter != container.end()) {
+                    remove_table_index(*contents, *iter->second);
+                }
+            }
             auto [iter, success] = container.insert_or_assign(std::move(key), std::move(element));
             (void) success;
             if constexpr (is_bless_target_v<element_type>) { // NOLINT
                 bless(*iter->second);
             }
+            if constexpr (is_table_index_target_v<element_type>) { // NOLINT
+                add_table_index(*contents, iter->second);
+            }
             return;
         }
         if (parent_ && ((*parent_).*Find)(id)) {
@@ -415,6 +466,9 @@ private:
             if constexpr (is_bless_target_v<element_type>) { // NOLINT
                 bless(*iter->second);
             }
+            if constexpr (is_table_index_target_v<element_type>) { // NOLINT
+                add_table_index(*contents, iter->second);
+            }
             return;
         }
         throw_exception(std::invalid_argument(std::string("already exists: ") += id));
@@ -422,20 +476,74 @@ private:
 
     template<class Container>
     bool internal_remove(
-            Container& container,
+            Container contents_type::* member,
             std::string_view id) {
-        writer_lock_type lock { mutex_ };
+        auto contents = contents_.write();
+        auto&& container = (*contents).*member;
         if (auto iter = container.find(id); iter != container.end()) {
             using element_type = element_type<Container>;
             if constexpr (is_bless_target_v<element_type>) { // NOLINT
                 unbless(*iter->second);
             }
+            if constexpr (is_table_index_target_v<element_type>) { // NOLINT
+                remove_table_index(*contents, *iter->second);
+            }
             // NOTE: container.erase(id) does not work
             container.erase(iter);
             return true;
         }
         return false;
     }
+
+    static void add_table_index(contents_type& contents, std::shared_ptr<index const> const& element) {
+        auto&& entry = contents.table_indices[std::addressof(element->table())];
+        auto&& indices = entry.indices;
+        auto position = std::upper_bound(
+                indices.begin(),
+                indices.end(),
+                element->simple_name(),
+                [](std::string_view id, std::shared_ptr<index const> const& e) {
+                    return id < e->simple_name();
+                });
+        indices.insert(position, element);
+        refresh_primary_index(entry);
+    }
+
+    static void remove_table_index(contents_type& contents, index const& element) {
+        auto it = contents.table_indices.find(std::addressof(element.table()));
+        if (it == contents.table_indices.end()) {
+            return;
+        }
+        auto&& indices = it->second.indices;
+        indices.erase(
+                std::remove_if(
+                        indices.begin(),
+                        indices.end(),
+                        [&](std::shared_ptr<index const> const& e) { return e.get() == std::addressof(element); }),
+                indices.end());
+        if (indices.empty()) {
+            contents.table_indices.erase(it);
+            return;
+        }
+        refresh_primary_index(it->second);
+    }
+
+    static void refresh_primary_index(table_index_entry& entry) {
+        entry.primary = {};
+        for (auto&& element : entry.indices) {
+            if (!element->features().contains(index_feature::primary)) {
+                continue;
+            }
+            // NOTE: we assume almost primary index name equals to its table name
+            if (element->simple_name() == element->table().simple_name()) {
+                entry.primary = element;
+                return;
+            }
+            if (!entry.primary) {
+                entry.primary = element;
+            }
+        }
+    }
 };
 
 } // namespace yugawara::storage
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <string_view>
@@ -40,6 +41,11 @@ public:
      */
     using sequence_consumer_type = consumer_type<sequence>;
 
+    /**
+     * @brief the epoch type.
+     */
+    using epoch_type = std::uint64_t;
+
     /**
      * @brief creates a new instance.
      */
@@ -120,6 +126,15 @@ public:
      */
     virtual void each_sequence(sequence_consumer_type const& consumer) const = 0;
 
+    /**
+     * @brief returns the current epoch of this provider.
+     * @details The epoch increases monotonically every time the contents of this provider or its parents are modified,
+     *      so that clients can detect the modification by comparing the epochs.
+     *      The default implementation always returns `0`, which means that the contents are never modified.
+     * @return the current epoch
+     */
+    [[nodiscard]] virtual epoch_type epoch() const noexcept;
+
 protected:
     /**
      * @brief set this as the given relation's owner.
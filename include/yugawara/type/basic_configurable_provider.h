@@ -12,6 +12,7 @@
 #include <takatori/util/string_builder.h>
 
 #include <yugawara/util/maybe_shared_lock.h>
+#include <yugawara/util/snapshot_guard.h>
 
 #include "provider.h"
 
@@ -19,7 +20,8 @@ namespace yugawara::type {
 
 /**
  * @brief an implementation of provider that can configurable its contents.
- * @tparam Mutex the mutex type, must satisfy *DefaultConstructible* and *BasicLockable*
+ * @tparam Mutex the mutex type, must satisfy *DefaultConstructible* and *BasicLockable*,
+ *      or util::snapshot_mutex to read the contents without any locks
  * @note This class works as thread-safe only if the mutex works right
  */
 template<class Mutex>
@@ -39,6 +41,10 @@ public:
      */
     explicit basic_configurable_provider() noexcept = default;
 
+    [[nodiscard]] epoch_type epoch() const noexcept override {
+        return declarations_.version();
+    }
+
     void each(consumer_type const& consumer) const override {
         internal_each(consumer);
     }
@@ -58,13 +64,13 @@ public:
         using ::takatori::util::throw_exception;
         using ::takatori::util::string_builder;
         key_type key { element->name() };
-        writer_lock_type lock { mutex_ };
+        auto declarations = declarations_.write();
         if (overwrite) {
-            auto [iter, success] = declarations_.insert_or_assign(std::move(key), std::move(element));
+            auto [iter, success] = declarations->insert_or_assign(std::move(key), std::move(element));
             (void) success;
             return iter->second;
         }
-        if (auto [iter, success] = declarations_.try_emplace(std::move(key), std::move(element)); success) {
+        if (auto [iter, success] = declarations->try_emplace(std::move(key), std::move(element)); success) {
             return iter->second;
         }
         // NOTE: if try_emplace was failed, `key` must be not changed
@@ -89,9 +95,9 @@ public:
     bool remove(declaration const& element) {
         auto&& name = element.name();
 
-        writer_lock_type lock { mutex_ };
-        if (auto iter = declarations_.find(name); iter != declarations_.end()) {
-            declarations_.erase(iter);
+        auto declarations = declarations_.write();
+        if (auto iter = declarations->find(name); iter != declarations->end()) {
+            declarations->erase(iter);
             return true;
         }
         return false;
@@ -105,25 +111,23 @@ private:
             value_type,
             std::less<>>;
 
-    map_type declarations_;
-    mutable mutex_type mutex_ {};
+    util::snapshot_guard<map_type, mutex_type> declarations_ {};
 
     template<class Consumer>
     void internal_each(Consumer const& consumer) const {
-        reader_lock_type lock { mutex_ };
-        for (auto&& [name, declaration] : declarations_) {
+        auto declarations = declarations_.read();
+        for (auto&& [name, declaration] : *declarations) {
             (void) name;
             consumer(declaration);
         }
     }
 
-    std::shared_ptr<declaration> const& internal_find(std::string_view name) const {
-        reader_lock_type lock { mutex_ };
-        if (auto iter = declarations_.find(name); iter != declarations_.end()) {
+    std::shared_ptr<declaration> internal_find(std::string_view name) const {
+        auto declarations = declarations_.read();
+        if (auto iter = declarations->find(name); iter != declarations->end()) {
             return iter->second;
         }
-        static std::shared_ptr<declaration> not_found {};
-        return not_found;
+        return {};
     }
 };
 
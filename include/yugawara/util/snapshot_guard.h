@@ -0,0 +1,206 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+
+#include "maybe_shared_lock.h"
+#include "snapshot_mutex.h"
+
+namespace yugawara::util {
+
+/**
+ * @brief holds the contents which are shared between readers and writers.
+ * @details If the mutex type is snapshot_mutex, readers refer to the latest immutable snapshot of the contents
+ *      without acquiring any locks, and writers only mark the contents as modified.
+ *      The first reader after the modifications acquires the mutex and publishes a copy of the contents,
+ *      so that a series of writes without reads in between copies the contents only once.
+ *      Otherwise, readers and writers acquire the mutex, and then directly access to the contents.
+ *
+ *      In both cases, references to the elements in the contents obtained by writers are valid
+ *      until they are removed by the subsequent writers.
+ * @tparam T the contents type, must be *DefaultConstructible* and *CopyConstructible*
+ * @tparam Mutex the mutex type, must satisfy *DefaultConstructible* and *BasicLockable*
+ * @note This class works as thread-safe only if the mutex works right
+ * @see snapshot_mutex
+ */
+template<class T, class Mutex>
+class snapshot_guard {
+public:
+    /// @brief the contents type.
+    using value_type = T;
+
+    /// @brief the mutex type.
+    using mutex_type = Mutex;
+
+    /// @brief the version number type.
+    using version_type = std::uint64_t;
+
+    /// @brief whether or not readers never acquire the mutex.
+    static constexpr bool lock_free_read = is_snapshot_mutex_v<mutex_type>;
+
+    /**
+     * @brief provides read access to the contents.
+     */
+    class reader {
+    public:
+        /**
+         * @brief creates a new instance.
+         * @param owner the owner
+         */
+        explicit reader(snapshot_guard const& owner) :
+            entity_ { acquire(owner) }
+        {}
+
+        /**
+         * @brief returns the contents.
+         * @return the contents
+         */
+        [[nodiscard]] value_type const& operator*() const noexcept {
+            if constexpr (lock_free_read) { // NOLINT
+                return *entity_;
+            } else { // NOLINT
+                return *entity_.second;
+            }
+        }
+
+        /// @copydoc operator*()
+        [[nodiscard]] value_type const* operator->() const noexcept {
+            return std::addressof(**this);
+        }
+
+    private:
+        using entity_type = std::conditional_t<
+                lock_free_read,
+                std::shared_ptr<value_type const>,
+                std::pair<maybe_shared_lock<mutex_type>, value_type const*>>;
+
+        entity_type entity_;
+
+        [[nodiscard]] static entity_type acquire(snapshot_guard const& owner) {
+            if constexpr (lock_free_read) { // NOLINT
+                if (owner.dirty_.load(std::memory_order_acquire)) {
+                    owner.publish();
+                }
+                return std::atomic_load(std::addressof(owner.snapshot_));
+            } else { // NOLINT
+                return entity_type {
+                        maybe_shared_lock<mutex_type> { owner.mutex_ },
+                        std::addressof(owner.contents_),
+                };
+            }
+        }
+    };
+
+    /**
+     * @brief provides write access to the contents.
+     * @details If the mutex type is snapshot_mutex, this marks the contents as modified on destruct,
+     *      and then the next reader publishes a snapshot of them.
+     *      If this was destructed by an exception, this does not mark the contents,
+     *      and the modification will be visible to readers after the next writer was finished.
+     */
+    class writer {
+    public:
+        /**
+         * @brief creates a new instance.
+         * @param owner the owner
+         */
+        explicit writer(snapshot_guard& owner) :
+            owner_ { owner },
+            lock_ { owner.mutex_ }
+        {}
+
+        ~writer() {
+            if constexpr (lock_free_read) { // NOLINT
+                if (std::uncaught_exceptions() == exceptions_) {
+                    owner_.dirty_.store(true, std::memory_order_release);
+                }
+            }
+            owner_.version_.fetch_add(1, std::memory_order_release);
+        }
+
+        writer(writer const&) = delete;
+        writer& operator=(writer const&) = delete;
+        writer(writer&&) = delete;
+        writer& operator=(writer&&) = delete;
+
+        /**
+         * @brief returns the contents.
+         * @return the contents
+         */
+        [[nodiscard]] value_type& operator*() const noexcept {
+            return owner_.contents_;
+        }
+
+        /// @copydoc operator*()
+        [[nodiscard]] value_type* operator->() const noexcept {
+            return std::addressof(owner_.contents_);
+        }
+
+    private:
+        snapshot_guard& owner_;
+        std::unique_lock<mutex_type> lock_;
+        int exceptions_ { std::uncaught_exceptions() };
+    };
+
+    /**
+     * @brief creates a new instance.
+     */
+    snapshot_guard() :
+        snapshot_ { lock_free_read ? std::make_shared<value_type const>() : nullptr }
+    {}
+
+    ~snapshot_guard() = default;
+
+    snapshot_guard(snapshot_guard const&) = delete;
+    snapshot_guard& operator=(snapshot_guard const&) = delete;
+    snapshot_guard(snapshot_guard&&) = delete;
+    snapshot_guard& operator=(snapshot_guard&&) = delete;
+
+    /**
+     * @brief returns read access to the contents.
+     * @return the read access, which keeps the lock or snapshot while it is alive
+     */
+    [[nodiscard]] reader read() const {
+        return reader { *this };
+    }
+
+    /**
+     * @brief returns write access to the contents.
+     * @return the write access, which keeps the lock while it is alive
+     */
+    [[nodiscard]] writer write() {
+        return writer { *this };
+    }
+
+    /**
+     * @brief returns the version number of the contents.
+     * @details The version number increases every time write access was finished,
+     *      even if the contents were not actually modified.
+     * @return the current version number
+     */
+    [[nodiscard]] version_type version() const noexcept {
+        return version_.load(std::memory_order_acquire);
+    }
+
+private:
+    value_type contents_ {};
+    mutable std::shared_ptr<value_type const> snapshot_;
+    mutable std::atomic<bool> dirty_ { false };
+    std::atomic<version_type> version_ { 0 };
+    mutable mutex_type mutex_ {};
+
+    void publish() const {
+        std::unique_lock<mutex_type> lock { mutex_ };
+        // the other reader may have published it
+        if (dirty_.load(std::memory_order_relaxed)) {
+            std::atomic_store(std::addressof(snapshot_), std::make_shared<value_type const>(contents_));
+            dirty_.store(false, std::memory_order_release);
+        }
+    }
+};
+
+} // namespace yugawara::util
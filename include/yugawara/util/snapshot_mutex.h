@@ -0,0 +1,52 @@
+#pragma once
+
+#include <mutex>
+#include <type_traits>
+
+namespace yugawara::util {
+
+/**
+ * @brief a mutex type which enables snapshot based read access.
+ * @details If configurable providers use this type as their mutex, their readers never acquire locks,
+ *      and instead they refer to an immutable snapshot of the contents.
+ *      Only writers, and the first reader after their modification to publish a new snapshot, acquire this mutex.
+ *      This is suitable if the contents are rarely modified but frequently read from many threads.
+ * @see snapshot_guard
+ */
+class snapshot_mutex {
+public:
+    /**
+     * @brief acquires this mutex.
+     */
+    void lock() {
+        entity_.lock();
+    }
+
+    /**
+     * @brief tries to acquire this mutex.
+     * @return true if successfully acquired
+     * @return false otherwise
+     */
+    [[nodiscard]] bool try_lock() {
+        return entity_.try_lock();
+    }
+
+    /**
+     * @brief releases this mutex.
+     */
+    void unlock() {
+        entity_.unlock();
+    }
+
+private:
+    std::mutex entity_ {};
+};
+
+/**
+ * @brief returns whether or not the given mutex type enables snapshot based read access.
+ * @tparam Mutex the mutex type
+ */
+template<class Mutex>
+constexpr inline bool is_snapshot_mutex_v = std::is_same_v<Mutex, snapshot_mutex>;
+
+} // namespace yugawara::util
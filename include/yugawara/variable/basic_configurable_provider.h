@@ -12,6 +12,7 @@
 #include <takatori/util/string_builder.h>
 
 #include <yugawara/util/maybe_shared_lock.h>
+#include <yugawara/util/snapshot_guard.h>
 
 #include "provider.h"
 
@@ -19,7 +20,8 @@ namespace yugawara::variable {
 
 /**
  * @brief an implementation of provider that can configurable its contents.
- * @tparam Mutex the mutex type, must satisfy *DefaultConstructible* and *BasicLockable*
+ * @tparam Mutex the mutex type, must satisfy *DefaultConstructible* and *BasicLockable*,
+ *      or util::snapshot_mutex to read the contents without any locks
  * @note This class works as thread-safe only if the mutex works right
  */
 template<class Mutex>
@@ -43,12 +45,24 @@ public:
         parent_ { std::move(parent) }
     {}
 
+    [[nodiscard]] epoch_type epoch() const noexcept override {
+        auto result = declarations_.version();
+        if (parent_) {
+            result += parent_->epoch();
+        }
+        return result;
+    }
+
     void each(consumer_type const& consumer) const override {
-        internal_each(consumer);
+        auto declarations = declarations_.read();
+        for (auto&& [name, declaration] : *declarations) {
+            (void) name;
+            consumer(declaration);
+        }
         if (parent_) {
             parent_->each([&](auto& d) {
                 if (!d) return;
-                if (auto iter = declarations_.find(d->name()); iter == declarations_.end()) {
+                if (auto iter = declarations->find(d->name()); iter == declarations->end()) {
                     consumer(d);
                 }
             });
@@ -56,7 +70,7 @@ public:
     }
 
     [[nodiscard]] std::shared_ptr<declaration const> find(std::string_view name) const override {
-        if (auto& found = internal_find(name)) {
+        if (auto found = internal_find(name)) {
             return found;
         }
         if (parent_) {
@@ -79,9 +93,9 @@ public:
         using ::takatori::util::throw_exception;
         using ::takatori::util::string_builder;
         key_type key { element->name() };
-        writer_lock_type lock { mutex_ };
+        auto declarations = declarations_.write();
         if (overwrite) {
-            auto [iter, success] = declarations_.insert_or_assign(std::move(key), std::move(element));
+            auto [iter, success] = declarations->insert_or_assign(std::move(key), std::move(element));
             (void) success;
             return iter->second;
         }
@@ -91,7 +105,7 @@ public:
                     << key
                     << string_builder::to_string));
         }
-        if (auto [iter, success] = declarations_.try_emplace(std::move(key), std::move(element)); success) {
+        if (auto [iter, success] = declarations->try_emplace(std::move(key), std::move(element)); success) {
             return iter->second;
         }
         // NOTE: if try_emplace was failed, `key` must be not changed
@@ -116,9 +130,9 @@ public:
     bool remove(declaration const& element) {
         auto&& name = element.name();
 
-        writer_lock_type lock { mutex_ };
-        if (auto iter = declarations_.find(name); iter != declarations_.end()) {
-            declarations_.erase(iter);
+        auto declarations = declarations_.write();
+        if (auto iter = declarations->find(name); iter != declarations->end()) {
+            declarations->erase(iter);
             return true;
         }
         return false;
@@ -133,24 +147,14 @@ private:
             std::less<>>;
 
     ::takatori::util::maybe_shared_ptr<provider const> parent_;
-    map_type declarations_;
-    mutable mutex_type mutex_ {};
+    util::snapshot_guard<map_type, mutex_type> declarations_ {};
 
-    void internal_each(consumer_type const& consumer) const {
-        reader_lock_type lock { mutex_ };
-        for (auto&& [name, declaration] : declarations_) {
-            (void) name;
-            consumer(declaration);
-        }
-    }
-
-    std::shared_ptr<declaration> const& internal_find(std::string_view name) const {
-        reader_lock_type lock { mutex_ };
-        if (auto iter = declarations_.find(name); iter != declarations_.end()) {
+    std::shared_ptr<declaration> internal_find(std::string_view name) const {
+        auto declarations = declarations_.read();
+        if (auto iter = declarations->find(name); iter != declarations->end()) {
             return iter->second;
         }
-        static std::shared_ptr<declaration> not_found {};
-        return not_found;
+        return {};
     }
 };
 
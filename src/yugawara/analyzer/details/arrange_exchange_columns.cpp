@@ -0,0 +1,191 @@
+#include "arrange_exchange_columns.h"
+
+#include <algorithm>
+#include <optional>
+#include <vector>
+
+#include <takatori/type/type_kind.h>
+
+#include <takatori/plan/forward.h>
+#include <takatori/plan/group.h>
+#include <takatori/plan/aggregate.h>
+#include <takatori/plan/broadcast.h>
+
+#include <takatori/util/downcast.h>
+
+namespace yugawara::analyzer::details {
+
+namespace descriptor = ::takatori::descriptor;
+namespace plan = ::takatori::plan;
+namespace type = ::takatori::type;
+
+using ::takatori::util::unsafe_downcast;
+
+namespace {
+
+/**
+ * @brief returns the shape of fixed-width values of the given type.
+ * @param shapes provides the physical shape of values
+ * @param type the value type
+ * @return the value shape
+ * @return empty if the type is variable-length, or its shape is not provided
+ */
+[[nodiscard]] std::optional<exchange_column_shape> fixed_shape(
+        exchange_column_shape_provider const& shapes,
+        type::data const& type) {
+    // NOTE: the unknown type only appears as the type of NULL, which is not a fixed-width value
+    if (!shapes || type.kind() == type::type_kind::unknown) {
+        return {};
+    }
+    return shapes(type);
+}
+
+class engine {
+public:
+    explicit engine(
+            compiled_info const& info,
+            exchange_column_shape_provider const& shapes,
+            exchange_column_layout_map& results) noexcept :
+        info_ { info },
+        shapes_ { shapes },
+        results_ { results }
+    {}
+
+    void operator()(plan::forward& step) {
+        arrange(step, step.columns());
+    }
+
+    void operator()(plan::group& step) {
+        for (auto&& key : step.group_keys()) {
+            add_key(key);
+        }
+        for (auto&& key : step.sort_keys()) {
+            add_key(key.variable());
+        }
+        arrange(step, step.columns());
+    }
+
+    void operator()(plan::aggregate& step) {
+        for (auto&& key : step.group_keys()) {
+            add_key(key);
+        }
+        // NOTE: the runtime only compares the source records by their group keys
+        (void) arrange_columns(step.source_columns());
+        arrange(step, step.destination_columns());
+    }
+
+    void operator()(plan::broadcast& step) {
+        arrange(step, step.columns());
+    }
+
+private:
+    struct entry {
+        descriptor::variable variable;
+        std::size_t rank;
+        std::optional<exchange_column_shape> shape;
+    };
+
+    compiled_info const& info_;
+    exchange_column_shape_provider const& shapes_;
+    exchange_column_layout_map& results_;
+    std::vector<descriptor::variable const*> keys_ {};
+    std::vector<entry> entries_ {};
+
+    void add_key(descriptor::variable const& variable) {
+        auto found = std::find_if(keys_.begin(), keys_.end(), [&](descriptor::variable const* key) {
+            return *key == variable;
+        });
+        if (found == keys_.end()) {
+            keys_.emplace_back(std::addressof(variable));
+        }
+    }
+
+    template<class Columns>
+    void arrange(plan::exchange const& step, Columns& columns) {
+        results_.insert_or_assign(std::addressof(step), arrange_columns(columns));
+        keys_.clear();
+    }
+
+    template<class Columns>
+    exchange_column_layout arrange_columns(Columns& columns) {
+        entries_.reserve(columns.size());
+        for (auto&& column : columns) {
+            auto shape = fixed_shape(shapes_, info_.type_of(column));
+            entries_.emplace_back(entry { column, rank_of(column), shape });
+        }
+        std::stable_sort(entries_.begin(), entries_.end(), [&](entry const& a, entry const& b) {
+            if (a.rank != b.rank) {
+                return a.rank < b.rank;
+            }
+            if (a.rank != non_key) {
+                return false;
+            }
+            // fixed-width columns first, and then from the largest alignment
+            if (a.shape.has_value() != b.shape.has_value()) {
+                return a.shape.has_value();
+            }
+            return a.shape && a.shape->alignment > b.shape->alignment;
+        });
+
+        std::size_t key_count = 0;
+        std::size_t key_prefix_size = 0;
+        bool prefix = true;
+        auto iter = columns.begin();
+        for (auto&& e : entries_) {
+            if (e.rank != non_key) {
+                ++key_count;
+                if (prefix && e.shape) {
+                    key_prefix_size += e.shape->size;
+                } else {
+                    prefix = false;
+                }
+            }
+            *iter = std::move(e.variable);
+            ++iter;
+        }
+        entries_.clear();
+        return exchange_column_layout { key_count, key_prefix_size };
+    }
+
+    static constexpr std::size_t non_key = static_cast<std::size_t>(-1);
+
+    [[nodiscard]] std::size_t rank_of(descriptor::variable const& column) const {
+        for (std::size_t i = 0, n = keys_.size(); i < n; ++i) {
+            if (*keys_[i] == column) {
+                return i;
+            }
+        }
+        return non_key;
+    }
+};
+
+} // namespace
+
+exchange_column_layout_map arrange_exchange_columns(
+        plan::graph_type& graph,
+        compiled_info const& info,
+        exchange_column_shape_provider const& shapes) {
+    exchange_column_layout_map results {};
+    engine e { info, shapes, results };
+    for (auto&& step : graph) {
+        switch (step.kind()) {
+            case plan::forward::tag:
+                e(unsafe_downcast<plan::forward>(step));
+                break;
+            case plan::group::tag:
+                e(unsafe_downcast<plan::group>(step));
+                break;
+            case plan::aggregate::tag:
+                e(unsafe_downcast<plan::aggregate>(step));
+                break;
+            case plan::broadcast::tag:
+                e(unsafe_downcast<plan::broadcast>(step));
+                break;
+            default:
+                break;
+        }
+    }
+    return results;
+}
+
+} // namespace yugawara::analyzer::details
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <takatori/plan/graph.h>
+
+#include <yugawara/compiled_info.h>
+#include <yugawara/analyzer/exchange_column_layout.h>
+
+namespace yugawara::analyzer::details {
+
+/**
+ * @brief rearranges columns of exchange steps for efficient serialization and comparison.
+ * @details This rearranges the columns of `group`, `aggregate`, `broadcast` and `forward` exchanges
+ *      as described in exchange_column_layout.
+ *      This never changes the meaning of the plan, because the individual columns are always referred by
+ *      their descriptors instead of their position.
+ *      Columns whose shape is not provided by the given provider are treated as variable-length.
+ * @param graph the target step plan, which types have been resolved
+ * @param info the type information of the step plan
+ * @param shapes provides the physical shape of column values, may be empty
+ * @return the layout of the individual exchanges
+ */
+exchange_column_layout_map arrange_exchange_columns(
+        ::takatori::plan::graph_type& graph,
+        compiled_info const& info,
+        exchange_column_shape_provider const& shapes);
+
+} // namespace yugawara::analyzer::details
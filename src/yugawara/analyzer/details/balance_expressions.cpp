@@ -0,0 +1,320 @@
+#include "balance_expressions.h"
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <takatori/scalar/binary.h>
+#include <takatori/scalar/cast.h>
+#include <takatori/scalar/coalesce.h>
+#include <takatori/scalar/compare.h>
+#include <takatori/scalar/conditional.h>
+#include <takatori/scalar/function_call.h>
+#include <takatori/scalar/let.h>
+#include <takatori/scalar/match.h>
+#include <takatori/scalar/unary.h>
+
+#include <takatori/relation/apply.h>
+#include <takatori/relation/filter.h>
+#include <takatori/relation/find.h>
+#include <takatori/relation/join_find.h>
+#include <takatori/relation/join_scan.h>
+#include <takatori/relation/project.h>
+#include <takatori/relation/scan.h>
+#include <takatori/relation/values.h>
+#include <takatori/relation/intermediate/join.h>
+#include <takatori/relation/step/join.h>
+
+#include <takatori/plan/process.h>
+
+#include <takatori/statement/execute.h>
+#include <takatori/statement/write.h>
+
+#include <takatori/util/downcast.h>
+
+namespace yugawara::analyzer::details {
+
+namespace scalar = ::takatori::scalar;
+namespace relation = ::takatori::relation;
+namespace plan = ::takatori::plan;
+namespace statement = ::takatori::statement;
+
+using ::takatori::util::unsafe_downcast;
+
+namespace {
+
+[[nodiscard]] bool is_associative(scalar::binary_operator kind) noexcept {
+    using kind_type = scalar::binary_operator;
+    return kind == kind_type::conditional_and
+        || kind == kind_type::conditional_or
+        || kind == kind_type::concat;
+}
+
+[[nodiscard]] bool is_chain(scalar::expression const& expr, scalar::binary_operator kind) noexcept {
+    return expr.kind() == scalar::binary::tag
+        && unsafe_downcast<scalar::binary>(expr).operator_kind() == kind;
+}
+
+class engine {
+public:
+    explicit engine(std::size_t threshold) noexcept :
+        threshold_ { threshold }
+    {}
+
+    void process(scalar::expression& root) {
+        work_.emplace_back(std::addressof(root));
+        while (!work_.empty()) {
+            auto* current = work_.back();
+            work_.pop_back();
+            switch (current->kind()) {
+                case scalar::binary::tag:
+                    process(unsafe_downcast<scalar::binary>(*current));
+                    break;
+                case scalar::unary::tag:
+                    work_.emplace_back(std::addressof(unsafe_downcast<scalar::unary>(*current).operand()));
+                    break;
+                case scalar::cast::tag:
+                    work_.emplace_back(std::addressof(unsafe_downcast<scalar::cast>(*current).operand()));
+                    break;
+                case scalar::compare::tag: {
+                    auto&& compare = unsafe_downcast<scalar::compare>(*current);
+                    work_.emplace_back(std::addressof(compare.left()));
+                    work_.emplace_back(std::addressof(compare.right()));
+                    break;
+                }
+                case scalar::match::tag: {
+                    auto&& match = unsafe_downcast<scalar::match>(*current);
+                    work_.emplace_back(std::addressof(match.input()));
+                    work_.emplace_back(std::addressof(match.pattern()));
+                    work_.emplace_back(std::addressof(match.escape()));
+                    break;
+                }
+                case scalar::conditional::tag: {
+                    auto&& conditional = unsafe_downcast<scalar::conditional>(*current);
+                    for (auto&& alternative : conditional.alternatives()) {
+                        work_.emplace_back(std::addressof(alternative.condition()));
+                        work_.emplace_back(std::addressof(alternative.body()));
+                    }
+                    if (auto otherwise = conditional.default_expression()) {
+                        work_.emplace_back(std::addressof(*otherwise));
+                    }
+                    break;
+                }
+                case scalar::coalesce::tag:
+                    for (auto&& alternative : unsafe_downcast<scalar::coalesce>(*current).alternatives()) {
+                        work_.emplace_back(std::addressof(alternative));
+                    }
+                    break;
+                case scalar::let::tag: {
+                    auto&& let = unsafe_downcast<scalar::let>(*current);
+                    for (auto&& declarator : let.variables()) {
+                        work_.emplace_back(std::addressof(declarator.value()));
+                    }
+                    work_.emplace_back(std::addressof(let.body()));
+                    break;
+                }
+                case scalar::function_call::tag:
+                    for (auto&& argument : unsafe_downcast<scalar::function_call>(*current).arguments()) {
+                        work_.emplace_back(std::addressof(argument));
+                    }
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+
+    template<class Keys>
+    void process_keys(Keys& keys) {
+        for (auto&& key : keys) {
+            process(key.value());
+        }
+    }
+
+    template<class List>
+    void process_list(List& list) {
+        for (auto&& element : list) {
+            process(element);
+        }
+    }
+
+    template<class Condition>
+    void process_condition(Condition&& condition) {
+        if (condition) {
+            process(*condition);
+        }
+    }
+
+private:
+    std::size_t threshold_;
+    std::vector<scalar::expression*> work_ {};
+    std::vector<std::pair<scalar::expression*, std::size_t>> chain_ {};
+    std::vector<std::unique_ptr<scalar::expression>> owned_ {};
+    std::vector<std::unique_ptr<scalar::expression>> terms_ {};
+
+    void process(scalar::binary& expr) {
+        auto kind = expr.operator_kind();
+        if (!is_associative(kind)) {
+            work_.emplace_back(std::addressof(expr.left()));
+            work_.emplace_back(std::addressof(expr.right()));
+            return;
+        }
+
+        // enqueue the individual terms of the chain, they are not moved even if the chain is rebuilt
+        std::size_t count = 0;
+        std::size_t depth = 0;
+        chain_.emplace_back(std::addressof(expr), 0);
+        while (!chain_.empty()) {
+            auto [current, level] = chain_.back();
+            chain_.pop_back();
+            if (is_chain(*current, kind)) {
+                auto&& binary = unsafe_downcast<scalar::binary>(*current);
+                chain_.emplace_back(std::addressof(binary.right()), level + 1);
+                chain_.emplace_back(std::addressof(binary.left()), level + 1);
+                continue;
+            }
+            work_.emplace_back(current);
+            ++count;
+            depth = std::max(depth, level);
+        }
+        // keeps the chain which is already balanced, like one rebuilt by this
+        if (count >= threshold_ && depth > balanced_depth(count)) {
+            rebuild(expr);
+        }
+    }
+
+    [[nodiscard]] static std::size_t balanced_depth(std::size_t count) noexcept {
+        std::size_t result = 0;
+        while ((static_cast<std::size_t>(1) << result) < count) {
+            ++result;
+        }
+        return result;
+    }
+
+    void rebuild(scalar::binary& expr) {
+        auto kind = expr.operator_kind();
+
+        // releases the terms from the chain, keeping their order
+        owned_.emplace_back(expr.release_right());
+        owned_.emplace_back(expr.release_left());
+        while (!owned_.empty()) {
+            auto current = std::move(owned_.back());
+            owned_.pop_back();
+            if (is_chain(*current, kind)) {
+                auto&& binary = unsafe_downcast<scalar::binary>(*current);
+                owned_.emplace_back(binary.release_right());
+                owned_.emplace_back(binary.release_left());
+                continue;
+            }
+            terms_.emplace_back(std::move(current));
+        }
+
+        // reuse the root node, because its owner is not available here
+        auto middle = terms_.size() / 2;
+        expr.left(build(kind, 0, middle));
+        expr.right(build(kind, middle, terms_.size()));
+        terms_.clear();
+    }
+
+    [[nodiscard]] std::unique_ptr<scalar::expression> build(
+            scalar::binary_operator kind,
+            std::size_t begin,
+            std::size_t end) {
+        if (end - begin == 1) {
+            return std::move(terms_[begin]);
+        }
+        auto middle = begin + (end - begin) / 2;
+        auto left = build(kind, begin, middle);
+        auto right = build(kind, middle, end);
+        return std::make_unique<scalar::binary>(kind, std::move(left), std::move(right));
+    }
+};
+
+} // namespace
+
+void balance_expressions(relation::graph_type& graph, std::size_t threshold) {
+    engine e { threshold };
+    for (auto&& expr : graph) {
+        switch (expr.kind()) {
+            case relation::find::tag:
+                e.process_keys(unsafe_downcast<relation::find>(expr).keys());
+                break;
+            case relation::scan::tag: {
+                auto&& scan = unsafe_downcast<relation::scan>(expr);
+                e.process_keys(scan.lower().keys());
+                e.process_keys(scan.upper().keys());
+                break;
+            }
+            case relation::values::tag:
+                for (auto&& row : unsafe_downcast<relation::values>(expr).rows()) {
+                    e.process_list(row.elements());
+                }
+                break;
+            case relation::filter::tag:
+                e.process(unsafe_downcast<relation::filter>(expr).condition());
+                break;
+            case relation::project::tag:
+                for (auto&& column : unsafe_downcast<relation::project>(expr).columns()) {
+                    e.process(column.value());
+                }
+                break;
+            case relation::apply::tag:
+                e.process_list(unsafe_downcast<relation::apply>(expr).arguments());
+                break;
+            case relation::join_find::tag: {
+                auto&& join = unsafe_downcast<relation::join_find>(expr);
+                e.process_keys(join.keys());
+                e.process_condition(join.condition());
+                break;
+            }
+            case relation::join_scan::tag: {
+                auto&& join = unsafe_downcast<relation::join_scan>(expr);
+                e.process_keys(join.lower().keys());
+                e.process_keys(join.upper().keys());
+                e.process_condition(join.condition());
+                break;
+            }
+            case relation::intermediate::join::tag: {
+                auto&& join = unsafe_downcast<relation::intermediate::join>(expr);
+                e.process_keys(join.lower().keys());
+                e.process_keys(join.upper().keys());
+                e.process_condition(join.condition());
+                break;
+            }
+            case relation::step::join::tag:
+                e.process_condition(unsafe_downcast<relation::step::join>(expr).condition());
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+void balance_expressions(statement::statement& statement, std::size_t threshold) {
+    switch (statement.kind()) {
+        case statement::execute::tag:
+            for (auto&& step : unsafe_downcast<statement::execute>(statement).execution_plan()) {
+                if (step.kind() == plan::process::tag) {
+                    balance_expressions(unsafe_downcast<plan::process>(step).operators(), threshold);
+                }
+            }
+            break;
+        case statement::write::tag: {
+            engine e { threshold };
+            for (auto&& tuple : unsafe_downcast<statement::write>(statement).tuples()) {
+                e.process_list(tuple.elements());
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+void balance_expressions(scalar::expression& expression, std::size_t threshold) {
+    engine e { threshold };
+    e.process(expression);
+}
+
+} // namespace yugawara::analyzer::details
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+
+#include <takatori/relation/graph.h>
+
+#include <takatori/scalar/expression.h>
+
+#include <takatori/statement/statement.h>
+
+namespace yugawara::analyzer::details {
+
+/**
+ * @brief the default minimum number of terms in associative operator chains to rebalance.
+ */
+constexpr std::size_t balance_expressions_default_threshold = 8;
+
+/**
+ * @brief rebuilds long chains of associative operators as balanced trees.
+ * @details This rewrites chains of the same associative binary operator - conditional AND, conditional OR,
+ *      and concatenation - into balanced trees, without changing the order of their terms.
+ *      Chains shorter than the threshold, or already balanced ones, are left as is.
+ *
+ *      This walks all scalar expressions in the relational operators with explicit stacks, so that it accepts
+ *      deep left-deep chains generated from machine-made SQL. The compiler applies this before the first
+ *      expression analysis, so that the recursive passes only see such chains as trees of logarithmic depth.
+ *      Note that deep nesting of the other operators (e.g. arithmetic) is not rebalanced.
+ * @param graph the target graph
+ * @param threshold the minimum number of terms in a chain to rebalance
+ */
+void balance_expressions(
+        ::takatori::relation::graph_type& graph,
+        std::size_t threshold = balance_expressions_default_threshold);
+
+/**
+ * @brief rebuilds long chains of associative operators in the given statement as balanced trees.
+ * @details This rewrites the operators in the process steps of `execute` statements,
+ *      and the tuples of `write` statements.
+ * @param statement the target statement
+ * @param threshold the minimum number of terms in a chain to rebalance
+ */
+void balance_expressions(
+        ::takatori::statement::statement& statement,
+        std::size_t threshold = balance_expressions_default_threshold);
+
+/**
+ * @brief rebuilds long chains of associative operators in the given expression as balanced trees.
+ * @param expression the target expression
+ * @param threshold the minimum number of terms in a chain to rebalance
+ */
+void balance_expressions(
+        ::takatori::scalar::expression& expression,
+        std::size_t threshold = balance_expressions_default_threshold);
+
+} // namespace yugawara::analyzer::details
@@ -0,0 +1,194 @@
+#include "collapse_in_list.h"
+
+#include <algorithm>
+#include <vector>
+
+#include <takatori/value/unknown.h>
+
+#include <takatori/scalar/binary.h>
+#include <takatori/scalar/compare.h>
+#include <takatori/scalar/immediate.h>
+#include <takatori/scalar/unary.h>
+#include <takatori/scalar/variable_reference.h>
+
+#include <takatori/relation/filter.h>
+
+#include <takatori/util/downcast.h>
+
+#include "compare_value.h"
+
+namespace yugawara::analyzer::details {
+
+namespace scalar = ::takatori::scalar;
+namespace relation = ::takatori::relation;
+namespace tvalue = ::takatori::value;
+
+using ::takatori::util::unsafe_downcast;
+
+namespace {
+
+[[nodiscard]] bool is_binary(scalar::expression const& expr, scalar::binary_operator kind) noexcept {
+    return expr.kind() == scalar::binary::tag
+        && unsafe_downcast<scalar::binary>(expr).operator_kind() == kind;
+}
+
+struct equality_term {
+    scalar::variable_reference const* column {};
+    scalar::immediate const* value {};
+};
+
+[[nodiscard]] equality_term extract_equality(scalar::expression const& expr) noexcept {
+    if (expr.kind() != scalar::compare::tag) {
+        return {};
+    }
+    auto&& compare = unsafe_downcast<scalar::compare>(expr);
+    if (compare.operator_kind() != scalar::comparison_operator::equal) {
+        return {};
+    }
+    auto&& left = compare.left();
+    auto&& right = compare.right();
+    if (left.kind() == scalar::variable_reference::tag && right.kind() == scalar::immediate::tag) {
+        return {
+                std::addressof(unsafe_downcast<scalar::variable_reference>(left)),
+                std::addressof(unsafe_downcast<scalar::immediate>(right)),
+        };
+    }
+    if (left.kind() == scalar::immediate::tag && right.kind() == scalar::variable_reference::tag) {
+        return {
+                std::addressof(unsafe_downcast<scalar::variable_reference>(right)),
+                std::addressof(unsafe_downcast<scalar::immediate>(left)),
+        };
+    }
+    return {};
+}
+
+class engine {
+public:
+    [[nodiscard]] std::unique_ptr<scalar::expression> process(std::unique_ptr<scalar::expression> expr) {
+        if (expr->kind() == scalar::unary::tag) {
+            auto&& unary = unsafe_downcast<scalar::unary>(*expr);
+            if (unary.operator_kind() == scalar::unary_operator::conditional_not) {
+                unary.operand(process(unary.release_operand()));
+            }
+            return expr;
+        }
+        if (is_binary(*expr, scalar::binary_operator::conditional_and)) {
+            auto&& binary = unsafe_downcast<scalar::binary>(*expr);
+            binary.left(process(binary.release_left()));
+            binary.right(process(binary.release_right()));
+            return expr;
+        }
+        if (is_binary(*expr, scalar::binary_operator::conditional_or)) {
+            return collapse(std::move(expr));
+        }
+        return expr;
+    }
+
+private:
+    std::vector<std::unique_ptr<scalar::expression>> stack_ {};
+
+    [[nodiscard]] std::unique_ptr<scalar::expression> collapse(std::unique_ptr<scalar::expression> root) {
+        // flatten the disjunction without recursion, keeping the order of terms
+        std::vector<std::unique_ptr<scalar::expression>> terms {};
+        stack_.emplace_back(std::move(root));
+        while (!stack_.empty()) {
+            auto current = std::move(stack_.back());
+            stack_.pop_back();
+            if (is_binary(*current, scalar::binary_operator::conditional_or)) {
+                auto&& binary = unsafe_downcast<scalar::binary>(*current);
+                stack_.emplace_back(binary.release_right());
+                stack_.emplace_back(binary.release_left());
+                continue;
+            }
+            terms.emplace_back(std::move(current));
+        }
+
+        if (is_homogeneous(terms)) {
+            normalize(terms);
+        } else {
+            for (auto&& term : terms) {
+                term = process(std::move(term));
+            }
+        }
+        return build(terms, 0, terms.size());
+    }
+
+    [[nodiscard]] static bool is_homogeneous(std::vector<std::unique_ptr<scalar::expression>> const& terms) {
+        equality_term first {};
+        for (auto&& term : terms) {
+            auto current = extract_equality(*term);
+            if (current.column == nullptr) {
+                return false;
+            }
+            auto&& value = current.value->value();
+            if (value.kind() == tvalue::unknown::tag || compare(value, value) != compare_result::equal) {
+                // NULL or non-comparable values (e.g. NaN)
+                return false;
+            }
+            if (first.column == nullptr) {
+                first = current;
+                continue;
+            }
+            if (current.column->variable() != first.column->variable()
+                    || value.kind() != first.value->value().kind()
+                    || current.value->type() != first.value->type()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static void normalize(std::vector<std::unique_ptr<scalar::expression>>& terms) {
+        auto&& value_of = [](std::unique_ptr<scalar::expression> const& term) -> tvalue::data const& {
+            return extract_equality(*term).value->value();
+        };
+        std::stable_sort(
+                terms.begin(),
+                terms.end(),
+                [&](auto const& left, auto const& right) -> bool {
+                    return compare(value_of(left), value_of(right)) == compare_result::less;
+                });
+        auto last = std::unique(
+                terms.begin(),
+                terms.end(),
+                [&](auto const& left, auto const& right) -> bool {
+                    return compare(value_of(left), value_of(right)) == compare_result::equal;
+                });
+        terms.erase(last, terms.end());
+    }
+
+    [[nodiscard]] static std::unique_ptr<scalar::expression> build(
+            std::vector<std::unique_ptr<scalar::expression>>& terms,
+            std::size_t begin,
+            std::size_t end) {
+        if (end - begin == 1) {
+            return std::move(terms[begin]);
+        }
+        auto middle = begin + (end - begin) / 2;
+        auto left = build(terms, begin, middle);
+        auto right = build(terms, middle, end);
+        return std::make_unique<scalar::binary>(
+                scalar::binary_operator::conditional_or,
+                std::move(left),
+                std::move(right));
+    }
+};
+
+} // namespace
+
+void collapse_in_list(relation::graph_type& graph) {
+    engine e {};
+    for (auto&& expr : graph) {
+        if (expr.kind() == relation::filter::tag) {
+            auto&& filter = unsafe_downcast<relation::filter>(expr);
+            filter.condition(e.process(filter.release_condition()));
+        }
+    }
+}
+
+std::unique_ptr<scalar::expression> collapse_in_list(std::unique_ptr<scalar::expression> expression) {
+    engine e {};
+    return e.process(std::move(expression));
+}
+
+} // namespace yugawara::analyzer::details
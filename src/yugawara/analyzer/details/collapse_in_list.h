@@ -0,0 +1,32 @@
+#pragma once
+
+#include <memory>
+
+#include <takatori/relation/graph.h>
+
+#include <takatori/scalar/expression.h>
+
+namespace yugawara::analyzer::details {
+
+/**
+ * @brief collapses disjunctions of equality comparisons in filter conditions.
+ * @details This flattens each disjunction (conditional OR) without recursion, and then rebuilds it as a balanced tree.
+ *      If all terms of the disjunction are in form of `v = <immediate>` for the same variable `v`, and their
+ *      immediate values have the same type, the terms are also sorted by their values and the duplicates are removed.
+ *
+ *      This keeps the depth of large `IN (...)` predicates logarithmic, so that the succeeding passes which
+ *      recursively walk the predicates do not suffer from deep disjunction chains.
+ * @param graph the target graph
+ */
+void collapse_in_list(::takatori::relation::graph_type& graph);
+
+/**
+ * @brief collapses disjunctions of equality comparisons in the given expression.
+ * @param expression the target expression
+ * @return the rewritten expression
+ * @see collapse_in_list(::takatori::relation::graph_type&)
+ */
+[[nodiscard]] std::unique_ptr<::takatori::scalar::expression> collapse_in_list(
+        std::unique_ptr<::takatori::scalar::expression> expression);
+
+} // namespace yugawara::analyzer::details
@@ -30,9 +30,15 @@ class engine {
 public:
     explicit engine(
             flow_volume_info const& flow_volume,
-            collect_join_keys_feature_set features) :
+            collect_join_keys_feature_set features,
+            double broadcast_build_size_limit,
+            double broadcast_fan_out,
+            double broadcast_row_threshold) :
         flow_volume_ { flow_volume },
-        features_ { features }
+        features_ { features },
+        broadcast_build_size_limit_ { broadcast_build_size_limit },
+        broadcast_fan_out_ { broadcast_fan_out },
+        broadcast_row_threshold_ { broadcast_row_threshold }
     {}
 
     void process(relation::intermediate::join& expr) {
@@ -53,6 +59,9 @@ public:
 private:
     flow_volume_info const& flow_volume_;
     collect_join_keys_feature_set features_;
+    double broadcast_build_size_limit_;
+    double broadcast_fan_out_;
+    double broadcast_row_threshold_;
     stream_variable_flow_info flow_info_;
     search_key_term_builder left_term_builder_;
     search_key_term_builder right_term_builder_;
@@ -80,17 +89,9 @@ private:
         });
     }
 
-    enum class volume_cmp {
-        left_large,
-        tie,
-        right_large,
-    };
-
     void build(relation::intermediate::join& expr) {
-        // FIXME: consider how choose cogroup / broadcast
         auto left_vol = flow_volume_.find(expr.left());
         auto right_vol = flow_volume_.find(expr.right());
-        auto cmp = compare_volume(left_vol, right_vol);
 
         auto local_features = features_;
         if (expr.operator_kind() == join_kind::full_outer) {
@@ -102,16 +103,19 @@ private:
                 right_term_buf_, expr,
                 right_key_buf_, left_key_buf_,
                 right_term_builder_, local_features);
-        if (cmp == volume_cmp::right_large) {
+        if (!is_broadcast_acceptable(right_vol, left_vol, right_kp != 0)) {
+            // only key pairs are left, so that the join will be built as co-group
             right_term_buf_.erase(right_term_buf_.begin() + right_kp, right_term_buf_.end()); // NOLINT
         }
 
-        if (commutative(expr) && enable_broadcast(local_features) && cmp != volume_cmp::left_large) {
+        if (commutative(expr)
+                && enable_broadcast(local_features)
+                && is_broadcast_acceptable(left_vol, right_vol, right_kp != 0)) {
             build_terms(
                     left_term_buf_, expr,
                     left_key_buf_, right_key_buf_,
                     left_term_builder_, local_features);
-            if (is_prefer_left_build()) {
+            if (is_prefer_left_build(left_vol, right_vol)) {
                 flow_info_.erase(expr);
                 swap_upstream(expr.left(), expr.right());
                 organize_key(expr, left_term_buf_);
@@ -121,32 +125,72 @@ private:
         organize_key(expr, right_term_buf_);
     }
 
-    static volume_cmp compare_volume(
-            std::optional<volume_info> const& left,
-            std::optional<volume_info> const& right) {
-        if (!left || !right) {
-            return volume_cmp::tie;
+    [[nodiscard]] static std::optional<double> data_size(std::optional<volume_info> const& volume) noexcept {
+        if (!volume) {
+            return {};
         }
-        constexpr double row_threshold = 1'000;
-        if (left->row_count < row_threshold && right->row_count < row_threshold) {
-            return volume_cmp::tie;
-        }
-        double lvol = left->row_count * left->column_size;
-        double rvol = right->row_count * right->column_size;
+        return volume->row_count * volume->column_size;
+    }
 
-        constexpr double large_ratio = 100;
-        if (lvol > rvol * large_ratio) {
-            return volume_cmp::left_large;
+    /**
+     * @brief returns whether or not the build side is acceptable for broadcast exchange.
+     * @details The broadcast exchange replicates the whole build input into each consumer,
+     *      while the co-group exchange ships both inputs just once.
+     *      This compares the estimated shipping volume of them, and rejects any broadcast exchange
+     *      whose build input is larger than the configured limit.
+     *
+     *      If the join has no key pairs, the co-group exchange would gather both inputs into a single group.
+     *      So that this accepts the build input without comparing the shipping volume, unless it exceeds the limit.
+     *      If neither input is acceptable, the join is built as co-group with a single group,
+     *      which ships each input just once.
+     *
+     *      If the volume of the build input is unknown, this accepts it to keep the planner's behavior
+     *      without volume information: the broadcast exchange is used if the join keys are suitable for it.
+     * @param build the volume of build side input
+     * @param probe the volume of probe side input
+     * @param cogroup_available whether or not the join can be built as co-group with the join keys
+     * @return true if it is acceptable, or the volume is not clear
+     * @return false if the build side must not be broadcast
+     */
+    [[nodiscard]] bool is_broadcast_acceptable(
+            std::optional<volume_info> const& build,
+            std::optional<volume_info> const& probe,
+            bool cogroup_available) const noexcept {
+        auto build_size = data_size(build);
+        if (!build_size) {
+            return true;
+        }
+        if (*build_size > broadcast_build_size_limit_) {
+            return false;
         }
-        if (rvol > lvol * large_ratio) {
-            return volume_cmp::right_large;
+        if (!cogroup_available) {
+            return true;
         }
-        return volume_cmp::tie;
+        auto probe_size = data_size(probe);
+        if (!probe_size) {
+            return true;
+        }
+        if (build->row_count < broadcast_row_threshold_ && probe->row_count < broadcast_row_threshold_) {
+            return true;
+        }
+        double broadcast_cost = *build_size * broadcast_fan_out_;
+        double cogroup_cost = *build_size + *probe_size;
+        return broadcast_cost <= cogroup_cost;
     }
 
-    bool is_prefer_left_build() {
+    bool is_prefer_left_build(
+            std::optional<volume_info> const& left,
+            std::optional<volume_info> const& right) {
         // FIXME: use selectivity
-        return evaluate(left_term_buf_) > evaluate(right_term_buf_);
+        auto left_score = evaluate(left_term_buf_);
+        auto right_score = evaluate(right_term_buf_);
+        if (left_score != right_score) {
+            return left_score > right_score;
+        }
+        // broadcast the smaller input if the search keys are equivalent
+        auto left_size = data_size(left);
+        auto right_size = data_size(right);
+        return left_size && right_size && *left_size < *right_size;
     }
 
     static std::size_t evaluate(sequence_view<std::pair<descriptor::variable const*, search_key_term*> const> terms) {
@@ -249,11 +293,20 @@ private:
 void collect_join_keys(
         relation::graph_type& graph,
         flow_volume_info const& flow_volume,
-        collect_join_keys_feature_set features) {
+        collect_join_keys_feature_set features,
+        std::size_t broadcast_build_size_limit,
+        std::size_t broadcast_fan_out,
+        std::size_t broadcast_row_threshold) {
     if (features.contains(feature::broadcast_scan)) {
         features.insert(feature::broadcast_find);
     }
-    engine e { flow_volume, features };
+    engine e {
+            flow_volume,
+            features,
+            static_cast<double>(broadcast_build_size_limit),
+            static_cast<double>(broadcast_fan_out),
+            static_cast<double>(broadcast_row_threshold),
+    };
     for (auto&& expr : graph) {
         if (expr.kind() == relation::intermediate::join::tag) {
             auto&& join = unsafe_downcast<relation::intermediate::join>(expr);
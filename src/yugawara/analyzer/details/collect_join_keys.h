@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstddef>
+
 #include <takatori/relation/graph.h>
 #include <takatori/util/enum_set.h>
 
@@ -31,13 +33,26 @@ constexpr collect_join_keys_feature_set collect_join_keys_feature_universe {
  *
  *      This will ignore `join_{find,scan}`, or `join_relation` with configured endpoints.
  *      If you want to perform join on indices, please use rewrite_join() before this operation.
+ *
+ *      If the flow volume of join inputs are available, this chooses either co-group or broadcast exchange
+ *      by comparing their estimated shipping volume.
+ *      The input whose estimated data size exceeds `broadcast_build_size_limit` is never broadcast,
+ *      even if the join has no key pairs for co-group exchange.
+ *      If neither input can be broadcast, the join is built as co-group, with a single group if it has no key pairs.
+ *      If the flow volume is not available, the broadcast exchange is always acceptable.
  * @param graph the target graph
  * @param flow_volume the flow volume information
  * @param features the available feature set, NLJ is always allowed
+ * @param broadcast_build_size_limit the max data size of broadcast inputs, in bytes
+ * @param broadcast_fan_out the estimated number of consumers of each broadcast exchange
+ * @param broadcast_row_threshold the max number of rows in join inputs which are always acceptable for broadcast
  */
 void collect_join_keys(
         ::takatori::relation::graph_type& graph,
         flow_volume_info const& flow_volume,
-        collect_join_keys_feature_set features);
+        collect_join_keys_feature_set features,
+        std::size_t broadcast_build_size_limit,
+        std::size_t broadcast_fan_out,
+        std::size_t broadcast_row_threshold);
 
 } // namespace yugawara::analyzer::details
@@ -0,0 +1,203 @@
+#include "collect_partitioned_exchanges.h"
+
+#include <memory>
+#include <vector>
+
+#include <tsl/hopscotch_map.h>
+
+#include <takatori/relation/step/join.h>
+#include <takatori/relation/step/take_group.h>
+#include <takatori/relation/step/take_cogroup.h>
+#include <takatori/relation/step/offer.h>
+
+#include <takatori/plan/process.h>
+#include <takatori/plan/group.h>
+#include <takatori/plan/aggregate.h>
+
+#include <takatori/util/downcast.h>
+
+#include <yugawara/binding/extract.h>
+
+namespace yugawara::analyzer::details {
+
+namespace descriptor = ::takatori::descriptor;
+namespace relation = ::takatori::relation;
+namespace plan = ::takatori::plan;
+
+using ::takatori::util::unsafe_downcast;
+
+namespace {
+
+using key_tuple = std::vector<descriptor::variable const*>;
+
+/**
+ * @brief returns the group keys of the given exchange.
+ * @param exchange the target exchange
+ * @return the group keys
+ * @return nullptr if the exchange does not partition its records
+ */
+[[nodiscard]] std::vector<descriptor::variable> const* find_group_keys(plan::exchange const& exchange) {
+    if (exchange.kind() == plan::group::tag) {
+        return std::addressof(unsafe_downcast<plan::group>(exchange).group_keys());
+    }
+    if (exchange.kind() == plan::aggregate::tag) {
+        return std::addressof(unsafe_downcast<plan::aggregate>(exchange).group_keys());
+    }
+    return nullptr;
+}
+
+class engine {
+public:
+    void process(plan::process const& step) {
+        partitions_.clear();
+        for (auto&& expr : step.operators()) {
+            if (expr.kind() == relation::step::take_group::tag) {
+                collect(unsafe_downcast<relation::step::take_group>(expr));
+            } else if (expr.kind() == relation::step::take_cogroup::tag) {
+                collect(unsafe_downcast<relation::step::take_cogroup>(expr));
+            }
+        }
+        for (auto&& expr : step.operators()) {
+            if (expr.kind() == relation::step::offer::tag) {
+                check(unsafe_downcast<relation::step::offer>(expr));
+            }
+        }
+    }
+
+    [[nodiscard]] partitioned_exchange_set release() {
+        partitioned_exchange_set results {};
+        for (auto&& [exchange, partitioned] : states_) {
+            if (partitioned) {
+                results.emplace(exchange);
+            }
+        }
+        return results;
+    }
+
+private:
+    // the key tuples which partition records in the current process
+    std::vector<key_tuple> partitions_ {};
+
+    // whether or not all inputs of each exchange have been already partitioned
+    ::tsl::hopscotch_map<plan::exchange const*, bool> states_ {};
+
+    void collect(relation::step::take_group const& expr) {
+        add_partition(expr.source(), expr.columns());
+    }
+
+    void collect(relation::step::take_cogroup const& expr) {
+        // only keys in the groups which are never null-supplied are available
+        std::size_t available = 0;
+        if (auto downstream = expr.output().opposite()) {
+            auto&& next = downstream->owner();
+            if (next.kind() == relation::step::join::tag) {
+                using kind = relation::join_kind;
+                switch (unsafe_downcast<relation::step::join>(next).operator_kind()) {
+                    case kind::inner:
+                        available = expr.groups().size();
+                        break;
+                    case kind::left_outer:
+                    case kind::left_outer_at_most_one:
+                    case kind::semi:
+                    case kind::anti:
+                        available = 1;
+                        break;
+                    case kind::full_outer:
+                        available = 0;
+                        break;
+                }
+            } else {
+                // intersection or difference only pass the first group
+                available = 1;
+            }
+        }
+        for (std::size_t i = 0; i < available && i < expr.groups().size(); ++i) {
+            auto&& group = expr.groups()[i];
+            add_partition(group.source(), group.columns());
+        }
+    }
+
+    template<class Columns>
+    void add_partition(descriptor::relation const& source, Columns const& columns) {
+        auto&& exchange = binding::extract<plan::exchange>(source);
+        auto const* keys = find_group_keys(exchange);
+        if (keys == nullptr || keys->empty()) {
+            return;
+        }
+        key_tuple partition {};
+        partition.reserve(keys->size());
+        for (auto&& key : *keys) {
+            auto const* found = find_mapping(columns, key, [](auto& column) -> auto& { return column.source(); });
+            if (found == nullptr) {
+                return;
+            }
+            partition.emplace_back(std::addressof(found->destination()));
+        }
+        partitions_.emplace_back(std::move(partition));
+    }
+
+    void check(relation::step::offer const& expr) {
+        auto&& exchange = binding::extract<plan::exchange>(expr.destination());
+        auto const* keys = find_group_keys(exchange);
+        if (keys == nullptr) {
+            return;
+        }
+        bool partitioned = !keys->empty() && is_partitioned(expr, *keys);
+        auto [iter, success] = states_.emplace(std::addressof(exchange), partitioned);
+        if (!success && !partitioned) {
+            iter.value() = false;
+        }
+    }
+
+    [[nodiscard]] bool is_partitioned(
+            relation::step::offer const& expr,
+            std::vector<descriptor::variable> const& keys) const {
+        for (auto&& partition : partitions_) {
+            if (partition.size() != keys.size()) {
+                continue;
+            }
+            bool matched = true;
+            for (std::size_t i = 0, n = keys.size(); i < n; ++i) {
+                auto const* found = find_mapping(
+                        expr.columns(),
+                        keys[i],
+                        [](auto& column) -> auto& { return column.destination(); });
+                if (found == nullptr || found->source() != *partition[i]) {
+                    matched = false;
+                    break;
+                }
+            }
+            if (matched) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    template<class Columns, class Extractor>
+    [[nodiscard]] static typename Columns::value_type const* find_mapping(
+            Columns const& columns,
+            descriptor::variable const& variable,
+            Extractor&& extractor) {
+        for (auto&& column : columns) {
+            if (extractor(column) == variable) {
+                return std::addressof(column);
+            }
+        }
+        return nullptr;
+    }
+};
+
+} // namespace
+
+partitioned_exchange_set collect_partitioned_exchanges(plan::graph_type const& graph) {
+    engine e {};
+    for (auto&& step : graph) {
+        if (step.kind() == plan::process::tag) {
+            e.process(unsafe_downcast<plan::process>(step));
+        }
+    }
+    return e.release();
+}
+
+} // namespace yugawara::analyzer::details
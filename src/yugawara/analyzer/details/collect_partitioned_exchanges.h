@@ -0,0 +1,28 @@
+#pragma once
+
+#include <takatori/plan/graph.h>
+
+#include <yugawara/analyzer/exchange_column_layout.h>
+
+namespace yugawara::analyzer::details {
+
+/**
+ * @brief collects group exchanges whose input records have been already partitioned by their group keys.
+ * @details A process which starts with `take_group` or `take_cogroup` receives records which are
+ *      hash-partitioned by the group keys of the upstream exchange.
+ *      If every `offer` to a downstream `group` or `aggregate` exchange sends the same key tuple as such
+ *      an upstream partitioning, the runtime can group the records in each partition without transferring them.
+ *
+ *      This tracks the partitioning through the operators in each process as following:
+ *
+ *      - `take_group` partitions by its group keys
+ *      - `take_cogroup` partitions by the group keys of each group, but only the keys of the groups
+ *        which are never null-supplied by the succeeding `join` are available
+ *      - other operators preserve the partitioning, because stream variables are never re-defined in step plans
+ *
+ * @param graph the target step plan, which stream variables have been already rewritten
+ * @return the group and aggregate exchanges whose all inputs have been already partitioned by their group keys
+ */
+partitioned_exchange_set collect_partitioned_exchanges(::takatori::plan::graph_type const& graph);
+
+} // namespace yugawara::analyzer::details
@@ -1,5 +1,8 @@
 #include "decompose_predicate.h"
 
+#include <utility>
+#include <vector>
+
 #include <takatori/scalar/binary.h>
 #include <takatori/util/downcast.h>
 
@@ -19,27 +22,37 @@ public:
 
     bool consume(scalar::expression& expr) {
         // find (A AND B)
-        if (expr.kind() != scalar::binary::tag) {
-            return false;
-        }
-
-        auto&& binary = unsafe_downcast<scalar::binary>(expr);
-        if (binary.operator_kind() != scalar::binary_operator::conditional_and) {
+        if (!is_conjunction(expr)) {
             return false;
         }
 
-        // consume terms except (A AND B) AND ..., recursively
-        if (!consume(binary.left())) {
-            accept(binary.ownership_left());
-        }
-        if (!consume(binary.right())) {
-            accept(binary.ownership_right());
+        // consume terms except (A AND B) AND ..., from left to right without recursion
+        auto&& root = unsafe_downcast<scalar::binary>(expr);
+        stack_.emplace_back(std::addressof(root), false);
+        stack_.emplace_back(std::addressof(root), true);
+        while (!stack_.empty()) {
+            auto [parent, left] = stack_.back();
+            stack_.pop_back();
+            auto&& child = left ? parent->left() : parent->right();
+            if (is_conjunction(child)) {
+                auto&& binary = unsafe_downcast<scalar::binary>(child);
+                stack_.emplace_back(std::addressof(binary), false);
+                stack_.emplace_back(std::addressof(binary), true);
+                continue;
+            }
+            accept(left ? parent->ownership_left() : parent->ownership_right());
         }
         return true;
     }
 
 private:
     predicate_consumer const& consumer_;
+    std::vector<std::pair<scalar::binary*, bool>> stack_ {};
+
+    [[nodiscard]] static bool is_conjunction(scalar::expression const& expr) noexcept {
+        return expr.kind() == scalar::binary::tag
+            && unsafe_downcast<scalar::binary>(expr).operator_kind() == scalar::binary_operator::conditional_and;
+    }
 
     void accept(ownership_reference<scalar::expression>&& ownership) {
         consumer_(std::move(ownership));
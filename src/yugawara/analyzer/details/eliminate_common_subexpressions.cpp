@@ -0,0 +1,660 @@
+#include "eliminate_common_subexpressions.h"
+
+#include <functional>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include <tsl/hopscotch_map.h>
+
+#include <takatori/descriptor/variable.h>
+#include <takatori/scalar/dispatch.h>
+#include <takatori/relation/intermediate/dispatch.h>
+
+#include <takatori/util/clonable.h>
+
+#include <yugawara/binding/factory.h>
+#include <yugawara/binding/extract.h>
+
+#include "expression_hash.h"
+#include "may_raise_error.h"
+
+namespace yugawara::analyzer::details {
+
+namespace descriptor = ::takatori::descriptor;
+namespace scalar = ::takatori::scalar;
+namespace relation = ::takatori::relation;
+
+using ::takatori::util::clone_unique;
+
+namespace {
+
+/**
+ * @brief a scalar expression which has been computed in upstream operators.
+ */
+struct definition {
+    std::size_t hash;
+    scalar::expression const* value;
+    descriptor::variable variable;
+};
+
+using definition_set = std::vector<definition>;
+
+[[nodiscard]] bool is_compound(scalar::expression const& expr) noexcept {
+    return expr.kind() != scalar::immediate::tag && expr.kind() != scalar::variable_reference::tag;
+}
+
+/**
+ * @brief collects sub-expressions which can be shared.
+ */
+class occurrence_collector {
+public:
+    struct occurrence {
+        scalar::expression const* expression;
+        std::size_t hash;
+        std::size_t size;
+        bool conditional;
+    };
+
+    struct info {
+        std::size_t size;
+        bool pure;
+        bool row_dependent;
+    };
+
+    /**
+     * @brief returns whether or not the given expression is a target of this optimization.
+     * @param expr the target expression
+     * @return true if it is a target
+     * @return false otherwise
+     */
+    [[nodiscard]] bool is_target(scalar::expression const& expr) {
+        auto result = scalar::dispatch(*this, expr, false);
+        occurrences_.clear();
+        return is_target(expr, result);
+    }
+
+    /**
+     * @brief collects the target sub-expressions in the given expression.
+     * @param expr the target expression
+     */
+    void collect(scalar::expression const& expr) {
+        (void) dispatch(expr, false);
+    }
+
+    /**
+     * @brief returns the largest sub-expression which appears two or more times in the collected expressions.
+     * @return the found sub-expression
+     * @return empty if there are no such sub-expressions
+     */
+    [[nodiscard]] std::optional<occurrence> find_common() {
+        // groups the equivalent occurrences, in order of their first appearance
+        for (auto&& candidate : occurrences_) {
+            auto [iter, inserted] = group_indices_.emplace(std::addressof(candidate), groups_.size());
+            if (inserted) {
+                groups_.emplace_back(group { std::addressof(candidate), 0, false });
+            }
+            auto&& target = groups_[iter->second];
+            ++target.count;
+            target.unconditional |= !candidate.conditional;
+        }
+        group const* found = nullptr;
+        for (auto&& candidate : groups_) {
+            if (candidate.count < 2) {
+                continue;
+            }
+            if (found != nullptr && found->first->size >= candidate.first->size) {
+                continue;
+            }
+            if (candidate.unconditional || !may_raise_error(*candidate.first->expression)) {
+                found = std::addressof(candidate);
+            }
+        }
+        std::optional<occurrence> result {};
+        if (found != nullptr) {
+            result = *found->first;
+        }
+        group_indices_.clear();
+        groups_.clear();
+        return result;
+    }
+
+    void clear() noexcept {
+        occurrences_.clear();
+    }
+
+    info dispatch(scalar::expression const& expr, bool conditional) {
+        auto result = scalar::dispatch(*this, expr, conditional);
+        if (is_target(expr, result)) {
+            occurrences_.emplace_back(occurrence {
+                    std::addressof(expr),
+                    expression_hash {}(expr),
+                    result.size,
+                    conditional,
+            });
+        }
+        return result;
+    }
+
+    constexpr info operator()(scalar::expression const&, bool) noexcept {
+        return { 1, false, false };
+    }
+
+    constexpr info operator()(scalar::immediate const&, bool) noexcept {
+        return { 1, true, false };
+    }
+
+    info operator()(scalar::variable_reference const& expr, bool) {
+        using kind = binding::variable_info_kind;
+        switch (binding::kind_of(expr.variable())) {
+            case kind::stream_variable:
+                return { 1, true, true };
+            case kind::external_variable:
+            case kind::frame_variable:
+                return { 1, true, false };
+            default:
+                // local variables are only available in the declaring expression
+                return { 1, false, false };
+        }
+    }
+
+    info operator()(scalar::unary const& expr, bool conditional) {
+        return parent(dispatch(expr.operand(), conditional));
+    }
+
+    info operator()(scalar::cast const& expr, bool conditional) {
+        return parent(dispatch(expr.operand(), conditional));
+    }
+
+    info operator()(scalar::binary const& expr, bool conditional) {
+        bool short_circuit = expr.operator_kind() == scalar::binary_operator::conditional_and
+                || expr.operator_kind() == scalar::binary_operator::conditional_or;
+        auto left = dispatch(expr.left(), conditional);
+        auto right = dispatch(expr.right(), conditional || short_circuit);
+        return parent(merge(left, right));
+    }
+
+    info operator()(scalar::compare const& expr, bool conditional) {
+        auto left = dispatch(expr.left(), conditional);
+        auto right = dispatch(expr.right(), conditional);
+        return parent(merge(left, right));
+    }
+
+    info operator()(scalar::match const& expr, bool conditional) {
+        auto input = dispatch(expr.input(), conditional);
+        auto pattern = dispatch(expr.pattern(), conditional);
+        auto escape = dispatch(expr.escape(), conditional);
+        return parent(merge(merge(input, pattern), escape));
+    }
+
+    info operator()(scalar::conditional const& expr, bool conditional) {
+        // only the first condition is always evaluated
+        info result { 0, true, false };
+        bool first = true;
+        for (auto&& alternative : expr.alternatives()) {
+            result = merge(result, dispatch(alternative.condition(), conditional || !first));
+            result = merge(result, dispatch(alternative.body(), true));
+            first = false;
+        }
+        if (auto otherwise = expr.default_expression()) {
+            result = merge(result, dispatch(*otherwise, true));
+        }
+        return parent(result);
+    }
+
+    info operator()(scalar::coalesce const& expr, bool conditional) {
+        // only the first alternative is always evaluated
+        info result { 0, true, false };
+        bool first = true;
+        for (auto&& alternative : expr.alternatives()) {
+            result = merge(result, dispatch(alternative, conditional || !first));
+            first = false;
+        }
+        return parent(result);
+    }
+
+    constexpr info operator()(scalar::let const&, bool) noexcept {
+        // NOTE: we don't step into let expressions because they may declare local variables
+        return { 1, false, false };
+    }
+
+    info operator()(scalar::function_call const& expr, bool conditional) {
+        // NOTE: we cannot share function calls because they may not be deterministic
+        info result { 0, true, false };
+        for (auto&& argument : expr.arguments()) {
+            result = merge(result, dispatch(argument, conditional));
+        }
+        result.pure = false;
+        return parent(result);
+    }
+
+private:
+    /**
+     * @brief a set of equivalent occurrences.
+     */
+    struct group {
+        occurrence const* first;
+        std::size_t count;
+        bool unconditional;
+    };
+
+    struct occurrence_hash {
+        std::size_t operator()(occurrence const* value) const noexcept {
+            return value->hash;
+        }
+    };
+
+    struct occurrence_equal {
+        bool operator()(occurrence const* a, occurrence const* b) const noexcept {
+            return a->hash == b->hash && *a->expression == *b->expression;
+        }
+    };
+
+    std::vector<occurrence> occurrences_ {};
+    ::tsl::hopscotch_map<occurrence const*, std::size_t, occurrence_hash, occurrence_equal> group_indices_ {};
+    std::vector<group> groups_ {};
+
+    [[nodiscard]] static bool is_target(scalar::expression const& expr, info const& result) noexcept {
+        return result.pure && result.row_dependent && is_compound(expr);
+    }
+
+    [[nodiscard]] static constexpr info merge(info const& a, info const& b) noexcept {
+        return {
+                a.size + b.size,
+                a.pure && b.pure,
+                a.row_dependent || b.row_dependent,
+        };
+    }
+
+    [[nodiscard]] static constexpr info parent(info const& children) noexcept {
+        return { children.size + 1, children.pure, children.row_dependent };
+    }
+};
+
+/**
+ * @brief replaces sub-expressions with variable references.
+ */
+class rewriter {
+public:
+    using finder_type = std::function<descriptor::variable const*(scalar::expression const&)>;
+
+    explicit rewriter(finder_type finder) noexcept :
+        finder_ { std::move(finder) }
+    {}
+
+    /**
+     * @brief rewrites the given expression.
+     * @param expr the target expression
+     * @return the replacement of the given expression
+     * @return empty if the given expression itself was not replaced
+     */
+    [[nodiscard]] std::unique_ptr<scalar::expression> rewrite(scalar::expression& expr) {
+        if (is_compound(expr)) {
+            if (auto const* variable = finder_(expr)) {
+                return std::make_unique<scalar::variable_reference>(*variable);
+            }
+        }
+        scalar::dispatch(*this, expr);
+        return {};
+    }
+
+    void operator()(scalar::expression&) noexcept {
+        // immediates, variable references, let expressions, or unknown expressions
+    }
+
+    void operator()(scalar::unary& expr) {
+        if (auto replacement = rewrite(expr.operand())) {
+            expr.operand(std::move(replacement));
+        }
+    }
+
+    void operator()(scalar::cast& expr) {
+        if (auto replacement = rewrite(expr.operand())) {
+            expr.operand(std::move(replacement));
+        }
+    }
+
+    void operator()(scalar::binary& expr) {
+        if (auto replacement = rewrite(expr.left())) {
+            expr.left(std::move(replacement));
+        }
+        if (auto replacement = rewrite(expr.right())) {
+            expr.right(std::move(replacement));
+        }
+    }
+
+    void operator()(scalar::compare& expr) {
+        if (auto replacement = rewrite(expr.left())) {
+            expr.left(std::move(replacement));
+        }
+        if (auto replacement = rewrite(expr.right())) {
+            expr.right(std::move(replacement));
+        }
+    }
+
+    void operator()(scalar::match& expr) {
+        if (auto replacement = rewrite(expr.input())) {
+            expr.input(std::move(replacement));
+        }
+        if (auto replacement = rewrite(expr.pattern())) {
+            expr.pattern(std::move(replacement));
+        }
+        if (auto replacement = rewrite(expr.escape())) {
+            expr.escape(std::move(replacement));
+        }
+    }
+
+    void operator()(scalar::conditional& expr) {
+        for (auto&& alternative : expr.alternatives()) {
+            if (auto replacement = rewrite(alternative.condition())) {
+                alternative.condition(std::move(replacement));
+            }
+            if (auto replacement = rewrite(alternative.body())) {
+                alternative.body(std::move(replacement));
+            }
+        }
+        if (auto otherwise = expr.default_expression()) {
+            if (auto replacement = rewrite(*otherwise)) {
+                expr.default_expression(std::move(replacement));
+            }
+        }
+    }
+
+    void operator()(scalar::coalesce& expr) {
+        rewrite_list(expr.alternatives());
+    }
+
+    void operator()(scalar::function_call& expr) {
+        rewrite_list(expr.arguments());
+    }
+
+private:
+    finder_type finder_;
+
+    void rewrite_list(::takatori::tree::tree_element_vector<scalar::expression>& list) {
+        for (auto iter = list.begin(); iter != list.end(); ++iter) {
+            if (auto replacement = rewrite(*iter)) {
+                (void) list.exchange(iter, std::move(replacement));
+            }
+        }
+    }
+};
+
+class engine {
+public:
+    explicit engine(relation::graph_type& graph) noexcept :
+        graph_ { graph }
+    {}
+
+    void process() {
+        relation::sort_from_upstream(graph_, [&](relation::expression& expr) {
+            relation::intermediate::dispatch(*this, expr);
+        });
+
+        graph_.reserve(graph_.size() + insertions_.size());
+        for (auto&& [port, insertion] : insertions_) {
+            /*
+             * before:
+             *  upstream -- port
+             *
+             * after:
+             *  upstream -- insertion -- port
+             */
+            if (auto downstream = port->reconnect_to(insertion->input())) {
+                insertion->output().connect_to(*downstream);
+            }
+            graph_.insert(std::move(insertion));
+        }
+        insertions_.clear();
+        definitions_.clear();
+    }
+
+    void operator()(relation::expression const& expr) {
+        // NOTE: upstream definitions are not available in downstream by default
+        definitions_.insert_or_assign(std::addressof(expr), std::make_shared<definition_set>());
+    }
+
+    void operator()(relation::join_find& expr) {
+        auto defs = upstream(expr.left());
+        rewrite_keys(*defs, expr.keys());
+        rewrite_condition(*defs, expr);
+        definitions_.insert_or_assign(std::addressof(expr), std::move(defs));
+    }
+
+    void operator()(relation::join_scan& expr) {
+        auto defs = upstream(expr.left());
+        rewrite_keys(*defs, expr.lower().keys());
+        rewrite_keys(*defs, expr.upper().keys());
+        rewrite_condition(*defs, expr);
+        definitions_.insert_or_assign(std::addressof(expr), std::move(defs));
+    }
+
+    void operator()(relation::apply& expr) {
+        auto defs = upstream(expr.input());
+        rewriter r { finder(*defs) };
+        auto&& arguments = expr.arguments();
+        for (auto iter = arguments.begin(); iter != arguments.end(); ++iter) {
+            if (auto replacement = r.rewrite(*iter)) {
+                (void) arguments.exchange(iter, std::move(replacement));
+            }
+        }
+        definitions_.insert_or_assign(std::addressof(expr), std::move(defs));
+    }
+
+    void operator()(relation::project& expr) {
+        auto defs = upstream(expr.input());
+        {
+            rewriter r { finder(*defs) };
+            for (auto&& column : expr.columns()) {
+                if (auto replacement = r.rewrite(column.value())) {
+                    column.value(std::move(replacement));
+                }
+            }
+        }
+        factorize(expr, defs);
+
+        // makes the project columns available in downstream operators
+        std::shared_ptr<definition_set> next {};
+        for (auto&& column : expr.columns()) {
+            auto&& value = column.value();
+            if (collector_.is_target(value)) {
+                if (!next) {
+                    next = std::make_shared<definition_set>(*defs);
+                }
+                next->emplace_back(definition {
+                        expression_hash {}(value),
+                        std::addressof(value),
+                        column.variable(),
+                });
+            }
+        }
+        if (next) {
+            definitions_.insert_or_assign(std::addressof(expr), std::move(next));
+        } else {
+            definitions_.insert_or_assign(std::addressof(expr), std::move(defs));
+        }
+    }
+
+    void operator()(relation::filter& expr) {
+        auto defs = upstream(expr.input());
+        {
+            rewriter r { finder(*defs) };
+            if (auto replacement = r.rewrite(expr.condition())) {
+                expr.condition(std::move(replacement));
+            }
+        }
+        factorize(expr, defs);
+        definitions_.insert_or_assign(std::addressof(expr), std::move(defs));
+    }
+
+    void operator()(relation::buffer& expr) {
+        definitions_.insert_or_assign(std::addressof(expr), upstream(expr.input()));
+    }
+
+    void operator()(relation::identify& expr) {
+        definitions_.insert_or_assign(std::addressof(expr), upstream(expr.input()));
+    }
+
+    void operator()(relation::intermediate::join& expr) {
+        auto left = upstream(expr.left());
+        auto right = upstream(expr.right());
+        auto both = std::make_shared<definition_set>(*left);
+        both->insert(both->end(), right->begin(), right->end());
+
+        // the join conditions are evaluated before padding nulls
+        rewrite_keys(*both, expr.lower().keys());
+        rewrite_keys(*both, expr.upper().keys());
+        rewrite_condition(*both, expr);
+
+        using kind = relation::join_kind;
+        switch (expr.operator_kind()) {
+            case kind::inner:
+                definitions_.insert_or_assign(std::addressof(expr), std::move(both));
+                break;
+            case kind::left_outer:
+            case kind::left_outer_at_most_one:
+            case kind::semi:
+            case kind::anti:
+                definitions_.insert_or_assign(std::addressof(expr), std::move(left));
+                break;
+            case kind::full_outer:
+                definitions_.insert_or_assign(std::addressof(expr), std::make_shared<definition_set>());
+                break;
+        }
+    }
+
+    void operator()(relation::intermediate::distinct& expr) {
+        definitions_.insert_or_assign(std::addressof(expr), upstream(expr.input()));
+    }
+
+    void operator()(relation::intermediate::limit& expr) {
+        definitions_.insert_or_assign(std::addressof(expr), upstream(expr.input()));
+    }
+
+private:
+    relation::graph_type& graph_;
+    tsl::hopscotch_map<relation::expression const*, std::shared_ptr<definition_set const>> definitions_ {};
+    std::vector<std::pair<relation::expression::input_port_type*, std::unique_ptr<relation::project>>> insertions_ {};
+    occurrence_collector collector_ {};
+
+    [[nodiscard]] std::shared_ptr<definition_set const> upstream(relation::expression::input_port_type const& port) {
+        if (auto opposite = port.opposite()) {
+            if (auto iter = definitions_.find(std::addressof(opposite->owner())); iter != definitions_.end()) {
+                return iter->second;
+            }
+        }
+        return std::make_shared<definition_set>();
+    }
+
+    [[nodiscard]] static rewriter::finder_type finder(definition_set const& defs) {
+        return [&](scalar::expression const& expr) -> descriptor::variable const* {
+            if (defs.empty()) {
+                return nullptr;
+            }
+            auto hash = expression_hash {}(expr);
+            for (auto&& def : defs) {
+                if (def.hash == hash && *def.value == expr) {
+                    return std::addressof(def.variable);
+                }
+            }
+            return nullptr;
+        };
+    }
+
+    template<class Keys>
+    void rewrite_keys(definition_set const& defs, Keys& keys) {
+        rewriter r { finder(defs) };
+        for (auto&& key : keys) {
+            if (auto replacement = r.rewrite(key.value())) {
+                key.value(std::move(replacement));
+            }
+        }
+    }
+
+    template<class T>
+    void rewrite_condition(definition_set const& defs, T& expr) {
+        if (auto condition = expr.condition()) {
+            rewriter r { finder(defs) };
+            if (auto replacement = r.rewrite(*condition)) {
+                expr.condition(std::move(replacement));
+            }
+        }
+    }
+
+    template<class Consumer>
+    static void each_root(relation::filter& expr, Consumer&& consumer) {
+        consumer(expr.condition(), [&](std::unique_ptr<scalar::expression> replacement) {
+            expr.condition(std::move(replacement));
+        });
+    }
+
+    template<class Consumer>
+    static void each_root(relation::project& expr, Consumer&& consumer) {
+        for (auto&& column : expr.columns()) {
+            consumer(column.value(), [&](std::unique_ptr<scalar::expression> replacement) {
+                column.value(std::move(replacement));
+            });
+        }
+    }
+
+    /**
+     * @brief extracts the common sub-expressions in the given operator into a new upstream projection.
+     * @param expr the target operator
+     * @param defs the available definitions, which will be extended by the new projection
+     */
+    template<class T>
+    void factorize(T& expr, std::shared_ptr<definition_set const>& defs) {
+        std::vector<relation::project::column> columns {};
+        std::shared_ptr<definition_set> next {};
+        while (true) {
+            collector_.clear();
+            each_root(expr, [&](scalar::expression& root, auto&&) {
+                collector_.collect(root);
+            });
+            auto common = collector_.find_common();
+            if (!common) {
+                break;
+            }
+            auto value = clone_unique(*common->expression);
+            auto variable = binding::factory {}.stream_variable("cse");
+            rewriter r {
+                    [&](scalar::expression const& target) -> descriptor::variable const* {
+                        if (target == *value) {
+                            return std::addressof(variable);
+                        }
+                        return nullptr;
+                    },
+            };
+            each_root(expr, [&](scalar::expression& root, auto&& setter) {
+                if (auto replacement = r.rewrite(root)) {
+                    setter(std::move(replacement));
+                }
+            });
+            if (!next) {
+                next = std::make_shared<definition_set>(*defs);
+            }
+            next->emplace_back(definition {
+                    common->hash,
+                    value.get(),
+                    variable,
+            });
+            columns.emplace_back(std::move(variable), std::move(value));
+        }
+        collector_.clear();
+        if (!columns.empty()) {
+            insertions_.emplace_back(
+                    std::addressof(expr.input()),
+                    std::make_unique<relation::project>(std::move(columns)));
+            defs = std::move(next);
+        }
+    }
+};
+
+} // namespace
+
+void eliminate_common_subexpressions(relation::graph_type& graph) {
+    engine e { graph };
+    e.process();
+}
+
+} // namespace yugawara::analyzer::details
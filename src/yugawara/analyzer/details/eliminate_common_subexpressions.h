@@ -0,0 +1,28 @@
+#pragma once
+
+#include <takatori/relation/graph.h>
+
+namespace yugawara::analyzer::details {
+
+/**
+ * @brief eliminates common sub-expressions in the given intermediate execution plan.
+ * @details This rewrites scalar expressions in the relational operators as following:
+ *
+ *      - If a sub-expression is equivalent to a value of upstream `project` column, this replaces it with
+ *        a reference to the column
+ *      - If a sub-expression appears two or more times in a `filter` or `project` operator, this inserts
+ *        a new `project` operator in front of the operator, and then replaces them with a reference to
+ *        the new column
+ *
+ *      This only handles sub-expressions which refer stream variables and never contain function calls or
+ *      local variable declarations.
+ *      Sub-expressions in conditionally evaluated positions (e.g. right operands of AND/OR) are only extracted
+ *      if they never raise errors, or they also appear in unconditional positions.
+ *
+ *      This never passes column definitions through operators which can emit nulls instead of the column values,
+ *      like the null-supplying side of outer joins.
+ * @param graph the target graph
+ */
+void eliminate_common_subexpressions(::takatori::relation::graph_type& graph);
+
+} // namespace yugawara::analyzer::details
@@ -0,0 +1,151 @@
+#include "estimate_flow_volume.h"
+
+#include <vector>
+
+#include <takatori/relation/scan.h>
+#include <takatori/relation/filter.h>
+#include <takatori/relation/project.h>
+#include <takatori/relation/values.h>
+
+#include <takatori/util/downcast.h>
+#include <takatori/util/optional_ptr.h>
+
+#include <yugawara/binding/extract.h>
+
+#include <yugawara/storage/index.h>
+#include <yugawara/storage/column.h>
+
+#include "scan_key_collector.h"
+
+namespace yugawara::analyzer::details {
+
+namespace relation = ::takatori::relation;
+
+using search_key = storage::details::search_key_element;
+using volume_info = flow_volume_info::volume_info;
+
+using ::takatori::util::optional_ptr;
+using ::takatori::util::unsafe_downcast;
+
+namespace {
+
+// the estimated size of column values whose shape is not clear
+constexpr double default_column_size = 16.0;
+
+class engine {
+public:
+    explicit engine(
+            index_estimator const& index_estimator,
+            exchange_column_shape_provider const& shapes,
+            flow_volume_info& results) noexcept :
+        index_estimator_ { index_estimator },
+        shapes_ { shapes },
+        results_ { results }
+    {}
+
+    void process(relation::graph_type& graph) {
+        for (auto&& expr : graph) {
+            if (expr.kind() == relation::scan::tag) {
+                auto&& scan = unsafe_downcast<relation::scan>(expr);
+                if (!scan.limit() && !scan.lower() && !scan.upper()) {
+                    process(scan);
+                }
+            } else if (expr.kind() == relation::values::tag) {
+                process(unsafe_downcast<relation::values>(expr));
+            }
+        }
+    }
+
+private:
+    index_estimator const& index_estimator_;
+    exchange_column_shape_provider const& shapes_;
+    flow_volume_info& results_;
+    scan_key_collector collector_;
+    std::vector<search_key> search_key_buf_;
+
+    void process(relation::scan& expr) {
+        auto&& index = binding::extract<storage::index>(expr.source());
+        if (collector_(expr, false)) {
+            build_search_key(index);
+        }
+        std::vector<index_estimator::column_ref> columns {};
+        columns.reserve(expr.columns().size());
+        double column_size = 0;
+        for (auto&& mapping : expr.columns()) {
+            auto&& column = binding::extract<storage::column>(mapping.source());
+            columns.emplace_back(column);
+            column_size += size_of(column);
+        }
+        auto result = index_estimator_(index, search_key_buf_, {}, columns);
+
+        collector_.clear();
+        search_key_buf_.clear();
+
+        if (auto count = result.count()) {
+            propagate(expr.output(), { static_cast<double>(*count), column_size });
+        }
+    }
+
+    void process(relation::values& expr) {
+        auto column_size = default_column_size * static_cast<double>(expr.columns().size());
+        propagate(expr.output(), { static_cast<double>(expr.rows().size()), column_size });
+    }
+
+    void build_search_key(storage::index const& index) {
+        auto&& keys = index.keys();
+        search_key_buf_.reserve(keys.size());
+        for (auto&& key : keys) {
+            auto term = collector_.find(key.column());
+            if (!term) {
+                break;
+            }
+            search_key_buf_.emplace_back(term->build_index_search_key(key.column()));
+            if (!term->equivalent()) {
+                break;
+            }
+        }
+    }
+
+    void propagate(relation::expression::output_port_type& output, volume_info volume) {
+        optional_ptr current { output };
+        while (current) {
+            results_.add(*current, volume);
+            if (!current->opposite()) {
+                break;
+            }
+            auto&& next = current->opposite()->owner();
+            if (next.kind() == relation::filter::tag) {
+                current = unsafe_downcast<relation::filter>(next).output();
+            } else if (next.kind() == relation::project::tag) {
+                auto&& project = unsafe_downcast<relation::project>(next);
+                volume.column_size += default_column_size * static_cast<double>(project.columns().size());
+                current = project.output();
+            } else {
+                current = {};
+            }
+        }
+    }
+
+    [[nodiscard]] double size_of(storage::column const& column) const {
+        if (shapes_) {
+            if (auto shape = shapes_(column.type())) {
+                return static_cast<double>(shape->size);
+            }
+        }
+        return default_column_size;
+    }
+};
+
+} // namespace
+
+flow_volume_info estimate_flow_volume(
+        relation::graph_type& graph,
+        class index_estimator const& index_estimator,
+        exchange_column_shape_provider const& shapes) {
+    flow_volume_info results {};
+    engine e { index_estimator, shapes, results };
+    e.process(graph);
+    return results;
+}
+
+} // namespace yugawara::analyzer::details
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <takatori/relation/graph.h>
+
+#include <yugawara/analyzer/index_estimator.h>
+#include <yugawara/analyzer/exchange_column_layout.h>
+
+#include "flow_volume_info.h"
+
+namespace yugawara::analyzer::details {
+
+/**
+ * @brief estimates the output volume of relational operators.
+ * @details This estimates the number of rows of individual `scan` operations by using the index estimator,
+ *      with the search keys collected from their succeeding filters, and then propagates it to the succeeding
+ *      `filter` and `project` operations.
+ *      This also estimates the volume of `values` operations from their rows.
+ *
+ *      The operators whose number of rows is not provided by the index estimator do not have their volume.
+ *      The row size is the sum of the column sizes provided by `shapes`,
+ *      and columns without the provided shape are estimated as a fixed size.
+ * @param graph the target graph
+ * @param index_estimator the index cost estimator
+ * @param shapes provides the physical shape of column values, may be empty
+ * @return the estimated flow volume
+ */
+[[nodiscard]] flow_volume_info estimate_flow_volume(
+        ::takatori::relation::graph_type& graph,
+        class index_estimator const& index_estimator,
+        exchange_column_shape_provider const& shapes);
+
+} // namespace yugawara::analyzer::details
@@ -0,0 +1,109 @@
+#include "expression_hash.h"
+
+#include <functional>
+
+#include <takatori/descriptor/variable.h>
+#include <takatori/scalar/dispatch.h>
+
+namespace yugawara::analyzer::details {
+
+namespace descriptor = ::takatori::descriptor;
+namespace scalar = ::takatori::scalar;
+
+namespace {
+
+class engine {
+public:
+    [[nodiscard]] std::size_t dispatch(scalar::expression const& expr) {
+        auto result = mix(static_cast<std::size_t>(expr.kind()), 0);
+        return mix(result, scalar::dispatch(*this, expr));
+    }
+
+    [[nodiscard]] constexpr std::size_t operator()(scalar::expression const&) const noexcept {
+        // immediates, or unknown expressions
+        return 0;
+    }
+
+    [[nodiscard]] std::size_t operator()(scalar::variable_reference const& expr) const {
+        return std::hash<descriptor::variable> {}(expr.variable());
+    }
+
+    [[nodiscard]] std::size_t operator()(scalar::unary const& expr) {
+        return mix(static_cast<std::size_t>(expr.operator_kind()), dispatch(expr.operand()));
+    }
+
+    [[nodiscard]] std::size_t operator()(scalar::cast const& expr) {
+        return dispatch(expr.operand());
+    }
+
+    [[nodiscard]] std::size_t operator()(scalar::binary const& expr) {
+        auto result = static_cast<std::size_t>(expr.operator_kind());
+        result = mix(result, dispatch(expr.left()));
+        return mix(result, dispatch(expr.right()));
+    }
+
+    [[nodiscard]] std::size_t operator()(scalar::compare const& expr) {
+        auto result = static_cast<std::size_t>(expr.operator_kind());
+        result = mix(result, dispatch(expr.left()));
+        return mix(result, dispatch(expr.right()));
+    }
+
+    [[nodiscard]] std::size_t operator()(scalar::match const& expr) {
+        auto result = static_cast<std::size_t>(expr.operator_kind());
+        result = mix(result, dispatch(expr.input()));
+        result = mix(result, dispatch(expr.pattern()));
+        return mix(result, dispatch(expr.escape()));
+    }
+
+    [[nodiscard]] std::size_t operator()(scalar::conditional const& expr) {
+        std::size_t result = 0;
+        for (auto&& alternative : expr.alternatives()) {
+            result = mix(result, dispatch(alternative.condition()));
+            result = mix(result, dispatch(alternative.body()));
+        }
+        if (auto otherwise = expr.default_expression()) {
+            result = mix(result, dispatch(*otherwise));
+        }
+        return result;
+    }
+
+    [[nodiscard]] std::size_t operator()(scalar::coalesce const& expr) {
+        std::size_t result = 0;
+        for (auto&& alternative : expr.alternatives()) {
+            result = mix(result, dispatch(alternative));
+        }
+        return result;
+    }
+
+    [[nodiscard]] std::size_t operator()(scalar::let const& expr) {
+        std::size_t result = 0;
+        for (auto&& decl : expr.variables()) {
+            result = mix(result, std::hash<descriptor::variable> {}(decl.variable()));
+            result = mix(result, dispatch(decl.value()));
+        }
+        return mix(result, dispatch(expr.body()));
+    }
+
+    [[nodiscard]] std::size_t operator()(scalar::function_call const& expr) {
+        std::size_t result = 0;
+        for (auto&& argument : expr.arguments()) {
+            result = mix(result, dispatch(argument));
+        }
+        return result;
+    }
+
+private:
+    [[nodiscard]] static constexpr std::size_t mix(std::size_t seed, std::size_t value) noexcept {
+        // same as boost::hash_combine
+        return seed ^ (value + 0x9e3779b9UL + (seed << 6U) + (seed >> 2U)); // NOLINT(*-magic-numbers)
+    }
+};
+
+} // namespace
+
+std::size_t expression_hash::operator()(scalar::expression const& expression) const {
+    engine e {};
+    return e.dispatch(expression);
+}
+
+} // namespace yugawara::analyzer::details
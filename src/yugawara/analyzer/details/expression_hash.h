@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstddef>
+
+#include <takatori/scalar/expression.h>
+
+namespace yugawara::analyzer::details {
+
+/**
+ * @brief computes structural hash code of scalar expressions.
+ * @details The structurally equivalent expressions (in terms of `operator==`) always have the same hash code.
+ *      This does not distinguish the individual constant values, and then users must compare the expressions
+ *      which have the same hash code.
+ */
+class expression_hash {
+public:
+    /**
+     * @brief returns the structural hash code of the given expression.
+     * @param expression the target expression
+     * @return the hash code
+     */
+    [[nodiscard]] std::size_t operator()(::takatori::scalar::expression const& expression) const;
+};
+
+} // namespace yugawara::analyzer::details
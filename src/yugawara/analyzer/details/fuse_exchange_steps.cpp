@@ -0,0 +1,335 @@
+#include "fuse_exchange_steps.h"
+
+#include <algorithm>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include <tsl/hopscotch_map.h>
+
+#include <takatori/relation/join_find.h>
+#include <takatori/relation/join_scan.h>
+#include <takatori/relation/step/take_flat.h>
+#include <takatori/relation/step/take_group.h>
+#include <takatori/relation/step/take_cogroup.h>
+#include <takatori/relation/step/flatten.h>
+#include <takatori/relation/step/offer.h>
+
+#include <takatori/plan/forward.h>
+#include <takatori/plan/group.h>
+
+#include <takatori/util/assertion.h>
+#include <takatori/util/downcast.h>
+#include <takatori/util/optional_ptr.h>
+
+#include <yugawara/binding/factory.h>
+#include <yugawara/binding/extract.h>
+
+#include "remove_orphaned_elements.h"
+
+namespace yugawara::analyzer::details {
+
+namespace descriptor = ::takatori::descriptor;
+namespace relation = ::takatori::relation;
+namespace plan = ::takatori::plan;
+
+using ::takatori::util::optional_ptr;
+using ::takatori::util::unsafe_downcast;
+
+namespace {
+
+struct exchange_info {
+    std::vector<relation::step::offer*> offers {};
+    std::vector<relation::expression*> consumers {};
+};
+
+template<class T>
+[[nodiscard]] optional_ptr<T> upstream_of(relation::expression::input_port_type& port) {
+    if (auto opposite = port.opposite(); opposite && opposite->owner().kind() == T::tag) {
+        return unsafe_downcast<T>(opposite->owner());
+    }
+    return {};
+}
+
+template<class T>
+[[nodiscard]] optional_ptr<T> downstream_of(relation::expression::output_port_type& port) {
+    if (auto opposite = port.opposite(); opposite && opposite->owner().kind() == T::tag) {
+        return unsafe_downcast<T>(opposite->owner());
+    }
+    return {};
+}
+
+[[nodiscard]] std::optional<std::size_t> min_limit(
+        std::optional<std::size_t> a,
+        std::optional<std::size_t> b) noexcept {
+    if (!a) {
+        return b;
+    }
+    if (!b) {
+        return a;
+    }
+    return std::min(*a, *b);
+}
+
+class engine {
+public:
+    explicit engine(relation::graph_type& source, plan::graph_type& destination) noexcept :
+        source_ { source },
+        destination_ { destination }
+    {}
+
+    void process() {
+        bool changed = false;
+        while (fuse_once()) {
+            changed = true;
+        }
+        if (changed) {
+            remove_orphaned_elements(source_);
+        }
+    }
+
+private:
+    relation::graph_type& source_;
+    plan::graph_type& destination_;
+    ::tsl::hopscotch_map<plan::exchange const*, exchange_info> exchanges_ {};
+
+    [[nodiscard]] bool fuse_once() {
+        collect();
+        for (auto&& step : destination_) {
+            if (step.kind() == plan::forward::tag) {
+                auto&& exchange = unsafe_downcast<plan::forward>(step);
+                if (fuse_pass_through(exchange) || fuse_limit(exchange)) {
+                    return true;
+                }
+            } else if (step.kind() == plan::group::tag) {
+                if (fuse_group(unsafe_downcast<plan::group>(step))) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    void collect() {
+        exchanges_.clear();
+        for (auto&& expr : source_) {
+            switch (expr.kind()) {
+                case relation::step::offer::tag: {
+                    auto&& offer = unsafe_downcast<relation::step::offer>(expr);
+                    get(offer.destination()).offers.emplace_back(std::addressof(offer));
+                    break;
+                }
+                case relation::step::take_flat::tag:
+                    add_consumer(unsafe_downcast<relation::step::take_flat>(expr).source(), expr);
+                    break;
+                case relation::step::take_group::tag:
+                    add_consumer(unsafe_downcast<relation::step::take_group>(expr).source(), expr);
+                    break;
+                case relation::step::take_cogroup::tag:
+                    for (auto&& group : unsafe_downcast<relation::step::take_cogroup>(expr).groups()) {
+                        add_consumer(group.source(), expr);
+                    }
+                    break;
+                case relation::join_find::tag:
+                    add_consumer(unsafe_downcast<relation::join_find>(expr).source(), expr);
+                    break;
+                case relation::join_scan::tag:
+                    add_consumer(unsafe_downcast<relation::join_scan>(expr).source(), expr);
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+
+    [[nodiscard]] exchange_info& get(descriptor::relation const& desc) {
+        auto&& exchange = binding::extract<plan::exchange>(desc);
+        return exchanges_[std::addressof(exchange)];
+    }
+
+    void add_consumer(descriptor::relation const& desc, relation::expression& expr) {
+        if (auto exchange = binding::extract_if<plan::exchange>(desc)) {
+            exchanges_[exchange.get()].consumers.emplace_back(std::addressof(expr));
+        }
+    }
+
+    [[nodiscard]] exchange_info const& info(plan::exchange const& exchange) const {
+        static exchange_info const empty {};
+        if (auto it = exchanges_.find(std::addressof(exchange)); it != exchanges_.end()) {
+            return it->second;
+        }
+        return empty;
+    }
+
+    template<class T>
+    [[nodiscard]] optional_ptr<T> single_consumer(plan::exchange const& exchange) const {
+        auto&& consumers = info(exchange).consumers;
+        if (consumers.size() != 1 || consumers.front()->kind() != T::tag) {
+            return {};
+        }
+        return unsafe_downcast<T>(*consumers.front());
+    }
+
+    [[nodiscard]] optional_ptr<relation::step::offer> single_offer(plan::exchange const& exchange) const {
+        auto&& offers = info(exchange).offers;
+        if (offers.size() != 1 || !offers.front()->columns().empty()) {
+            return {};
+        }
+        return *offers.front();
+    }
+
+    bool fuse_pass_through(plan::forward& exchange) {
+        /*
+         * .. - offer - [forward] - take_flat - offer - [downstream] - ..
+         * =>
+         * .. - offer - [downstream] - ..
+         */
+        if (exchange.limit()) {
+            return false;
+        }
+        auto take = single_consumer<relation::step::take_flat>(exchange);
+        if (!take || !take->columns().empty()) {
+            return false;
+        }
+        auto offer = downstream_of<relation::step::offer>(take->output());
+        if (!offer || !offer->columns().empty()) {
+            return false;
+        }
+        auto&& downstream = binding::extract<plan::exchange>(offer->destination());
+        if (std::addressof(downstream) == std::addressof(exchange)) {
+            return false;
+        }
+        for (auto* upstream : info(exchange).offers) {
+            upstream->destination() = binding::factory {}(downstream);
+        }
+        take->output().disconnect_all();
+        offer->input().disconnect_all();
+        erase(exchange);
+        return true;
+    }
+
+    bool fuse_limit(plan::forward& exchange) {
+        /*
+         * .. - offer - [group{group=(), limit=M}] - take_group - flatten - offer - [forward{limit=N}] - take_flat - ..
+         * =>
+         * .. - offer - [group{group=(), limit=min(M, N)}] - take_group - flatten - ..
+         */
+        if (!exchange.limit()) {
+            return false;
+        }
+        auto offer = single_offer(exchange);
+        auto take = single_consumer<relation::step::take_flat>(exchange);
+        if (!offer || !take || !take->columns().empty()) {
+            return false;
+        }
+        auto flatten = upstream_of<relation::step::flatten>(offer->input());
+        if (!flatten) {
+            return false;
+        }
+        auto upstream_take = upstream_of<relation::step::take_group>(flatten->input());
+        if (!upstream_take) {
+            return false;
+        }
+        auto&& upstream = binding::extract<plan::exchange>(upstream_take->source());
+        if (upstream.kind() != plan::group::tag) {
+            return false;
+        }
+        auto&& group = find_group(upstream);
+        if (!group.group_keys().empty() || !single_consumer<relation::step::take_group>(group)) {
+            // the limit of group exchange is applied to individual groups
+            return false;
+        }
+        auto downstream = take->output().opposite();
+        if (!downstream) {
+            return false;
+        }
+        group.limit(min_limit(group.limit(), exchange.limit()));
+
+        offer->input().disconnect_all();
+        take->output().disconnect_all();
+        flatten->output() >> *downstream;
+        erase(exchange);
+        return true;
+    }
+
+    bool fuse_group(plan::group& exchange) {
+        /*
+         * .. - offer - [group{k}] - take_group - flatten - offer - [group{k}] - take_group - ..
+         * =>
+         * .. - offer - [group{k}] - take_group - ..
+         */
+        auto offer = single_offer(exchange);
+        auto take = single_consumer<relation::step::take_group>(exchange);
+        if (!offer || !take || !take->columns().empty()) {
+            return false;
+        }
+        auto flatten = upstream_of<relation::step::flatten>(offer->input());
+        if (!flatten) {
+            return false;
+        }
+        auto upstream_take = upstream_of<relation::step::take_group>(flatten->input());
+        if (!upstream_take || !upstream_take->columns().empty()) {
+            return false;
+        }
+        auto&& upstream = binding::extract<plan::exchange>(upstream_take->source());
+        if (upstream.kind() != plan::group::tag) {
+            return false;
+        }
+        auto&& group = find_group(upstream);
+        if (!single_consumer<relation::step::take_group>(group) || !is_compatible(group, exchange)) {
+            return false;
+        }
+        auto downstream = take->output().opposite();
+        if (!downstream) {
+            return false;
+        }
+        if (group.sort_keys().empty() && !group.limit()) {
+            group.sort_keys() = exchange.sort_keys();
+        }
+        group.limit(min_limit(group.limit(), exchange.limit()));
+
+        upstream_take->output().disconnect_all();
+        flatten->output().disconnect_all();
+        offer->input().disconnect_all();
+        take->output().disconnect_all();
+        upstream_take->output() >> *downstream;
+        erase(exchange);
+        return true;
+    }
+
+    [[nodiscard]] static bool is_compatible(plan::group const& upstream, plan::group const& downstream) {
+        if (upstream.group_keys().empty() || upstream.group_keys() != downstream.group_keys()) {
+            return false;
+        }
+        if (upstream.mode() != downstream.mode()) {
+            return false;
+        }
+        if (downstream.sort_keys().empty() || upstream.sort_keys() == downstream.sort_keys()) {
+            return true;
+        }
+        // the upstream only groups the rows
+        return upstream.sort_keys().empty() && !upstream.limit();
+    }
+
+    [[nodiscard]] plan::group& find_group(plan::exchange const& exchange) {
+        auto it = destination_.find(exchange);
+        BOOST_ASSERT(it != destination_.end()); // NOLINT
+        return unsafe_downcast<plan::group>(*it);
+    }
+
+    void erase(plan::exchange const& exchange) {
+        exchanges_.erase(std::addressof(exchange));
+        if (auto it = destination_.find(exchange); it != destination_.end()) {
+            destination_.erase(it);
+        }
+    }
+};
+
+} // namespace
+
+void fuse_exchange_steps(relation::graph_type& source, plan::graph_type& destination) {
+    engine e { source, destination };
+    e.process();
+}
+
+} // namespace yugawara::analyzer::details
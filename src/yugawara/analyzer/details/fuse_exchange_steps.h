@@ -0,0 +1,30 @@
+#pragma once
+
+#include <takatori/relation/graph.h>
+#include <takatori/plan/graph.h>
+
+namespace yugawara::analyzer::details {
+
+/**
+ * @brief fuses redundant exchange steps generated by collect_exchange_steps().
+ * @details This rewrites the following patterns, until no more patterns are found:
+ *
+ *      - `take_flat - offer` over a `forward` exchange without limit: the upstream operators directly
+ *        offer to the downstream exchange, and then the forward exchange is removed
+ *      - `take_group - flatten - offer` over a `group` exchange without group keys and a succeeding `forward`
+ *        exchange with limit: the limit is moved into the group exchange as top-N,
+ *        and then the forward exchange is removed
+ *      - `take_group - flatten - offer` over two `group` exchanges which have the same group keys:
+ *        the downstream exchange is merged into the upstream one
+ *
+ *      This must be called after collect_exchange_steps() and before collect_process_steps(),
+ *      that is, the exchange columns have not been decided yet.
+ * @param source the source intermediate plan, which includes `offer` and `take_*` operators
+ * @param destination the incomplete step plan, which includes the exchange steps
+ * @see collect_exchange_steps()
+ */
+void fuse_exchange_steps(
+        ::takatori::relation::graph_type& source,
+        ::takatori::plan::graph_type& destination);
+
+} // namespace yugawara::analyzer::details
@@ -0,0 +1,334 @@
+#include "hoist_invariant_expressions.h"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include <takatori/scalar/dispatch.h>
+
+#include <takatori/relation/filter.h>
+#include <takatori/relation/project.h>
+#include <takatori/relation/join_find.h>
+#include <takatori/relation/join_scan.h>
+#include <takatori/relation/intermediate/join.h>
+
+#include <takatori/util/clonable.h>
+#include <takatori/util/downcast.h>
+
+#include <yugawara/binding/factory.h>
+#include <yugawara/binding/extract.h>
+
+#include <yugawara/function/declaration.h>
+
+namespace yugawara::analyzer::details {
+
+namespace scalar = ::takatori::scalar;
+namespace relation = ::takatori::relation;
+
+using ::takatori::util::clone_unique;
+using ::takatori::util::unsafe_downcast;
+
+namespace {
+
+class engine {
+public:
+    void process(relation::expression& expr) {
+        switch (expr.kind()) {
+            case relation::filter::tag: {
+                auto&& filter = unsafe_downcast<relation::filter>(expr);
+                process_child(filter.condition(), [&](auto&& replacement) {
+                    filter.condition(std::forward<decltype(replacement)>(replacement));
+                });
+                break;
+            }
+            case relation::project::tag:
+                for (auto&& column : unsafe_downcast<relation::project>(expr).columns()) {
+                    process_child(column.value(), [&](auto&& replacement) {
+                        column.value(std::forward<decltype(replacement)>(replacement));
+                    });
+                }
+                break;
+            case relation::intermediate::join::tag: {
+                auto&& join = unsafe_downcast<relation::intermediate::join>(expr);
+                process_keys(join.lower().keys());
+                process_keys(join.upper().keys());
+                process_condition(join);
+                break;
+            }
+            case relation::join_find::tag: {
+                auto&& join = unsafe_downcast<relation::join_find>(expr);
+                process_keys(join.keys());
+                process_condition(join);
+                break;
+            }
+            case relation::join_scan::tag: {
+                auto&& join = unsafe_downcast<relation::join_scan>(expr);
+                process_keys(join.lower().keys());
+                process_keys(join.upper().keys());
+                process_condition(join);
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    [[nodiscard]] std::vector<invariant_declaration> release() noexcept {
+        return std::move(declarations_);
+    }
+
+    bool dispatch(scalar::expression& expr) {
+        return scalar::dispatch(*this, expr);
+    }
+
+    constexpr bool operator()(scalar::expression&) noexcept {
+        return false;
+    }
+
+    constexpr bool operator()(scalar::immediate&) noexcept {
+        return true;
+    }
+
+    bool operator()(scalar::variable_reference& expr) {
+        return binding::kind_of(expr.variable()) == binding::variable_info_kind::external_variable;
+    }
+
+    bool operator()(scalar::unary& expr) {
+        bool operand = dispatch(expr.operand());
+        if (operand) {
+            return true;
+        }
+        hoist_if(operand, expr.operand(), [&](auto&& replacement) {
+            expr.operand(std::forward<decltype(replacement)>(replacement));
+        });
+        return false;
+    }
+
+    bool operator()(scalar::cast& expr) {
+        return dispatch(expr.operand());
+    }
+
+    bool operator()(scalar::binary& expr) {
+        bool left = dispatch(expr.left());
+        bool right = dispatch(expr.right());
+        if (left && right) {
+            return true;
+        }
+        hoist_if(left, expr.left(), [&](auto&& replacement) {
+            expr.left(std::forward<decltype(replacement)>(replacement));
+        });
+        hoist_if(right, expr.right(), [&](auto&& replacement) {
+            expr.right(std::forward<decltype(replacement)>(replacement));
+        });
+        return false;
+    }
+
+    bool operator()(scalar::compare& expr) {
+        bool left = dispatch(expr.left());
+        bool right = dispatch(expr.right());
+        if (left && right) {
+            return true;
+        }
+        hoist_if(left, expr.left(), [&](auto&& replacement) {
+            expr.left(std::forward<decltype(replacement)>(replacement));
+        });
+        hoist_if(right, expr.right(), [&](auto&& replacement) {
+            expr.right(std::forward<decltype(replacement)>(replacement));
+        });
+        return false;
+    }
+
+    bool operator()(scalar::match& expr) {
+        bool input = dispatch(expr.input());
+        bool pattern = dispatch(expr.pattern());
+        bool escape = dispatch(expr.escape());
+        if (input && pattern && escape) {
+            return true;
+        }
+        hoist_if(input, expr.input(), [&](auto&& replacement) {
+            expr.input(std::forward<decltype(replacement)>(replacement));
+        });
+        hoist_if(pattern, expr.pattern(), [&](auto&& replacement) {
+            expr.pattern(std::forward<decltype(replacement)>(replacement));
+        });
+        hoist_if(escape, expr.escape(), [&](auto&& replacement) {
+            expr.escape(std::forward<decltype(replacement)>(replacement));
+        });
+        return false;
+    }
+
+    bool operator()(scalar::conditional& expr) {
+        std::vector<bool> conditions {};
+        std::vector<bool> bodies {};
+        conditions.reserve(expr.alternatives().size());
+        bodies.reserve(expr.alternatives().size());
+        for (auto&& alternative : expr.alternatives()) {
+            conditions.emplace_back(dispatch(alternative.condition()));
+            bodies.emplace_back(dispatch(alternative.body()));
+        }
+        bool otherwise_invariant = true;
+        if (auto otherwise = expr.default_expression()) {
+            otherwise_invariant = dispatch(*otherwise);
+        }
+        if (otherwise_invariant && all_of(conditions) && all_of(bodies)) {
+            return true;
+        }
+        std::size_t index = 0;
+        for (auto&& alternative : expr.alternatives()) {
+            hoist_if(conditions[index], alternative.condition(), [&](auto&& replacement) {
+                alternative.condition(std::forward<decltype(replacement)>(replacement));
+            });
+            hoist_if(bodies[index], alternative.body(), [&](auto&& replacement) {
+                alternative.body(std::forward<decltype(replacement)>(replacement));
+            });
+            ++index;
+        }
+        if (auto otherwise = expr.default_expression()) {
+            hoist_if(otherwise_invariant, *otherwise, [&](auto&& replacement) {
+                expr.default_expression(std::forward<decltype(replacement)>(replacement));
+            });
+        }
+        return false;
+    }
+
+    bool operator()(scalar::coalesce& expr) {
+        std::vector<bool> invariants {};
+        invariants.reserve(expr.alternatives().size());
+        for (auto&& alternative : expr.alternatives()) {
+            invariants.emplace_back(dispatch(alternative));
+        }
+        if (all_of(invariants)) {
+            return true;
+        }
+        process_list(expr.alternatives(), invariants);
+        return false;
+    }
+
+    bool operator()(scalar::let& expr) {
+        for (auto&& decl : expr.variables()) {
+            process_child(decl.value(), [&](auto&& replacement) {
+                decl.value(std::forward<decltype(replacement)>(replacement));
+            });
+        }
+        process_child(expr.body(), [&](auto&& replacement) {
+            expr.body(std::forward<decltype(replacement)>(replacement));
+        });
+        return false;
+    }
+
+    bool operator()(scalar::function_call& expr) {
+        std::vector<bool> invariants {};
+        invariants.reserve(expr.arguments().size());
+        for (auto&& argument : expr.arguments()) {
+            invariants.emplace_back(dispatch(argument));
+        }
+        if (all_of(invariants) && is_deterministic(expr)) {
+            return true;
+        }
+        process_list(expr.arguments(), invariants);
+        return false;
+    }
+
+private:
+    std::vector<invariant_declaration> declarations_ {};
+
+    template<class Setter>
+    void process_child(scalar::expression& expr, Setter&& setter) {
+        bool invariant = dispatch(expr);
+        hoist_if(invariant, expr, std::forward<Setter>(setter));
+    }
+
+    template<class T>
+    void process_condition(T& expr) {
+        if (auto condition = expr.condition()) {
+            process_child(*condition, [&](auto&& replacement) {
+                expr.condition(std::forward<decltype(replacement)>(replacement));
+            });
+        }
+    }
+
+    template<class Keys>
+    void process_keys(Keys& keys) {
+        for (auto&& key : keys) {
+            process_child(key.value(), [&](auto&& replacement) {
+                key.value(std::forward<decltype(replacement)>(replacement));
+            });
+        }
+    }
+
+    [[nodiscard]] static bool all_of(std::vector<bool> const& flags) noexcept {
+        return std::all_of(flags.begin(), flags.end(), [](bool flag) { return flag; });
+    }
+
+    /**
+     * @brief hoists the invariant elements in the given list.
+     * @param list the target list
+     * @param invariants whether or not each element is invariant
+     */
+    void process_list(
+            ::takatori::tree::tree_element_vector<scalar::expression>& list,
+            std::vector<bool> const& invariants) {
+        std::size_t index = 0;
+        for (auto iter = list.begin(); iter != list.end(); ++iter) {
+            if (invariants[index] && is_target(*iter)) {
+                (void) list.exchange(iter, hoist(*iter));
+            }
+            ++index;
+        }
+    }
+
+    template<class Setter>
+    void hoist_if(bool invariant, scalar::expression const& expr, Setter&& setter) {
+        if (invariant && is_target(expr)) {
+            setter(hoist(expr));
+        }
+    }
+
+    [[nodiscard]] static bool is_deterministic(scalar::function_call const& expr) {
+        // NOTE: we cannot hoist function calls unless they are declared as deterministic
+        if (auto func = binding::extract_if(expr.function())) {
+            return func->features().contains(function::function_feature::deterministic);
+        }
+        return false;
+    }
+
+    [[nodiscard]] static bool is_target(scalar::expression const& expr) {
+        /*
+         * NOTE: the runtime evaluates the hoisted expressions lazily, on their first reference,
+         * so that the expressions which may raise errors are never evaluated if the original operators
+         * did not evaluate them.
+         */
+        // never hoist trivial expressions
+        return expr.kind() != scalar::immediate::tag && expr.kind() != scalar::variable_reference::tag;
+    }
+
+    [[nodiscard]] invariant_declaration const* find(scalar::expression const& expr) const {
+        for (auto&& declaration : declarations_) {
+            if (declaration.value() == expr) {
+                return std::addressof(declaration);
+            }
+        }
+        return nullptr;
+    }
+
+    [[nodiscard]] std::unique_ptr<scalar::expression> hoist(scalar::expression const& expr) {
+        if (auto const* declaration = find(expr)) {
+            return std::make_unique<scalar::variable_reference>(declaration->variable());
+        }
+        auto variable = binding::factory {}.frame_variable("invariant");
+        declarations_.emplace_back(variable, clone_unique(expr));
+        return std::make_unique<scalar::variable_reference>(std::move(variable));
+    }
+};
+
+} // namespace
+
+std::vector<invariant_declaration> hoist_invariant_expressions(relation::graph_type& graph) {
+    engine e {};
+    for (auto&& expr : graph) {
+        e.process(expr);
+    }
+    return e.release();
+}
+
+} // namespace yugawara::analyzer::details
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <vector>
+
+#include <takatori/relation/graph.h>
+
+#include <yugawara/analyzer/invariant_declaration.h>
+
+namespace yugawara::analyzer::details {
+
+/**
+ * @brief hoists row-invariant sub-expressions out of the relational operators.
+ * @details This replaces each maximal sub-expression, which only consists of constants and external variables,
+ *      with a reference to a new frame variable, and then returns the declarations of such variables.
+ *      The equivalent sub-expressions share the same variable.
+ *
+ *      The hoisted sub-expressions may raise errors (e.g. arithmetic operations or casts),
+ *      because the runtime evaluates each declaration lazily on its first reference,
+ *      so that it is never evaluated if the original operator would not evaluate it.
+ *      This only hoists function calls which are declared as function::function_feature::deterministic.
+ * @param graph the target graph
+ * @return the hoisted declarations, which must be evaluated once per statement execution
+ * @see invariant_declaration
+ */
+[[nodiscard]] std::vector<invariant_declaration> hoist_invariant_expressions(::takatori::relation::graph_type& graph);
+
+} // namespace yugawara::analyzer::details
@@ -28,6 +28,16 @@ intermediate_plan_optimizer_options& intermediate_plan_optimizer_options::index_
     return *this;
 }
 
+exchange_column_shape_provider const& intermediate_plan_optimizer_options::exchange_column_shapes() const noexcept {
+    return exchange_column_shapes_;
+}
+
+intermediate_plan_optimizer_options& intermediate_plan_optimizer_options::exchange_column_shapes(
+        exchange_column_shape_provider shapes) {
+    exchange_column_shapes_ = std::move(shapes);
+    return *this;
+}
+
 bool& intermediate_plan_optimizer_options::enable_disjunction_range_hinting() noexcept {
     return enable_disjunction_range_hinting_;
 }
@@ -43,4 +53,53 @@ bool& intermediate_plan_optimizer_options::enable_external_variable_inlining() n
 bool intermediate_plan_optimizer_options::enable_external_variable_inlining() const noexcept {
     return enable_external_variable_inlining_;
 }
+
+bool& intermediate_plan_optimizer_options::enable_projection_pushdown() noexcept {
+    return enable_projection_pushdown_;
+}
+
+bool intermediate_plan_optimizer_options::enable_projection_pushdown() const noexcept {
+    return enable_projection_pushdown_;
+}
+
+std::size_t& intermediate_plan_optimizer_options::broadcast_build_size_limit() noexcept {
+    return broadcast_build_size_limit_;
+}
+
+std::size_t intermediate_plan_optimizer_options::broadcast_build_size_limit() const noexcept {
+    return broadcast_build_size_limit_;
+}
+
+std::size_t& intermediate_plan_optimizer_options::broadcast_fan_out() noexcept {
+    return broadcast_fan_out_;
+}
+
+std::size_t intermediate_plan_optimizer_options::broadcast_fan_out() const noexcept {
+    return broadcast_fan_out_;
+}
+
+std::size_t& intermediate_plan_optimizer_options::broadcast_row_threshold() noexcept {
+    return broadcast_row_threshold_;
+}
+
+std::size_t intermediate_plan_optimizer_options::broadcast_row_threshold() const noexcept {
+    return broadcast_row_threshold_;
+}
+
+bool& intermediate_plan_optimizer_options::enable_common_subexpression_elimination() noexcept {
+    return enable_common_subexpression_elimination_;
+}
+
+bool intermediate_plan_optimizer_options::enable_common_subexpression_elimination() const noexcept {
+    return enable_common_subexpression_elimination_;
+}
+
+bool& intermediate_plan_optimizer_options::enable_invariant_hoisting() noexcept {
+    return enable_invariant_hoisting_;
+}
+
+bool intermediate_plan_optimizer_options::enable_invariant_hoisting() const noexcept {
+    return enable_invariant_hoisting_;
+}
+
 } // namespace yugawara::analyzer::details
@@ -0,0 +1,99 @@
+#include "may_raise_error.h"
+
+#include <takatori/scalar/dispatch.h>
+
+namespace yugawara::analyzer::details {
+
+namespace scalar = ::takatori::scalar;
+
+namespace {
+
+/**
+ * @brief detects whether or not the given expression may raise an error on evaluation.
+ */
+class engine {
+public:
+    bool dispatch(scalar::expression const& expr) {
+        return scalar::dispatch(*this, expr);
+    }
+
+    constexpr bool operator()(scalar::expression const&) noexcept {
+        // NOTE: function calls, pattern matching, extensions, or other unknown expressions
+        return true;
+    }
+
+    constexpr bool operator()(scalar::immediate const&) noexcept {
+        return false;
+    }
+
+    constexpr bool operator()(scalar::variable_reference const&) noexcept {
+        return false;
+    }
+
+    bool operator()(scalar::unary const& expr) {
+        if (expr.operator_kind() == scalar::unary_operator::sign_inversion) {
+            // may overflow
+            return true;
+        }
+        return dispatch(expr.operand());
+    }
+
+    constexpr bool operator()(scalar::cast const&) noexcept {
+        return true;
+    }
+
+    bool operator()(scalar::binary const& expr) {
+        using kind = scalar::binary_operator;
+        switch (expr.operator_kind()) {
+            case kind::conditional_and:
+            case kind::conditional_or:
+                return dispatch(expr.left()) || dispatch(expr.right());
+            default:
+                // may overflow, or divide by zero
+                return true;
+        }
+    }
+
+    bool operator()(scalar::compare const& expr) {
+        return dispatch(expr.left()) || dispatch(expr.right());
+    }
+
+    bool operator()(scalar::conditional const& expr) {
+        for (auto&& alternative : expr.alternatives()) {
+            if (dispatch(alternative.condition()) || dispatch(alternative.body())) {
+                return true;
+            }
+        }
+        if (auto otherwise = expr.default_expression()) {
+            return dispatch(*otherwise);
+        }
+        return false;
+    }
+
+    bool operator()(scalar::coalesce const& expr) {
+        for (auto&& alternative : expr.alternatives()) {
+            if (dispatch(alternative)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool operator()(scalar::let const& expr) {
+        for (auto&& decl : expr.variables()) {
+            if (dispatch(decl.value())) {
+                return true;
+            }
+        }
+        return dispatch(expr.body());
+    }
+};
+
+} // namespace
+
+bool may_raise_error(scalar::expression const& expression) {
+    engine e {};
+    return e.dispatch(expression);
+}
+
+} // namespace yugawara::analyzer::details
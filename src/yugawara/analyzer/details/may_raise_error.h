@@ -0,0 +1,17 @@
+#pragma once
+
+#include <takatori/scalar/expression.h>
+
+namespace yugawara::analyzer::details {
+
+/**
+ * @brief returns whether or not evaluating the given expression may raise an error.
+ * @details This conservatively considers that arithmetic operations, casts, function calls,
+ *      pattern matching and any unknown expressions may raise errors.
+ * @param expression the target expression
+ * @return true if the evaluation may raise an error
+ * @return false if the evaluation never raises errors
+ */
+[[nodiscard]] bool may_raise_error(::takatori::scalar::expression const& expression);
+
+} // namespace yugawara::analyzer::details
@@ -0,0 +1,153 @@
+#include "normalize_comparison.h"
+
+#include <cstdint>
+#include <limits>
+#include <optional>
+
+#include <takatori/type/primitive.h>
+#include <takatori/value/primitive.h>
+
+#include <takatori/scalar/binary.h>
+#include <takatori/scalar/compare.h>
+#include <takatori/scalar/immediate.h>
+#include <takatori/scalar/variable_reference.h>
+
+#include <takatori/util/downcast.h>
+
+namespace yugawara::analyzer::details {
+
+namespace scalar = ::takatori::scalar;
+namespace ttype = ::takatori::type;
+namespace tvalue = ::takatori::value;
+
+using ::takatori::util::ownership_reference;
+using ::takatori::util::unsafe_downcast;
+
+namespace {
+
+[[nodiscard]] std::optional<std::int64_t> integral_constant(scalar::expression const& expression) {
+    if (expression.kind() != scalar::immediate::tag) {
+        return {};
+    }
+    auto&& immediate = unsafe_downcast<scalar::immediate>(expression);
+    auto&& value = immediate.value();
+    if (value.kind() == tvalue::int4::tag && immediate.type().kind() == ttype::int4::tag) {
+        return unsafe_downcast<tvalue::int4>(value).get();
+    }
+    if (value.kind() == tvalue::int8::tag && immediate.type().kind() == ttype::int8::tag) {
+        return unsafe_downcast<tvalue::int8>(value).get();
+    }
+    return {};
+}
+
+[[nodiscard]] std::unique_ptr<scalar::immediate> create_constant(
+        scalar::immediate const& origin,
+        std::int64_t value) {
+    if (origin.value().kind() == tvalue::int4::tag) {
+        if (value < std::numeric_limits<std::int32_t>::min() || value > std::numeric_limits<std::int32_t>::max()) {
+            return {};
+        }
+        return std::make_unique<scalar::immediate>(
+                tvalue::int4 { static_cast<std::int32_t>(value) },
+                ttype::int4 {});
+    }
+    return std::make_unique<scalar::immediate>(
+            tvalue::int8 { value },
+            ttype::int8 {});
+}
+
+} // namespace
+
+bool normalize_comparison(
+        ownership_reference<scalar::expression> expression,
+        integral_variable_predicate const& integral) {
+    auto target = expression.find();
+    if (!target || target->kind() != scalar::compare::tag) {
+        return false;
+    }
+    auto&& compare = unsafe_downcast<scalar::compare>(*target);
+    auto comparator = compare.operator_kind();
+    scalar::expression const* term {};
+    scalar::expression const* constant {};
+    if (integral_constant(compare.right())) {
+        term = std::addressof(compare.left());
+        constant = std::addressof(compare.right());
+    } else if (integral_constant(compare.left())) {
+        term = std::addressof(compare.right());
+        constant = std::addressof(compare.left());
+        comparator = scalar::transpose(comparator);
+    } else {
+        return false;
+    }
+
+    // term = sign * current + offset
+    bool negative = false;
+    std::int64_t offset = 0;
+    bool changed = false;
+    while (term->kind() == scalar::binary::tag) {
+        auto&& binary = unsafe_downcast<scalar::binary>(*term);
+        auto op = binary.operator_kind();
+        if (op != scalar::binary_operator::add && op != scalar::binary_operator::subtract) {
+            break;
+        }
+        scalar::expression const* next {};
+        std::int64_t delta {};
+        if (auto right = integral_constant(binary.right())) {
+            // current +/- c
+            if (op == scalar::binary_operator::subtract && *right == std::numeric_limits<std::int64_t>::min()) {
+                return false;
+            }
+            next = std::addressof(binary.left());
+            delta = op == scalar::binary_operator::add ? *right : -*right;
+        } else if (auto left = integral_constant(binary.left())) {
+            // c +/- current
+            next = std::addressof(binary.right());
+            delta = *left;
+        } else {
+            break;
+        }
+        if (negative && delta == std::numeric_limits<std::int64_t>::min()) {
+            return false;
+        }
+        if (__builtin_add_overflow(offset, negative ? -delta : delta, &offset)) {
+            return false;
+        }
+        if (op == scalar::binary_operator::subtract && next == std::addressof(binary.right())) {
+            negative = !negative;
+        }
+        term = next;
+        changed = true;
+    }
+    if (!changed || term->kind() != scalar::variable_reference::tag) {
+        return false;
+    }
+    auto&& variable = unsafe_downcast<scalar::variable_reference>(*term).variable();
+    if (!integral(variable)) {
+        return false;
+    }
+
+    // sign * variable + offset <op> c  =>  variable <op> c - offset  or  variable <op'> offset - c
+    std::int64_t value {};
+    auto base = *integral_constant(*constant);
+    if (negative) {
+        if (__builtin_sub_overflow(offset, base, &value)) {
+            return false;
+        }
+        comparator = scalar::transpose(comparator);
+    } else {
+        if (__builtin_sub_overflow(base, offset, &value)) {
+            return false;
+        }
+    }
+    auto replacement_constant = create_constant(unsafe_downcast<scalar::immediate>(*constant), value);
+    if (!replacement_constant) {
+        return false;
+    }
+    expression.set(std::make_unique<scalar::compare>(
+            comparator,
+            std::make_unique<scalar::variable_reference>(variable),
+            std::move(replacement_constant)));
+    return true;
+}
+
+} // namespace yugawara::analyzer::details
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <functional>
+
+#include <takatori/descriptor/variable.h>
+#include <takatori/scalar/expression.h>
+#include <takatori/util/ownership_reference.h>
+
+namespace yugawara::analyzer::details {
+
+/**
+ * @brief tests whether or not the given variable always holds an exact integral value.
+ */
+using integral_variable_predicate = std::function<bool(::takatori::descriptor::variable const&)>;
+
+/**
+ * @brief moves integral additions and subtractions out of a comparison with a constant.
+ * @details This rewrites comparisons like `v + c1 > c2` into `v > c2 - c1`,
+ *      so that the comparison can be recognized as a search key term of `v`.
+ *      This only applies to chains of addition and subtraction with integral constants over a single variable,
+ *      and the variable must be accepted by the given predicate;
+ *      otherwise, rounding of approximate numbers may change the result of the comparison.
+ *      This never applies if the computed constant does not fit into the type of the original one.
+ * @param expression the target expression
+ * @param integral the predicate which tests whether or not the variable holds integral values
+ * @return true if the expression was rewritten
+ * @return false otherwise
+ */
+bool normalize_comparison(
+        ::takatori::util::ownership_reference<::takatori::scalar::expression> expression,
+        integral_variable_predicate const& integral);
+
+} // namespace yugawara::analyzer::details
@@ -1,18 +1,32 @@
 #include "push_down_filters.h"
 
+#include <optional>
+
 #include <boost/dynamic_bitset.hpp>
 
+#include <tsl/hopscotch_map.h>
 #include <tsl/hopscotch_set.h>
 
 #include <takatori/scalar/binary.h>
+#include <takatori/scalar/variable_reference.h>
+#include <takatori/type/primitive.h>
 #include <takatori/relation/intermediate/dispatch.h>
 
 #include <takatori/util/assertion.h>
+#include <takatori/util/downcast.h>
 #include <takatori/util/exception.h>
 #include <takatori/util/string_builder.h>
 
+#include <yugawara/binding/extract.h>
+
+#include <yugawara/storage/column.h>
+
 #include "boolean_constants.h"
+#include "classify_expression.h"
 #include "decompose_predicate.h"
+#include "inline_variables.h"
+#include "may_raise_error.h"
+#include "normalize_comparison.h"
 #include "collect_stream_variables.h"
 #include "stream_variable_flow_info.h"
 
@@ -28,6 +42,7 @@ using ::takatori::util::enum_tag_t;
 using ::takatori::util::ownership_reference;
 using ::takatori::util::string_builder;
 using ::takatori::util::throw_exception;
+using ::takatori::util::unsafe_downcast;
 
 namespace {
 
@@ -51,6 +66,10 @@ public:
         return index_;
     }
 
+    [[nodiscard]] scalar::expression const& expression() const noexcept {
+        return *expression_;
+    }
+
     [[nodiscard]] auto& uses() noexcept {
         return uses_;
     }
@@ -118,6 +137,33 @@ private:
     mask_type mask_;
 };
 
+// NOTE: avoid error of Boost polymorphic_allocator, this is equivalent to std::pair
+class buffer_arrival {
+public:
+    using mask_type = task_info::mask_type;
+
+    explicit buffer_arrival(relation::expression::output_port_type& output, mask_type&& mask)
+        : output_(std::addressof(output))
+        , mask_(std::move(mask))
+    {}
+
+    [[nodiscard]] relation::expression::output_port_type& output() noexcept {
+        return *output_;
+    }
+
+    [[nodiscard]] mask_type& mask() noexcept {
+        return mask_;
+    }
+
+    [[nodiscard]] mask_type const& mask() const noexcept {
+        return mask_;
+    }
+
+private:
+    relation::expression::output_port_type* output_;
+    mask_type mask_;
+};
+
 class engine {
 public:
     using mask_type = task_info::mask_type;
@@ -279,14 +325,46 @@ public:
     }
 
     void operator()(relation::project& expr, mask_type&& mask) {
+        // substitute simple projected expressions into the predicates
+        inline_variables substitutions {};
+        substitutions.reserve(expr.columns().size());
+        BOOST_ASSERT(work_.empty()); // NOLINT
+        work_.reserve(expr.columns().size());
         for (auto&& column : expr.columns()) {
-            for (mask_type::size_type i = mask.find_first(); i != mask_type::npos; i = mask.find_next(i)) {
-                auto&& predicate = predicates_[i];
-                if (predicate.use(column.variable())) {
-                    flush(expr.output(), predicate);
-                    mask.reset(i);
+            work_.emplace(column.variable());
+            if (is_substitutable(column.value())) {
+                // NOTE: each column may refer the preceding columns
+                std::unique_ptr<scalar::expression> value = clone_unique(column.value());
+                substitutions.apply(value);
+                substitutions.declare(column.variable(), std::move(value));
+            }
+        }
+        std::unique_ptr<scalar::expression> condition {};
+        for (mask_type::size_type i = mask.find_first(); i != mask_type::npos; i = mask.find_next(i)) {
+            auto&& predicate = predicates_[i];
+            bool use_column = false;
+            for (auto&& use : predicate.uses()) {
+                if (work_.contains(use)) {
+                    use_column = true;
+                    break;
                 }
             }
+            if (!use_column) {
+                continue;
+            }
+            mask.reset(i);
+            if (auto term = substitute(predicate, substitutions, expr.input())) {
+                static_cast<void>(predicate.release());
+                condition = merge_condition(std::move(condition), std::move(term));
+            } else {
+                flush(expr.output(), predicate);
+            }
+        }
+        work_.clear();
+
+        // put the substituted predicates on the input, and then push down them further
+        if (condition && expr.input().opposite()) {
+            insert_filter(*expr.input().opposite(), std::move(condition));
         }
         pass(expr.input(), std::move(mask));
     }
@@ -339,23 +417,67 @@ public:
     }
 
     void operator()(relation::intermediate::union_& expr, mask_type&& mask) {
-        // FIXME: impl
-        // rewrite variables and carry into left or right
-        flush_all(expr.output(), mask);
+        // rewrite variables and carry into both left and right
+        inline_variables left_rewriter {};
+        inline_variables right_rewriter {};
+        left_rewriter.reserve(expr.mappings().size());
+        right_rewriter.reserve(expr.mappings().size());
+        BOOST_ASSERT(work_.empty()); // NOLINT
+        work_.reserve(expr.mappings().size());
+        for (auto&& mapping : expr.mappings()) {
+            // NOTE: mappings which lack either side always yield NULL on the side, we don't rewrite them
+            if (mapping.left() && mapping.right()) {
+                work_.emplace(mapping.destination());
+                left_rewriter.declare(
+                        mapping.destination(),
+                        std::make_unique<scalar::variable_reference>(*mapping.left()));
+                right_rewriter.declare(
+                        mapping.destination(),
+                        std::make_unique<scalar::variable_reference>(*mapping.right()));
+            }
+        }
+        std::unique_ptr<scalar::expression> left_condition {};
+        std::unique_ptr<scalar::expression> right_condition {};
+        for (mask_type::size_type i = mask.find_first(); i != mask_type::npos; i = mask.find_next(i)) {
+            auto&& predicate = predicates_[i];
+            bool rewritable = true;
+            for (auto&& use : predicate.uses()) {
+                if (!work_.contains(use)) {
+                    rewritable = false;
+                    break;
+                }
+            }
+            if (!rewritable) {
+                flush(expr.output(), predicate);
+                continue;
+            }
+            auto left_term = predicate.release();
+            auto right_term = clone_unique(*left_term);
+            left_rewriter.apply(left_term);
+            right_rewriter.apply(right_term);
+            left_condition = merge_condition(std::move(left_condition), std::move(left_term));
+            right_condition = merge_condition(std::move(right_condition), std::move(right_term));
+        }
+        work_.clear();
+        mask.clear();
+
+        // put the rewritten predicates on the individual inputs, and then push down them further
+        if (left_condition && expr.left().opposite()) {
+            insert_filter(*expr.left().opposite(), std::move(left_condition));
+        }
+        if (right_condition && expr.right().opposite()) {
+            insert_filter(*expr.right().opposite(), std::move(right_condition));
+        }
         pass(expr.left(), empty_mask());
         pass(expr.right(), empty_mask());
     }
 
     void operator()(relation::intermediate::intersection& expr, mask_type&& mask) {
-        // FIXME: check for distinct
-        pass(expr.left(), std::move(mask));
-        pass(expr.right(), empty_mask());
+        process_set_operation(expr, std::move(mask));
     }
 
     void operator()(relation::intermediate::difference& expr, mask_type&& mask) {
-        // FIXME: check for distinct
-        pass(expr.left(), std::move(mask));
-        pass(expr.right(), empty_mask());
+        process_set_operation(expr, std::move(mask));
     }
 
     void operator()(relation::emit& expr, mask_type&& mask) {
@@ -372,11 +494,63 @@ public:
         pass(expr.input(), std::move(mask));
     }
 
-    void operator()(relation::buffer& expr, mask_type&&) {
-        throw_exception(std::domain_error(string_builder {}
-                << "unsupported operator: "
-                << expr
-                << string_builder::to_string));
+    void operator()(relation::buffer& expr, mask_type&& mask) {
+        // NOTE: this is scheduled only after predicates arrived from all outputs
+        BOOST_ASSERT(mask.none()); // NOLINT
+        (void) mask;
+        auto arrivals = std::move(buffers_[std::addressof(expr)]);
+        buffers_.erase(std::addressof(expr));
+
+        // move the terms which are common to all outputs below the buffer
+        std::unique_ptr<scalar::expression> condition {};
+        auto&& first = arrivals.front().mask();
+        for (mask_type::size_type i = first.find_first(); i != mask_type::npos; i = first.find_next(i)) {
+            if (!is_common_term(predicates_[i], arrivals)) {
+                continue;
+            }
+            for (auto iter = arrivals.begin() + 1; iter != arrivals.end(); ++iter) {
+                auto j = *find_term(predicates_[i], iter->mask());
+                static_cast<void>(predicates_[j].release());
+                iter->mask().reset(j);
+            }
+            condition = merge_condition(std::move(condition), predicates_[i].release());
+            first.reset(i);
+        }
+
+        // also move the disjunction of the rest terms, but each output keeps them as residual filters
+        bool all_restricted = true;
+        for (auto&& arrival : arrivals) {
+            if (arrival.mask().none()) {
+                all_restricted = false;
+                break;
+            }
+        }
+        if (all_restricted) {
+            std::unique_ptr<scalar::expression> disjunction {};
+            for (auto&& arrival : arrivals) {
+                std::unique_ptr<scalar::expression> conjunction {};
+                auto&& m = arrival.mask();
+                for (mask_type::size_type i = m.find_first(); i != mask_type::npos; i = m.find_next(i)) {
+                    conjunction = merge_condition(std::move(conjunction), clone_unique(predicates_[i].expression()));
+                }
+                if (disjunction) {
+                    disjunction = std::make_unique<scalar::binary>(
+                            scalar::binary_operator::conditional_or,
+                            std::move(disjunction),
+                            std::move(conjunction));
+                } else {
+                    disjunction = std::move(conjunction);
+                }
+            }
+            condition = merge_condition(std::move(condition), std::move(disjunction));
+        }
+        for (auto&& arrival : arrivals) {
+            flush_all(arrival.output(), arrival.mask());
+        }
+        if (condition && expr.input().opposite()) {
+            insert_filter(*expr.input().opposite(), std::move(condition));
+        }
+        pass(expr.input(), empty_mask());
     }
 
     void operator()(relation::intermediate::extension& expr, mask_type&& mask) {
@@ -396,6 +570,7 @@ private:
             descriptor::variable,
             std::hash<descriptor::variable>,
             std::equal_to<>> work_;
+    ::tsl::hopscotch_map<relation::buffer const*, std::vector<buffer_arrival>> buffers_;
 
 
     void schedule(relation::expression& expr, mask_type&& mask) {
@@ -411,9 +586,9 @@ private:
         }
         auto&& next = upstream.opposite()->owner();
 
-        // NOTE: always flush all predicates before buffer operators, and never process them
+        // NOTE: buffer operators are processed after predicates arrived from all their outputs
         if (next.kind() == relation::buffer::tag) {
-            flush_all(*upstream.opposite(), mask);
+            arrive(unsafe_downcast<relation::buffer>(next), *upstream.opposite(), std::move(mask));
             return;
         }
 
@@ -421,6 +596,40 @@ private:
         schedule(next, std::move(mask));
     }
 
+    void arrive(relation::buffer& expr, relation::expression::output_port_type& output, mask_type&& mask) {
+        auto&& arrivals = buffers_[std::addressof(expr)];
+        arrivals.emplace_back(output, std::move(mask));
+        std::size_t connected = 0;
+        for (auto&& port : expr.output_ports()) {
+            if (port.opposite()) {
+                ++connected;
+            }
+        }
+        if (arrivals.size() >= connected) {
+            schedule(expr, empty_mask());
+        }
+    }
+
+    [[nodiscard]] std::optional<mask_type::size_type> find_term(
+            predicate_info const& predicate,
+            mask_type const& mask) const {
+        for (mask_type::size_type i = mask.find_first(); i != mask_type::npos; i = mask.find_next(i)) {
+            if (predicates_[i].expression() == predicate.expression()) {
+                return i;
+            }
+        }
+        return {};
+    }
+
+    [[nodiscard]] bool is_common_term(predicate_info const& predicate, std::vector<buffer_arrival> const& arrivals) const {
+        for (auto iter = arrivals.begin() + 1; iter != arrivals.end(); ++iter) { // NOLINT(*-use-anyofallof)
+            if (!find_term(predicate, iter->mask())) {
+                return false;
+            }
+        }
+        return true;
+    }
+
     mask_type empty_mask() const {
         return mask_type {};
     }
@@ -436,13 +645,29 @@ private:
     }
 
     void flush(relation::expression::output_port_type& upstream, predicate_info& predicate) {
-        auto&& selection = graph_.emplace<relation::filter>(predicate.release());
+        insert_filter(upstream, predicate.release());
+    }
+
+    void insert_filter(relation::expression::output_port_type& upstream, std::unique_ptr<scalar::expression> condition) {
+        auto&& selection = graph_.emplace<relation::filter>(std::move(condition));
         auto&& downstream = *upstream.opposite();
         upstream.disconnect_from(downstream);
         selection.input().connect_to(upstream);
         selection.output().connect_to(downstream);
     }
 
+    [[nodiscard]] static std::unique_ptr<scalar::expression> merge_condition(
+            std::unique_ptr<scalar::expression> current,
+            std::unique_ptr<scalar::expression> term) {
+        if (!current) {
+            return term;
+        }
+        return std::make_unique<scalar::binary>(
+                scalar::binary_operator::conditional_and,
+                std::move(current),
+                std::move(term));
+    }
+
     void flush_copy(relation::expression::output_port_type& upstream, predicate_info& predicate) {
         predicate.add_count();
         flush(upstream, predicate);
@@ -492,6 +717,120 @@ private:
         return result;
     }
 
+    [[nodiscard]] static bool is_substitutable(scalar::expression const& expr) {
+        auto classes = classify_expression(expr);
+        if (classes.contains(expression_class::variable_declaration)) {
+            return false;
+        }
+        return classes.contains(expression_class::small);
+    }
+
+    [[nodiscard]] std::unique_ptr<scalar::expression> substitute(
+            predicate_info const& predicate,
+            inline_variables const& substitutions,
+            relation::expression::input_port_type const& input) {
+        if (substitutions.empty()) {
+            return {};
+        }
+        auto result = clone_unique(predicate.expression());
+        substitutions.apply(result);
+        normalize_comparison(result, [&](descriptor::variable const& variable) {
+            return is_integral(variable, input);
+        });
+
+        // NOTE: the predicate may be evaluated for rows which never reach the projection
+        if (may_raise_error(*result)) {
+            return {};
+        }
+        bool rest = false;
+        collect_stream_variables(*result, [&](descriptor::variable const& v) {
+            if (work_.contains(v)) {
+                rest = true;
+            }
+        });
+        if (rest) {
+            return {};
+        }
+        return result;
+    }
+
+    [[nodiscard]] bool is_integral(
+            descriptor::variable const& variable,
+            relation::expression::input_port_type const& input) {
+        auto entry = flow_info_.find(variable, input);
+        if (!entry) {
+            return false;
+        }
+        auto declaration = entry->find(variable);
+        if (!declaration) {
+            return false;
+        }
+        if (declaration->kind() == relation::scan::tag) {
+            return is_integral_column(unsafe_downcast<relation::scan>(*declaration).columns(), variable);
+        }
+        if (declaration->kind() == relation::find::tag) {
+            return is_integral_column(unsafe_downcast<relation::find>(*declaration).columns(), variable);
+        }
+        return false;
+    }
+
+    template<class Columns>
+    [[nodiscard]] static bool is_integral_column(Columns const& columns, descriptor::variable const& variable) {
+        for (auto&& column : columns) {
+            if (column.destination() != variable) {
+                continue;
+            }
+            if (auto source = binding::extract_if<storage::column>(column.source())) {
+                auto kind = source->type().kind();
+                return kind == ::takatori::type::int4::tag || kind == ::takatori::type::int8::tag;
+            }
+            return false;
+        }
+        return false;
+    }
+
+    template<class Expr>
+    void process_set_operation(Expr& expr, mask_type&& mask) {
+        /*
+         * The output rows come from the left input, so that all predicates can be carried into the left.
+         * Rows in the same group have the same key values, then predicates only using the group keys
+         * are constant in each group regardless of the set quantifier, and we can also put them into the right.
+         */
+        inline_variables right_rewriter {};
+        right_rewriter.reserve(expr.group_key_pairs().size());
+        BOOST_ASSERT(work_.empty()); // NOLINT
+        work_.reserve(expr.group_key_pairs().size());
+        for (auto&& pair : expr.group_key_pairs()) {
+            work_.emplace(pair.left());
+            right_rewriter.declare(pair.left(), std::make_unique<scalar::variable_reference>(pair.right()));
+        }
+        std::unique_ptr<scalar::expression> right_condition {};
+        for (mask_type::size_type i = mask.find_first(); i != mask_type::npos; i = mask.find_next(i)) {
+            auto&& predicate = predicates_[i];
+            bool key_only = true;
+            for (auto&& use : predicate.uses()) {
+                if (!work_.contains(use)) {
+                    key_only = false;
+                    break;
+                }
+            }
+            if (key_only) {
+                auto term = clone_unique(predicate.expression());
+                right_rewriter.apply(term);
+                right_condition = merge_condition(std::move(right_condition), std::move(term));
+            } else if (expr.quantifier() == relation::set_quantifier::distinct) {
+                // the representative row of each group may change, put a copy of selection
+                flush_copy(expr.output(), predicate);
+            }
+        }
+        work_.clear();
+        if (right_condition && expr.right().opposite()) {
+            insert_filter(*expr.right().opposite(), std::move(right_condition));
+        }
+        pass(expr.left(), std::move(mask));
+        pass(expr.right(), empty_mask());
+    }
+
     template<class Expr>
     void process_distinct_like(Expr& expr, mask_type&& mask) {
         // check if each term only use the distinct group key
@@ -7,6 +7,8 @@ namespace yugawara::analyzer::details {
 /**
  * @brief places `filter` operators to upstream.
  * @details This sometimes merges or decomposes predicates into join like operations.
+ *      For `buffer` operators, this places predicates common to all outputs, and the disjunction of the rest
+ *      predicates on individual outputs, below the buffer.
  * @param graph the target graph
  */
 void push_down_selections(::takatori::relation::graph_type& graph);
@@ -0,0 +1,300 @@
+#include "push_down_projections.h"
+
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+#include <tsl/hopscotch_set.h>
+
+#include <takatori/descriptor/variable.h>
+#include <takatori/relation/project.h>
+#include <takatori/relation/join_find.h>
+#include <takatori/relation/join_scan.h>
+#include <takatori/relation/intermediate/join.h>
+
+#include <takatori/util/downcast.h>
+
+#include "collect_stream_variables.h"
+#include "may_raise_error.h"
+#include "remove_orphaned_elements.h"
+#include "stream_variable_flow_info.h"
+
+namespace yugawara::analyzer::details {
+
+namespace descriptor = ::takatori::descriptor;
+namespace relation = ::takatori::relation;
+
+using ::takatori::util::unsafe_downcast;
+
+namespace {
+
+using variable_set = ::tsl::hopscotch_set<
+        descriptor::variable,
+        std::hash<descriptor::variable>,
+        std::equal_to<>>;
+
+class engine {
+public:
+    explicit engine(relation::graph_type& graph) noexcept :
+        graph_ { graph }
+    {}
+
+    void process() {
+        // process from upstream, to move the dependent projections together
+        std::vector<relation::project*> projections {};
+        relation::sort_from_upstream(graph_, [&](relation::expression& expr) {
+            if (expr.kind() == relation::project::tag) {
+                projections.emplace_back(std::addressof(unsafe_downcast<relation::project>(expr)));
+            }
+        });
+        for (auto* projection : projections) {
+            push_down(*projection);
+        }
+        bool merged = false;
+        for (auto* projection : projections) {
+            merged |= merge_upstream(*projection);
+        }
+        if (merged) {
+            remove_orphaned_elements(graph_);
+        }
+    }
+
+private:
+    relation::graph_type& graph_;
+    stream_variable_flow_info flow_info_ {};
+    variable_set uses_ {};
+
+    void push_down(relation::project& expr) {
+        if (expr.columns().size() != 1) {
+            return;
+        }
+        uses_.clear();
+        collect_stream_variables(expr.columns()[0].value(), [&](descriptor::variable const& variable) {
+            uses_.emplace(variable);
+        });
+        if (uses_.empty()) {
+            // row-invariant values just increase the data size
+            return;
+        }
+        if (auto destination = find_destination(expr, may_raise_error(expr.columns()[0].value()))) {
+            move(expr, *destination);
+        }
+    }
+
+    /**
+     * @brief returns the input port where the given projection should be placed.
+     * @param expr the target projection
+     * @param raise_error whether or not the projected value may raise an error
+     * @return the destination input port
+     * @return nullptr if there is no suitable join input
+     */
+    [[nodiscard]] relation::expression::input_port_type* find_destination(
+            relation::project& expr,
+            bool raise_error) {
+        relation::expression::input_port_type* current = std::addressof(expr.input());
+        bool across_join = false;
+        while (true) {
+            auto upstream = current->opposite();
+            if (!upstream) {
+                break;
+            }
+            auto&& next = upstream->owner();
+            if (next.kind() == relation::project::tag) {
+                auto&& projection = unsafe_downcast<relation::project>(next);
+                if (defines(projection)) {
+                    break;
+                }
+                current = std::addressof(projection.input());
+                continue;
+            }
+            if (next.kind() == relation::join_find::tag) {
+                auto&& join = unsafe_downcast<relation::join_find>(next);
+                auto* input = find_input(join.operator_kind(), join.left(), nullptr, raise_error);
+                if (input == nullptr) {
+                    break;
+                }
+                current = input;
+                continue;
+            }
+            if (next.kind() == relation::join_scan::tag) {
+                auto&& join = unsafe_downcast<relation::join_scan>(next);
+                auto* input = find_input(join.operator_kind(), join.left(), nullptr, raise_error);
+                if (input == nullptr) {
+                    break;
+                }
+                current = input;
+                continue;
+            }
+            if (next.kind() == relation::intermediate::join::tag) {
+                auto&& join = unsafe_downcast<relation::intermediate::join>(next);
+                auto* input = find_input(
+                        join.operator_kind(),
+                        join.left(),
+                        std::addressof(join.right()),
+                        raise_error);
+                if (input != nullptr) {
+                    current = input;
+                    across_join = true;
+                    continue;
+                }
+            }
+            // NOTE: never move across filters, to keep the number of evaluations
+            break;
+        }
+        if (!across_join) {
+            return nullptr;
+        }
+        return current;
+    }
+
+    /**
+     * @brief returns the join input which provides all sources of the projection.
+     * @param kind the join kind
+     * @param left the left input
+     * @param right the right input, or nullptr if it is not a stream
+     * @param raise_error whether or not the projected value may raise an error
+     * @return the join input
+     * @return nullptr if the projection cannot be moved into the join inputs
+     */
+    [[nodiscard]] relation::expression::input_port_type* find_input(
+            relation::join_kind kind,
+            relation::expression::input_port_type& left,
+            relation::expression::input_port_type* right,
+            bool raise_error) {
+        if (accepts_left(kind, raise_error) && available(left)) {
+            return std::addressof(left);
+        }
+        if (right != nullptr && accepts_right(kind, raise_error) && available(*right)) {
+            return right;
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief returns whether or not the projection can be moved into the left input of the join.
+     * @details The projection must not be moved into the null-supplying side,
+     *      because the join output would have NULL instead of the projected value for the unmatched rows.
+     *      The other joins which may discard rows of the input are acceptable only if the projection never
+     *      raises errors, because the moved projection may be evaluated for the discarded rows.
+     * @param kind the join kind
+     * @param raise_error whether or not the projected value may raise an error
+     * @return true if it is acceptable
+     * @return false otherwise
+     */
+    [[nodiscard]] static bool accepts_left(relation::join_kind kind, bool raise_error) noexcept {
+        using join_kind = relation::join_kind;
+        switch (kind) {
+            case join_kind::left_outer:
+            case join_kind::left_outer_at_most_one:
+                // passes through all left input rows
+                return true;
+
+            case join_kind::inner:
+            case join_kind::semi:
+            case join_kind::anti:
+                return !raise_error;
+
+            case join_kind::full_outer:
+                return false;
+        }
+        std::abort();
+    }
+
+    /// @copydoc accepts_left()
+    [[nodiscard]] static bool accepts_right(relation::join_kind kind, bool raise_error) noexcept {
+        using join_kind = relation::join_kind;
+        switch (kind) {
+            case join_kind::inner:
+                return !raise_error;
+
+            case join_kind::left_outer:
+            case join_kind::left_outer_at_most_one:
+            case join_kind::full_outer:
+            case join_kind::semi:
+            case join_kind::anti:
+                // null-supplying side, or never appears in the output
+                return false;
+        }
+        std::abort();
+    }
+
+    [[nodiscard]] bool defines(relation::project const& expr) const {
+        for (auto&& column : expr.columns()) { // NOLINT(*-use-anyofallof)
+            if (uses_.contains(column.variable())) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    [[nodiscard]] bool available(relation::expression::input_port_type const& port) {
+        for (auto&& use : uses_) { // NOLINT(*-use-anyofallof)
+            if (!flow_info_.find(use, port)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void move(relation::project& expr, relation::expression::input_port_type& destination) {
+        /*
+         * before:
+         *  upstream -- expr -- downstream
+         *  ... -- destination
+         *
+         * after:
+         *  upstream -- downstream
+         *  ... -- expr -- destination
+         */
+        detach(expr);
+        if (auto downstream = destination.reconnect_to(expr.input())) {
+            expr.output().connect_to(*downstream);
+        }
+
+        // NOTE: the stream variable declarations have been changed
+        flow_info_.clear();
+    }
+
+    static void detach(relation::project& expr) {
+        auto upstream = expr.input().opposite();
+        auto downstream = expr.output().opposite();
+        expr.input().disconnect_all();
+        expr.output().disconnect_all();
+        if (upstream && downstream) {
+            upstream->connect_to(*downstream);
+        }
+    }
+
+    bool merge_upstream(relation::project& expr) {
+        auto upstream = expr.input().opposite();
+        if (!upstream || upstream->owner().kind() != relation::project::tag) {
+            return false;
+        }
+        auto&& target = unsafe_downcast<relation::project>(upstream->owner());
+        uses_.clear();
+        for (auto&& column : expr.columns()) {
+            collect_stream_variables(column.value(), [&](descriptor::variable const& variable) {
+                uses_.emplace(variable);
+            });
+        }
+        if (defines(target)) {
+            return false;
+        }
+        auto&& columns = target.columns();
+        for (auto&& column : expr.columns()) {
+            columns.emplace_back(std::move(column.variable()), column.release_value());
+        }
+        expr.columns().clear();
+        detach(expr);
+        return true;
+    }
+};
+
+} // namespace
+
+void push_down_projections(relation::graph_type& graph) {
+    engine e { graph };
+    e.process();
+}
+
+} // namespace yugawara::analyzer::details
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <takatori/relation/graph.h>
+
+namespace yugawara::analyzer::details {
+
+/**
+ * @brief places single column `project` operators to upstream across join operations.
+ * @details This moves each `project` operator into an input of the nearest upstream join operation,
+ *      if its value only refers the stream variables from the input.
+ *      Then the runtime can drop the source columns of the projection before exchanging data for the join.
+ *
+ *      This never moves `project` operators into the null-supplying inputs of outer joins.
+ *      The values which may raise errors are only moved into the left input of left outer joins,
+ *      which passes through all of its rows, because other joins may discard some input rows,
+ *      and then the moved projection may be evaluated for such rows.
+ *      Similarly, this never moves `project` operators across `filter` operators.
+ *
+ *      Finally, this merges the each adjacent `project` operators, if the downstream one does not refer
+ *      the columns of the upstream one.
+ * @param graph the target graph
+ * @see decompose_projections()
+ */
+void push_down_projections(::takatori::relation::graph_type& graph);
+
+} // namespace yugawara::analyzer::details
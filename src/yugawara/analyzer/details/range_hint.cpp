@@ -28,14 +28,25 @@ namespace {
 } // namespace
 
 void range_hint_entry::intersect_lower(::takatori::scalar::immediate const& value, bool inclusive) {
+    if (accept_intersect_lower(value, inclusive)) {
+        lower_value_ = clone_unique(value);
+    }
+}
+
+void range_hint_entry::intersect_lower(immediate_type value, bool inclusive) {
+    if (accept_intersect_lower(*value, inclusive)) {
+        lower_value_ = std::move(value);
+    }
+}
+
+bool range_hint_entry::accept_intersect_lower(::takatori::scalar::immediate const& value, bool inclusive) {
     if (lower_type_ == range_hint_type::infinity) {
         lower_type_ = inclusive ? range_hint_type::inclusive : range_hint_type::exclusive;
-        lower_value_ = clone_unique(value);
-        return;
+        return true;
     }
     if (!std::holds_alternative<immediate_type>(lower_value_)) {
         // keep the host variable
-        return;
+        return false;
     }
     auto&& existing = std::get<immediate_type>(lower_value_);
     auto result = compare_immediate(*existing, value);
@@ -43,24 +54,24 @@ void range_hint_entry::intersect_lower(::takatori::scalar::immediate const& valu
     // try to shrink column value range about lower bound ..
     if (result == compare_result::undefined) {
         // keep the original
-        return;
+        return false;
     }
     if (result == compare_result::equal) {
         // current == incoming < column -> may change inclusiveness
         if (lower_type_ == range_hint_type::inclusive && !inclusive) {
             // current <= column && value < column -> make exclusive
             lower_type_ = range_hint_type::exclusive;
-            lower_value_ = clone_unique(value);
+            return true;
         }
-        return;
+        return false;
     }
     if (result == compare_result::less) {
         // current < incoming -> shrink bound
         lower_type_ = inclusive ? range_hint_type::inclusive : range_hint_type::exclusive;
-        lower_value_ = clone_unique(value);
-        return;
+        return true;
     }
     // current > incoming -> keep the current
+    return false;
 }
 
 void range_hint_entry::intersect_lower(variable_type const& value, bool inclusive) {
@@ -82,14 +93,25 @@ void range_hint_entry::intersect_lower(variable_type const& value, bool inclusiv
 }
 
 void range_hint_entry::intersect_upper(::takatori::scalar::immediate const& value, bool inclusive) {
+    if (accept_intersect_upper(value, inclusive)) {
+        upper_value_ = clone_unique(value);
+    }
+}
+
+void range_hint_entry::intersect_upper(immediate_type value, bool inclusive) {
+    if (accept_intersect_upper(*value, inclusive)) {
+        upper_value_ = std::move(value);
+    }
+}
+
+bool range_hint_entry::accept_intersect_upper(::takatori::scalar::immediate const& value, bool inclusive) {
     if (upper_type_ == range_hint_type::infinity) {
         upper_type_ = inclusive ? range_hint_type::inclusive : range_hint_type::exclusive;
-        upper_value_ = clone_unique(value);
-        return;
+        return true;
     }
     if (!std::holds_alternative<immediate_type>(upper_value_)) {
         // keep the host variable
-        return;
+        return false;
     }
     auto&& existing = std::get<immediate_type>(upper_value_);
     auto result = compare_immediate(*existing, value);
@@ -97,24 +119,24 @@ void range_hint_entry::intersect_upper(::takatori::scalar::immediate const& valu
     // try to shrink column value range about upper bound ..
     if (result == compare_result::undefined) {
         // keep the original
-        return;
+        return false;
     }
     if (result == compare_result::equal) {
         // current == incoming > column -> may change inclusiveness
         if (upper_type_ == range_hint_type::inclusive && !inclusive) {
             // current >= column && value > column -> make exclusive
             upper_type_ = range_hint_type::exclusive;
-            upper_value_ = clone_unique(value);
+            return true;
         }
-        return;
+        return false;
     }
     if (result == compare_result::less) {
         // current < incoming -> keep the current
-        return;
+        return false;
     }
     // current > incoming -> shrink bound
     upper_type_ = inclusive ? range_hint_type::inclusive : range_hint_type::exclusive;
-    upper_value_ = clone_unique(value);
+    return true;
 }
 
 void range_hint_entry::intersect_upper(variable_type const& value, bool inclusive) {
@@ -135,15 +157,27 @@ void range_hint_entry::intersect_upper(variable_type const& value, bool inclusiv
     }
 }
 
-void range_hint_entry::union_lower(takatori::scalar::immediate const& value, bool inclusive) {
+void range_hint_entry::union_lower(::takatori::scalar::immediate const& value, bool inclusive) {
+    if (accept_union_lower(value, inclusive)) {
+        lower_value_ = clone_unique(value);
+    }
+}
+
+void range_hint_entry::union_lower(immediate_type value, bool inclusive) {
+    if (accept_union_lower(*value, inclusive)) {
+        lower_value_ = std::move(value);
+    }
+}
+
+bool range_hint_entry::accept_union_lower(::takatori::scalar::immediate const& value, bool inclusive) {
     if (lower_type_ == range_hint_type::infinity) {
-        return;
+        return false;
     }
     if (!std::holds_alternative<immediate_type>(lower_value_)) {
         // different bound values are not comparable -> make infinity
         lower_type_ = range_hint_type::infinity;
         lower_value_ = {};
-        return;
+        return false;
     }
 
     auto&& existing = std::get<immediate_type>(lower_value_);
@@ -154,24 +188,24 @@ void range_hint_entry::union_lower(takatori::scalar::immediate const& value, boo
         // not comparable -> make infinity
         lower_type_ = range_hint_type::infinity;
         lower_value_ = {};
-        return;
+        return false;
     }
     if (result == compare_result::equal) {
         // existing == incoming -> may change inclusiveness
         if (lower_type_ == range_hint_type::exclusive && inclusive) {
             // existing < column || incoming <= column -> make inclusive
             lower_type_ = range_hint_type::inclusive;
-            lower_value_ = clone_unique(value);
+            return true;
         }
-        return;
+        return false;
     }
     if (result == compare_result::less) {
         // existing < incoming -> keep the current
-        return;
+        return false;
     }
     // existing > incoming -> cover bound
     lower_type_ = inclusive ? range_hint_type::inclusive : range_hint_type::exclusive;
-    lower_value_ = clone_unique(value);
+    return true;
 }
 
 void range_hint_entry::union_lower(variable_type const& value, bool inclusive) {
@@ -199,15 +233,27 @@ void range_hint_entry::union_lower(variable_type const& value, bool inclusive) {
     }
 }
 
-void range_hint_entry::union_upper(takatori::scalar::immediate const& value, bool inclusive) {
+void range_hint_entry::union_upper(::takatori::scalar::immediate const& value, bool inclusive) {
+    if (accept_union_upper(value, inclusive)) {
+        upper_value_ = clone_unique(value);
+    }
+}
+
+void range_hint_entry::union_upper(immediate_type value, bool inclusive) {
+    if (accept_union_upper(*value, inclusive)) {
+        upper_value_ = std::move(value);
+    }
+}
+
+bool range_hint_entry::accept_union_upper(::takatori::scalar::immediate const& value, bool inclusive) {
     if (upper_type_ == range_hint_type::infinity) {
-        return;
+        return false;
     }
     if (!std::holds_alternative<immediate_type>(upper_value_)) {
         // different bound values are not comparable -> make infinity
         upper_type_ = range_hint_type::infinity;
         upper_value_ = {};
-        return;
+        return false;
     }
     auto&& existing = std::get<immediate_type>(upper_value_);
     auto result = compare_immediate(*existing, value);
@@ -217,24 +263,24 @@ void range_hint_entry::union_upper(takatori::scalar::immediate const& value, boo
         // not comparable -> make infinity
         upper_type_ = range_hint_type::infinity;
         upper_value_ = {};
-        return;
+        return false;
     }
     if (result == compare_result::equal) {
         // existing == incoming -> may change inclusiveness
         if (upper_type_ == range_hint_type::exclusive && inclusive) {
             // existing > column || incoming >= column -> make inclusive
             upper_type_ = range_hint_type::inclusive;
-            upper_value_ = clone_unique(value);
+            return true;
         }
-        return;
+        return false;
     }
     if (result == compare_result::less) {
         // existing < incoming -> cover bound
         upper_type_ = inclusive ? range_hint_type::inclusive : range_hint_type::exclusive;
-        upper_value_ = clone_unique(value);
-        return;
+        return true;
     }
     // existing > incoming -> keep the current
+    return false;
 }
 
 void range_hint_entry::union_upper(variable_type const& value, bool inclusive) {
@@ -297,7 +343,7 @@ void range_hint_entry::intersect_lower(range_hint_type type, value_type value) {
     if (type == range_hint_type::infinity) {
         // do nothing
     } else if (std::holds_alternative<immediate_type>(value)) {
-        intersect_lower(*std::get<immediate_type>(value), type == range_hint_type::inclusive);
+        intersect_lower(std::move(std::get<immediate_type>(value)), type == range_hint_type::inclusive);
     } else {
         intersect_lower(std::get<variable_type>(value), type == range_hint_type::inclusive);
     }
@@ -307,7 +353,7 @@ void range_hint_entry::intersect_upper(range_hint_type type, value_type value) {
     if (type == range_hint_type::infinity) {
         // do nothing
     } else if (std::holds_alternative<immediate_type>(value)) {
-        intersect_upper(*std::get<immediate_type>(value), type == range_hint_type::inclusive);
+        intersect_upper(std::move(std::get<immediate_type>(value)), type == range_hint_type::inclusive);
         return;
     } else {
         intersect_upper(std::get<variable_type>(value), type == range_hint_type::inclusive);
@@ -319,7 +365,7 @@ void range_hint_entry::union_lower(range_hint_type type, value_type value) {
         lower_type_ = range_hint_type::infinity;
         lower_value_ = {};
     } else if (std::holds_alternative<immediate_type>(value)) {
-        union_lower(*std::get<immediate_type>(value), type == range_hint_type::inclusive);
+        union_lower(std::move(std::get<immediate_type>(value)), type == range_hint_type::inclusive);
     } else {
         union_lower(std::get<variable_type>(value), type == range_hint_type::inclusive);
     }
@@ -330,7 +376,7 @@ void range_hint_entry::union_upper(range_hint_type type, value_type value) {
         upper_type_ = range_hint_type::infinity;
         upper_value_ = {};
     } else if (std::holds_alternative<immediate_type>(value)) {
-        union_upper(*std::get<immediate_type>(value), type == range_hint_type::inclusive);
+        union_upper(std::move(std::get<immediate_type>(value)), type == range_hint_type::inclusive);
     } else {
         union_upper(std::get<variable_type>(value), type == range_hint_type::inclusive);
     }
@@ -36,6 +36,14 @@ public:
      */
     void intersect_lower(::takatori::scalar::immediate const& value, bool inclusive);
 
+    /**
+     * @brief intersects a lower bound value.
+     * @details This takes over the given value instead of copying it, if it becomes the new bound.
+     * @param value the value
+     * @param inclusive whether the bound is inclusive
+     */
+    void intersect_lower(immediate_type value, bool inclusive);
+
     /**
      * @brief intersects a lower bound value.
      * @param value the value
@@ -50,6 +58,14 @@ public:
      */
     void intersect_upper(::takatori::scalar::immediate const& value, bool inclusive);
 
+    /**
+     * @brief intersects an upper bound value.
+     * @details This takes over the given value instead of copying it, if it becomes the new bound.
+     * @param value the value
+     * @param inclusive whether the bound is inclusive
+     */
+    void intersect_upper(immediate_type value, bool inclusive);
+
     /**
      * @brief intersects an upper bound value.
      * @param value the value
@@ -64,6 +80,14 @@ public:
      */
     void union_lower(::takatori::scalar::immediate const& value, bool inclusive);
 
+    /**
+     * @brief unifies a lower bound value.
+     * @details This takes over the given value instead of copying it, if it becomes the new bound.
+     * @param value the value
+     * @param inclusive whether the bound is inclusive
+     */
+    void union_lower(immediate_type value, bool inclusive);
+
     /**
      * @brief unifies a lower bound value.
      * @param value the value
@@ -78,6 +102,14 @@ public:
      */
     void union_upper(::takatori::scalar::immediate const& value, bool inclusive);
 
+    /**
+     * @brief unifies an upper bound value.
+     * @details This takes over the given value instead of copying it, if it becomes the new bound.
+     * @param value the value
+     * @param inclusive whether the bound is inclusive
+     */
+    void union_upper(immediate_type value, bool inclusive);
+
     /**
      * @brief unifies an upper bound value.
      * @param value the value
@@ -144,6 +176,12 @@ private:
 
     void union_lower(range_hint_type type, value_type value);
     void union_upper(range_hint_type type, value_type value);
+
+    // returns whether or not the given value becomes the new bound
+    [[nodiscard]] bool accept_intersect_lower(::takatori::scalar::immediate const& value, bool inclusive);
+    [[nodiscard]] bool accept_intersect_upper(::takatori::scalar::immediate const& value, bool inclusive);
+    [[nodiscard]] bool accept_union_lower(::takatori::scalar::immediate const& value, bool inclusive);
+    [[nodiscard]] bool accept_union_upper(::takatori::scalar::immediate const& value, bool inclusive);
 };
 
 class range_hint_map {
@@ -0,0 +1,298 @@
+#include "reorder_conditions.h"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include <takatori/scalar/dispatch.h>
+
+#include <takatori/relation/filter.h>
+#include <takatori/relation/join_find.h>
+#include <takatori/relation/join_scan.h>
+#include <takatori/relation/intermediate/join.h>
+
+#include <takatori/util/downcast.h>
+#include <takatori/util/ownership_reference.h>
+
+#include "classify_expression.h"
+#include "may_raise_error.h"
+
+namespace yugawara::analyzer::details {
+
+namespace scalar = ::takatori::scalar;
+namespace relation = ::takatori::relation;
+
+using ::takatori::util::ownership_reference;
+using ::takatori::util::unsafe_downcast;
+
+using expression_ref = ownership_reference<scalar::expression>;
+
+namespace {
+
+constexpr double default_selectivity = 0.5;
+
+/**
+ * @brief estimates the ratio of rows which satisfy the given predicate.
+ */
+class selectivity_estimator {
+public:
+    double dispatch(scalar::expression const& expr) {
+        return scalar::dispatch(*this, expr);
+    }
+
+    constexpr double operator()(scalar::expression const&) noexcept {
+        return default_selectivity;
+    }
+
+    double operator()(scalar::compare const& expr) noexcept {
+        using kind = scalar::comparison_operator;
+        switch (expr.operator_kind()) {
+            case kind::equal: return 0.1;
+            case kind::not_equal: return 0.9;
+            default: return 1.0 / 3.0;
+        }
+    }
+
+    double operator()(scalar::unary const& expr) {
+        using kind = scalar::unary_operator;
+        switch (expr.operator_kind()) {
+            case kind::conditional_not: return 1.0 - dispatch(expr.operand());
+            case kind::is_null: return 0.1;
+            default: return default_selectivity;
+        }
+    }
+
+    double operator()(scalar::binary const& expr) {
+        using kind = scalar::binary_operator;
+        switch (expr.operator_kind()) {
+            case kind::conditional_and:
+                return dispatch(expr.left()) * dispatch(expr.right());
+            case kind::conditional_or:
+                return std::min(1.0, dispatch(expr.left()) + dispatch(expr.right()));
+            default:
+                return default_selectivity;
+        }
+    }
+
+    constexpr double operator()(scalar::match const&) noexcept {
+        return 0.25;
+    }
+};
+
+[[nodiscard]] double estimate_cost(scalar::expression const& expr) {
+    auto classes = classify_expression(expr);
+    if (classes.contains(expression_class::unknown) || classes.contains(expression_class::function_call)) {
+        return 16.0;
+    }
+    if (!classes.contains(expression_class::small)) {
+        return 8.0;
+    }
+    if (!classes.contains(expression_class::trivial)) {
+        return 2.0;
+    }
+    return 1.0;
+}
+
+[[nodiscard]] bool is_conjunction(scalar::expression const& expr) {
+    if (expr.kind() != scalar::binary::tag) {
+        return false;
+    }
+    auto&& binary = unsafe_downcast<scalar::binary>(expr);
+    return binary.operator_kind() == scalar::binary_operator::conditional_and;
+}
+
+class engine {
+public:
+    /**
+     * @brief reorders conjunctive terms in the given conditions.
+     * @param conditions the conjunctive conditions, which are evaluated from the front
+     */
+    void process(std::vector<expression_ref>& conditions) {
+        for (auto&& condition : conditions) {
+            std::size_t count = terms_.size();
+            collect(*condition);
+            counts_.emplace_back(terms_.size() - count);
+        }
+        if (terms_.size() >= 2 && schedule()) {
+            rebuild(conditions);
+        }
+        terms_.clear();
+        counts_.clear();
+        order_.clear();
+        released_.clear();
+    }
+
+private:
+    struct term {
+        scalar::expression const* expression;
+        double rank;
+        bool safe;
+    };
+
+    std::vector<term> terms_ {};
+    std::vector<std::size_t> counts_ {};
+    std::vector<std::size_t> order_ {};
+    std::vector<std::unique_ptr<scalar::expression>> released_ {};
+
+    void collect(scalar::expression const& expr) {
+        if (is_conjunction(expr)) {
+            auto&& binary = unsafe_downcast<scalar::binary>(expr);
+            collect(binary.left());
+            collect(binary.right());
+            return;
+        }
+        selectivity_estimator selectivity {};
+        terms_.emplace_back(term {
+                std::addressof(expr),
+                (1.0 - selectivity.dispatch(expr)) / estimate_cost(expr),
+                !may_raise_error(expr),
+        });
+    }
+
+    /**
+     * @brief computes the evaluation order of the collected terms.
+     * @details The terms with greater rank are evaluated earlier, but the terms which may raise errors are never
+     *      evaluated before any terms which precede them in the original order.
+     * @return true if the order was changed
+     * @return false otherwise
+     */
+    bool schedule() {
+        std::vector<std::size_t> safe_terms {};
+        std::vector<std::size_t> unsafe_terms {};
+        for (std::size_t i = 0, n = terms_.size(); i < n; ++i) {
+            if (terms_[i].safe) {
+                safe_terms.emplace_back(i);
+            } else {
+                unsafe_terms.emplace_back(i);
+            }
+        }
+        std::stable_sort(safe_terms.begin(), safe_terms.end(), [&](std::size_t a, std::size_t b) {
+            return terms_[a].rank > terms_[b].rank;
+        });
+
+        std::vector<bool> scheduled(terms_.size(), false);
+        std::size_t first_pending = 0;
+        auto safe_iter = safe_terms.begin();
+        auto unsafe_iter = unsafe_terms.begin();
+        order_.reserve(terms_.size());
+        while (order_.size() < terms_.size()) {
+            std::size_t next {};
+            bool unsafe_ready = unsafe_iter != unsafe_terms.end() && *unsafe_iter == first_pending;
+            if (unsafe_ready && (safe_iter == safe_terms.end() || terms_[*unsafe_iter].rank >= terms_[*safe_iter].rank)) {
+                next = *unsafe_iter;
+                ++unsafe_iter;
+            } else {
+                next = *safe_iter;
+                ++safe_iter;
+            }
+            order_.emplace_back(next);
+            scheduled[next] = true;
+            while (first_pending < terms_.size() && scheduled[first_pending]) {
+                ++first_pending;
+            }
+        }
+
+        for (std::size_t i = 0, n = order_.size(); i < n; ++i) {
+            if (order_[i] != i) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void release(std::unique_ptr<scalar::expression> expr) {
+        if (is_conjunction(*expr)) {
+            auto&& binary = unsafe_downcast<scalar::binary>(*expr);
+            release(binary.release_left());
+            release(binary.release_right());
+            return;
+        }
+        released_.emplace_back(std::move(expr));
+    }
+
+    void rebuild(std::vector<expression_ref>& conditions) {
+        released_.reserve(terms_.size());
+        for (auto&& condition : conditions) {
+            release(condition.exchange({}));
+        }
+        auto iter = order_.begin();
+        for (std::size_t i = 0, n = conditions.size(); i < n; ++i) {
+            std::unique_ptr<scalar::expression> result {};
+            for (std::size_t j = 0; j < counts_[i]; ++j) {
+                auto&& term = released_[*iter];
+                ++iter;
+                if (result) {
+                    result = std::make_unique<scalar::binary>(
+                            scalar::binary_operator::conditional_and,
+                            std::move(result),
+                            std::move(term));
+                } else {
+                    result = std::move(term);
+                }
+            }
+            conditions[i] = std::move(result);
+        }
+    }
+};
+
+[[nodiscard]] relation::filter* find_upstream_filter(relation::filter& expr) {
+    if (auto upstream = expr.input().opposite();
+            upstream && upstream->owner().kind() == relation::filter::tag) {
+        return std::addressof(unsafe_downcast<relation::filter>(upstream->owner()));
+    }
+    return nullptr;
+}
+
+[[nodiscard]] relation::filter* find_downstream_filter(relation::filter& expr) {
+    if (auto downstream = expr.output().opposite();
+            downstream && downstream->owner().kind() == relation::filter::tag) {
+        return std::addressof(unsafe_downcast<relation::filter>(downstream->owner()));
+    }
+    return nullptr;
+}
+
+template<class T>
+void process_optional_condition(engine& e, std::vector<expression_ref>& conditions, T& expr) {
+    if (expr.condition()) {
+        conditions.emplace_back(expr.ownership_condition());
+        e.process(conditions);
+        conditions.clear();
+    }
+}
+
+} // namespace
+
+void reorder_conditions(relation::graph_type& graph) {
+    engine e {};
+    std::vector<expression_ref> conditions {};
+    for (auto&& expr : graph) {
+        switch (expr.kind()) {
+            case relation::filter::tag: {
+                auto* filter = std::addressof(unsafe_downcast<relation::filter>(expr));
+                if (find_upstream_filter(*filter) != nullptr) {
+                    // not the head of adjacent filters
+                    break;
+                }
+                for (auto* current = filter; current != nullptr; current = find_downstream_filter(*current)) {
+                    conditions.emplace_back(current->ownership_condition());
+                }
+                e.process(conditions);
+                conditions.clear();
+                break;
+            }
+            case relation::intermediate::join::tag:
+                process_optional_condition(e, conditions, unsafe_downcast<relation::intermediate::join>(expr));
+                break;
+            case relation::join_find::tag:
+                process_optional_condition(e, conditions, unsafe_downcast<relation::join_find>(expr));
+                break;
+            case relation::join_scan::tag:
+                process_optional_condition(e, conditions, unsafe_downcast<relation::join_scan>(expr));
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+} // namespace yugawara::analyzer::details
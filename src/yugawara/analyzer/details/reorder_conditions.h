@@ -0,0 +1,20 @@
+#pragma once
+
+#include <takatori/relation/graph.h>
+
+namespace yugawara::analyzer::details {
+
+/**
+ * @brief reorders conjunctive terms in filters and join conditions.
+ * @details The runtime evaluates conjunctive terms from left to right, and stops evaluation if the former is false.
+ *      This moves the cheaper and more selective terms to the former, to reduce evaluation of the latter terms.
+ *
+ *      This handles each sequence of adjacent filter operators as a single conjunction.
+ *
+ *      This never moves terms which may raise errors (e.g. arithmetic, casts or function calls)
+ *      in front of any other terms, because the former terms may guard them.
+ * @param graph the target graph
+ */
+void reorder_conditions(::takatori::relation::graph_type& graph);
+
+} // namespace yugawara::analyzer::details
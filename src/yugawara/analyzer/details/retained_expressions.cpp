@@ -0,0 +1,94 @@
+#include "retained_expressions.h"
+
+#include <takatori/scalar/binary.h>
+#include <takatori/scalar/compare.h>
+#include <takatori/scalar/unary.h>
+
+#include <takatori/util/downcast.h>
+
+namespace yugawara::analyzer::details {
+
+namespace scalar = ::takatori::scalar;
+
+using ::takatori::util::unsafe_downcast;
+
+namespace {
+
+[[nodiscard]] std::size_t operator_of(scalar::expression const& expression) noexcept {
+    switch (expression.kind()) {
+        case scalar::unary::tag:
+            return static_cast<std::size_t>(unsafe_downcast<scalar::unary>(expression).operator_kind());
+        case scalar::binary::tag:
+            return static_cast<std::size_t>(unsafe_downcast<scalar::binary>(expression).operator_kind());
+        case scalar::compare::tag:
+            return static_cast<std::size_t>(unsafe_downcast<scalar::compare>(expression).operator_kind());
+        default:
+            return 0;
+    }
+}
+
+} // namespace
+
+void retained_expressions::retain(expression_mapping const& mapping) {
+    mapping.each([&](scalar::expression const& expression, expression_resolution const& resolution) {
+        auto operands = operands_of(expression);
+        if (operands[0] == nullptr || !resolution) {
+            return;
+        }
+        entry retained {
+                expression.kind(),
+                operator_of(expression),
+                {},
+                resolution,
+        };
+        for (std::size_t i = 0; i < max_operands; ++i) {
+            if (operands[i] == nullptr) {
+                continue;
+            }
+            auto&& operand = mapping.find(*operands[i]);
+            if (!operand) {
+                // operand types are not known
+                return;
+            }
+            retained.operand_types[i] = operand.shared_type();
+        }
+        entries_.insert_or_assign(std::addressof(expression), std::move(retained));
+    });
+}
+
+retained_expressions::entry const* retained_expressions::find(scalar::expression const& expression) const {
+    auto const* found = entries_.find(std::addressof(expression));
+    if (found == nullptr
+            || found->kind != expression.kind()
+            || found->operator_kind != operator_of(expression)) {
+        return nullptr;
+    }
+    return found;
+}
+
+bool retained_expressions::empty() const noexcept {
+    return entries_.size() == 0;
+}
+
+void retained_expressions::clear() noexcept {
+    entries_.clear();
+}
+
+retained_expressions::operand_list retained_expressions::operands_of(scalar::expression const& expression) noexcept {
+    switch (expression.kind()) {
+        case scalar::unary::tag:
+            return { std::addressof(unsafe_downcast<scalar::unary>(expression).operand()), nullptr };
+        case scalar::binary::tag: {
+            auto&& binary = unsafe_downcast<scalar::binary>(expression);
+            return { std::addressof(binary.left()), std::addressof(binary.right()) };
+        }
+        case scalar::compare::tag: {
+            auto&& compare = unsafe_downcast<scalar::compare>(expression);
+            return { std::addressof(compare.left()), std::addressof(compare.right()) };
+        }
+        default:
+            return {};
+    }
+}
+
+} // namespace yugawara::analyzer::details
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <array>
+#include <memory>
+
+#include <cstddef>
+
+#include <takatori/scalar/expression.h>
+#include <takatori/type/data.h>
+
+#include <yugawara/analyzer/expression_mapping.h>
+#include <yugawara/analyzer/expression_resolution.h>
+#include <yugawara/analyzer/details/resolution_table.h>
+
+namespace yugawara::analyzer::details {
+
+/**
+ * @brief retains resolutions of compound expressions between two analyses.
+ * @details The result type of unary, binary and comparison expressions only depends on their operator and
+ *      the types of their operands. This keeps them for individual expressions, and the next analysis can reuse
+ *      the resolution if the expression has the same operator and operand types as before.
+ */
+class retained_expressions {
+public:
+    /// @brief the maximum number of operands.
+    static constexpr std::size_t max_operands = 2;
+
+    /// @brief the operand list type, which may contain nullptr for absent operands.
+    using operand_list = std::array<::takatori::scalar::expression const*, max_operands>;
+
+    /// @brief the retained information of individual expressions.
+    struct entry {
+        /// @brief the expression kind.
+        ::takatori::scalar::expression_kind kind {};
+        /// @brief the underlying value of the operator kind.
+        std::size_t operator_kind {};
+        /// @brief the operand types.
+        std::array<std::shared_ptr<::takatori::type::data const>, max_operands> operand_types {};
+        /// @brief the retained resolution.
+        expression_resolution resolution {};
+    };
+
+    /**
+     * @brief retains resolutions of the compound expressions in the given mapping.
+     * @details The expressions in the mapping must be alive while calling this.
+     * @param mapping the source mapping
+     */
+    void retain(expression_mapping const& mapping);
+
+    /**
+     * @brief returns the retained entry for the expression.
+     * @param expression the target expression
+     * @return the retained entry, only if it has the same expression kind and operator
+     * @return nullptr otherwise
+     */
+    [[nodiscard]] entry const* find(::takatori::scalar::expression const& expression) const;
+
+    /**
+     * @brief returns whether or not this is empty.
+     * @return true if there are no retained entries
+     * @return false otherwise
+     */
+    [[nodiscard]] bool empty() const noexcept;
+
+    /**
+     * @brief removes all retained entries.
+     */
+    void clear() noexcept;
+
+    /**
+     * @brief returns the operands of the compound expression.
+     * @param expression the target expression
+     * @return the operands
+     * @return all nullptr if the expression is not a target of this
+     */
+    [[nodiscard]] static operand_list operands_of(::takatori::scalar::expression const& expression) noexcept;
+
+private:
+    resolution_table<::takatori::scalar::expression const*, entry> entries_ {};
+};
+
+} // namespace yugawara::analyzer::details
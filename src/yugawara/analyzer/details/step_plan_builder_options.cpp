@@ -54,4 +54,12 @@ void step_plan_builder_options::add(::takatori::relation::intermediate::aggregat
     return {};
 }
 
+bool& step_plan_builder_options::enable_exchange_fusion() noexcept {
+    return enable_exchange_fusion_;
+}
+
+bool step_plan_builder_options::enable_exchange_fusion() const noexcept {
+    return enable_exchange_fusion_;
+}
+
 } // namespace yugawara::analyzer::details
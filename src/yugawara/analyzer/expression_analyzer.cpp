@@ -1,6 +1,7 @@
 #include <yugawara/analyzer/expression_analyzer.h>
 
 #include <functional>
+#include <optional>
 #include <utility>
 #include <vector>
 
@@ -44,6 +45,8 @@
 
 #include <yugawara/storage/table.h>
 
+#include "details/retained_expressions.h"
+
 namespace yugawara::analyzer {
 
 namespace descriptor = ::takatori::descriptor;
@@ -93,18 +96,23 @@ public:
             bool validate,
             bool allow_unresolved,
             std::vector<diagnostic_type>& diagnostics,
-            type::repository& repo) noexcept
+            type::repository& repo,
+            optional_ptr<details::retained_expressions const> retained) noexcept
         : ana_(ana)
         , diagnostics_(diagnostics)
         , repo_(repo)
         , validate_(validate)
         , allow_unresolved_(allow_unresolved)
+        , retained_(retained)
     {}
 
     type_ptr resolve(scalar::expression const& expression) {
         if (auto resolved = ana_.expressions().find(expression)) {
             return resolved.shared_type();
         }
+        if (auto const* retained = find_retained(expression)) {
+            return ana_.expressions().bind(expression, retained->resolution, true).shared_type();
+        }
         auto resolved = scalar::dispatch(*this, expression);
         ana_.expressions().bind(expression, resolved, true);
         return resolved;
@@ -1669,15 +1677,36 @@ public:
                 if (!column || column->optional_owner().get() != std::addressof(table)) {
                     throw_exception(std::domain_error("invalid table column"));
                 }
+                // NOTE: most of elements are literals with the same type in each column,
+                // we only validate the first one of them
+                std::optional<::takatori::value::value_kind> valid_kind {};
+                ::takatori::type::data const* valid_type {};
                 for (auto&& tuple : stmt.tuples()) {
-                    auto&& src = resolve(tuple.elements()[i]);
+                    auto&& element = tuple.elements()[i];
+                    scalar::immediate const* literal {};
+                    if (element.kind() == scalar::immediate::tag) {
+                        literal = std::addressof(unsafe_downcast<scalar::immediate>(element));
+                        if (auto type = literal->optional_type();
+                                valid_type != nullptr
+                                && type
+                                && literal->value().kind() == valid_kind
+                                && *type == *valid_type) {
+                            ana_.expressions().bind(element, literal->shared_type(), true);
+                            continue;
+                        }
+                    }
+                    auto diagnostics_before = diagnostics_.size();
+                    auto&& src = resolve(element);
                     if (!is_unresolved_or_error(src)) {
                         auto t = type::is_assignment_convertible(*src, column->type());
                         if (t != ternary::yes) {
                             report(code::inconsistent_type,
-                                    tuple.elements()[i].region(),
+                                    element.region(),
                                     *src,
                                     { type::category_of(column->type()) });
+                        } else if (literal != nullptr && diagnostics_.size() == diagnostics_before) {
+                            valid_kind = literal->value().kind();
+                            valid_type = std::addressof(literal->type());
                         }
                     }
                 }
@@ -1871,6 +1900,30 @@ private:
     type::repository& repo_;
     bool validate_;
     bool allow_unresolved_;
+    optional_ptr<details::retained_expressions const> retained_;
+
+    [[nodiscard]] details::retained_expressions::entry const* find_retained(scalar::expression const& expression) {
+        if (!retained_) {
+            return nullptr;
+        }
+        auto const* retained = retained_->find(expression);
+        if (retained == nullptr) {
+            return nullptr;
+        }
+        // the result type only depends on the operator and the operand types
+        auto operands = details::retained_expressions::operands_of(expression);
+        for (std::size_t i = 0; i < operands.size(); ++i) {
+            if (operands[i] == nullptr) {
+                continue;
+            }
+            auto type = resolve(*operands[i]);
+            auto&& expected = retained->operand_types[i];
+            if (!type || !expected || *type != *expected) {
+                return nullptr;
+            }
+        }
+        return retained;
+    }
 
     static ::takatori::document::region const& extract_region(scalar::expression const& expr) noexcept {
         return expr.region();
@@ -2451,6 +2504,17 @@ expression_analyzer& expression_analyzer::allow_unresolved(bool allow) noexcept
     return *this;
 }
 
+void expression_analyzer::retain_expressions() {
+    auto retained = std::make_shared<details::retained_expressions>();
+    retained->retain(*expressions_);
+    expressions_->clear();
+    retained_ = std::move(retained);
+}
+
+void expression_analyzer::clear_retained_expressions() noexcept {
+    retained_.reset();
+}
+
 std::shared_ptr<::takatori::type::data const> expression_analyzer::inspect(
         variable_resolution const& resolution) const {
     using kind = variable_resolution::kind_type;
@@ -2494,7 +2558,7 @@ std::shared_ptr<::takatori::type::data const> expression_analyzer::resolve(
         scalar::expression const& expression,
         bool validate,
         type::repository& repo) {
-    return engine { *this, validate, allow_unresolved_, diagnostics_, repo }
+    return engine { *this, validate, allow_unresolved_, diagnostics_, repo, retained_.get() }
         .resolve(expression);
 }
 
@@ -2503,7 +2567,7 @@ bool expression_analyzer::resolve(
         bool validate,
         bool recursive,
         type::repository& repo) {
-    return engine { *this, validate, allow_unresolved_, diagnostics_, repo }
+    return engine { *this, validate, allow_unresolved_, diagnostics_, repo, retained_.get() }
         .resolve(expression, recursive);
 }
 
@@ -2511,7 +2575,7 @@ bool expression_analyzer::resolve(
         relation::graph_type const& graph,
         bool validate,
         type::repository& repo) {
-    return engine { *this, validate, allow_unresolved_, diagnostics_, repo }
+    return engine { *this, validate, allow_unresolved_, diagnostics_, repo, retained_.get() }
             .resolve(graph);
 }
 
@@ -2520,7 +2584,7 @@ bool expression_analyzer::resolve(
         bool validate,
         bool recursive,
         type::repository& repo) {
-    return engine { *this, validate, allow_unresolved_, diagnostics_, repo }
+    return engine { *this, validate, allow_unresolved_, diagnostics_, repo, retained_.get() }
             .resolve(step, recursive);
 }
 
@@ -2528,7 +2592,7 @@ bool expression_analyzer::resolve(
         plan::graph_type const& graph,
         bool validate,
         type::repository& repo) {
-    return engine { *this, validate, allow_unresolved_, diagnostics_, repo }
+    return engine { *this, validate, allow_unresolved_, diagnostics_, repo, retained_.get() }
             .resolve(graph);
 }
 
@@ -2536,7 +2600,7 @@ bool expression_analyzer::resolve(
         statement::statement const& statement,
         bool validate,
         type::repository& repo) {
-    return engine { *this, validate, allow_unresolved_, diagnostics_, repo }
+    return engine { *this, validate, allow_unresolved_, diagnostics_, repo, retained_.get() }
             .resolve(statement);
 }
 
@@ -9,17 +9,17 @@ using ::takatori::util::throw_exception;
 
 expression_resolution const& expression_mapping::find(
         ::takatori::scalar::expression const& expression) const {
-    if (auto it = mapping_.find(std::addressof(expression)); it != mapping_.end()) {
-        return it->second;
+    if (auto const* found = mapping_.find(std::addressof(expression))) {
+        return *found;
     }
     static expression_resolution const empty;
     return empty;
 }
 
 void expression_mapping::each(consumer_type const& consumer) const {
-    for (auto&& [expression, resolution] : mapping_) {
+    mapping_.each([&](auto const* expression, auto const& resolution) {
         consumer(*expression, resolution);
-    }
+    });
 }
 
 expression_resolution const& expression_mapping::bind(
@@ -27,15 +27,13 @@ expression_resolution const& expression_mapping::bind(
         expression_resolution resolution,
         bool overwrite) {
     if (overwrite) {
-        auto [iter, success] = mapping_.insert_or_assign(std::addressof(expression), std::move(resolution));
-        (void) success;
-        return iter->second;
+        return mapping_.insert_or_assign(std::addressof(expression), std::move(resolution));
     }
-    auto [iter, success] = mapping_.try_emplace(std::addressof(expression), std::move(resolution));
-    if (!success && resolution != iter->second) { // NOLINT: try_emplace does not actually move if not success
+    auto [stored, success] = mapping_.try_emplace(std::addressof(expression), std::move(resolution));
+    if (!success && resolution != stored) { // NOLINT: try_emplace does not actually move if not success
         throw_exception(std::domain_error("rebind different type for the expression"));
     }
-    return iter->second;
+    return stored;
 }
 
 void expression_mapping::unbind(takatori::scalar::expression const& expression) {
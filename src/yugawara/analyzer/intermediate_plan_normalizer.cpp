@@ -1,6 +1,8 @@
 #include <yugawara/analyzer/intermediate_plan_normalizer.h>
 
 #include "details/expand_subquery.h"
+#include "details/balance_expressions.h"
+#include "details/collapse_in_list.h"
 
 namespace yugawara::analyzer {
 
@@ -10,6 +12,8 @@ std::vector<intermediate_plan_normalizer::diagnostic_type> intermediate_plan_nor
     if (auto diagnostics = details::expand_subquery(graph); !diagnostics.empty()) {
         return diagnostics;
     }
+    details::balance_expressions(graph);
+    details::collapse_in_list(graph);
     return {};
 }
 
@@ -6,14 +6,21 @@
 #include "details/remove_unused_stream_variables.h"
 #include "details/remove_redundant_conditions.h"
 #include "details/push_down_filters.h"
+#include "details/push_down_projections.h"
 #include "details/flow_volume_info.h"
+#include "details/estimate_flow_volume.h"
 #include "details/rewrite_join.h"
 #include "details/collect_join_keys.h"
 #include "details/rewrite_scan.h"
 #include "details/collect_local_variables.h"
+#include "details/decompose_projections.h"
 #include "details/decompose_prefix_match.h"
 #include "details/decompose_filter.h"
 #include "details/decompose_disjunction_range.h"
+#include "details/reorder_conditions.h"
+#include "details/hoist_invariant_expressions.h"
+#include "details/eliminate_common_subexpressions.h"
+#include "details/balance_expressions.h"
 
 namespace yugawara::analyzer {
 
@@ -45,7 +52,9 @@ void intermediate_plan_optimizer::operator()(::takatori::relation::graph_type& g
     details::remove_variable_aliases(
             graph,
             options_.enable_external_variable_inlining());
-    // details::decompose_projections(graph);
+    if (options_.enable_projection_pushdown()) {
+        details::decompose_projections(graph);
+    }
     details::remove_unused_stream_variables(graph);
     details::collect_local_variables(
             graph,
@@ -57,8 +66,13 @@ void intermediate_plan_optimizer::operator()(::takatori::relation::graph_type& g
     }
 
     details::push_down_selections(graph);
+    // push_down_selections() rebuilds conjunctions as left-deep chains
+    details::balance_expressions(graph);
     // FIXME: auto flow_volume = details::reorder_join(...);
-    details::flow_volume_info flow_volume {};
+    auto flow_volume = details::estimate_flow_volume(
+            graph,
+            options_.index_estimator(),
+            options_.exchange_column_shapes());
     if (options_.runtime_features().contains(runtime_feature::index_join)) {
         details::rewrite_join(
                 graph,
@@ -69,9 +83,28 @@ void intermediate_plan_optimizer::operator()(::takatori::relation::graph_type& g
     details::collect_join_keys(
             graph,
             flow_volume,
-            compute_join_keys_features(options_.runtime_features()));
+            compute_join_keys_features(options_.runtime_features()),
+            options_.broadcast_build_size_limit(),
+            options_.broadcast_fan_out(),
+            options_.broadcast_row_threshold());
+    if (options_.enable_projection_pushdown()) {
+        details::push_down_projections(graph);
+    }
     details::rewrite_scan(graph, options_.index_estimator());
     details::remove_redundant_conditions(graph);
+    if (options_.enable_common_subexpression_elimination()) {
+        details::eliminate_common_subexpressions(graph);
+    }
+    invariants_.clear();
+    if (options_.enable_invariant_hoisting()) {
+        invariants_ = details::hoist_invariant_expressions(graph);
+    }
+    details::reorder_conditions(graph);
+    details::balance_expressions(graph);
+}
+
+std::vector<invariant_declaration>& intermediate_plan_optimizer::invariants() noexcept {
+    return invariants_;
 }
 
 } // namespace yugawara::analyzer
@@ -0,0 +1,33 @@
+#include <yugawara/analyzer/invariant_declaration.h>
+
+namespace yugawara::analyzer {
+
+namespace descriptor = ::takatori::descriptor;
+namespace scalar = ::takatori::scalar;
+
+invariant_declaration::invariant_declaration(
+        descriptor::variable variable,
+        std::unique_ptr<scalar::expression> value) noexcept :
+    variable_ { std::move(variable) },
+    value_ { std::move(value) }
+{}
+
+descriptor::variable const& invariant_declaration::variable() const noexcept {
+    return variable_;
+}
+
+scalar::expression& invariant_declaration::value() noexcept {
+    return *value_;
+}
+
+scalar::expression const& invariant_declaration::value() const noexcept {
+    return *value_;
+}
+
+std::ostream& operator<<(std::ostream& out, invariant_declaration const& value) {
+    return out << "invariant_declaration("
+            << "variable=" << value.variable() << ", "
+            << "value=" << value.value() << ")";
+}
+
+} // namespace yugawara::analyzer
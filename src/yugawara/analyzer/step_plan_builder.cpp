@@ -6,6 +6,7 @@
 
 #include "details/collect_process_steps.h"
 #include "details/collect_exchange_steps.h"
+#include "details/fuse_exchange_steps.h"
 #include "details/collect_step_relations.h"
 
 #include "details/collect_exchange_columns.h"
@@ -34,6 +35,11 @@ plan::graph_type step_plan_builder::operator()(relation::graph_type&& graph) con
     // collect exchange steps and rewrite to step plan operators
     details::collect_exchange_steps(graph, result, options_);
 
+    // remove redundant exchange steps
+    if (options_.enable_exchange_fusion()) {
+        details::fuse_exchange_steps(graph, result);
+    }
+
     // collect process steps
     details::collect_process_steps(std::move(graph), result);
 
@@ -0,0 +1,297 @@
+#include <yugawara/analyzer/step_plan_scheduler.h>
+
+#include <algorithm>
+#include <optional>
+#include <unordered_set>
+#include <vector>
+
+#include <takatori/relation/find.h>
+#include <takatori/relation/scan.h>
+#include <takatori/relation/values.h>
+#include <takatori/relation/step/take_flat.h>
+#include <takatori/relation/step/take_group.h>
+#include <takatori/relation/step/take_cogroup.h>
+
+#include <takatori/plan/exchange.h>
+
+#include <takatori/util/downcast.h>
+
+#include <yugawara/binding/extract.h>
+
+#include <yugawara/storage/column.h>
+#include <yugawara/storage/index.h>
+
+namespace yugawara::analyzer {
+
+namespace descriptor = ::takatori::descriptor;
+namespace relation = ::takatori::relation;
+namespace plan = ::takatori::plan;
+
+using ::takatori::relation::endpoint_kind;
+using ::takatori::util::optional_ptr;
+using ::takatori::util::unsafe_downcast;
+
+namespace {
+
+using size_type = step_plan_scheduler::size_type;
+
+struct process_info {
+    size_type level { 0 };
+    std::optional<size_type> rows {};
+    size_type weight { 0 };
+    optional_ptr<plan::process const> heaviest_upstream {};
+};
+
+[[nodiscard]] bool is_inclusive(endpoint_kind kind) noexcept {
+    return kind == endpoint_kind::inclusive || kind == endpoint_kind::prefixed_inclusive;
+}
+
+[[nodiscard]] std::optional<size_type> add(std::optional<size_type> a, std::optional<size_type> b) noexcept {
+    if (!a || !b) {
+        return {};
+    }
+    return *a + *b;
+}
+
+class engine {
+public:
+    explicit engine(optional_ptr<index_estimator const> index_estimator) noexcept :
+        index_estimator_ { index_estimator }
+    {}
+
+    void schedule(plan::graph_type const& graph) {
+        // enumerate processes from upstream
+        std::vector<plan::process const*> work {};
+        for (auto&& step : graph) {
+            if (step.kind() == plan::process::tag) {
+                auto&& process = unsafe_downcast<plan::process>(step);
+                if (process.upstreams().empty()) {
+                    work.emplace_back(std::addressof(process));
+                }
+            }
+        }
+        while (!work.empty()) {
+            auto const* process = work.back();
+            work.pop_back();
+            inspect(*process);
+            for (auto&& exchange : process->downstreams()) {
+                for (auto&& downstream : exchange.downstreams()) {
+                    if (is_ready(downstream)) {
+                        work.emplace_back(std::addressof(downstream));
+                    }
+                }
+            }
+        }
+    }
+
+    [[nodiscard]] std::unordered_map<plan::process const*, process_info> const& infos() const noexcept {
+        return infos_;
+    }
+
+private:
+    optional_ptr<index_estimator const> index_estimator_;
+    std::unordered_map<plan::process const*, process_info> infos_ {};
+    std::vector<index_estimator::search_key> search_keys_ {};
+    std::vector<index_estimator::column_ref> values_ {};
+
+    [[nodiscard]] bool is_ready(plan::process const& process) const {
+        if (infos_.find(std::addressof(process)) != infos_.end()) {
+            return false;
+        }
+        for (auto&& exchange : process.upstreams()) { // NOLINT(*-use-anyofallof)
+            for (auto&& upstream : exchange.upstreams()) {
+                if (infos_.find(std::addressof(upstream)) == infos_.end()) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    void inspect(plan::process const& process) {
+        process_info info {};
+        for (auto&& exchange : process.upstreams()) {
+            for (auto&& upstream : exchange.upstreams()) {
+                auto&& upstream_info = infos_.at(std::addressof(upstream));
+                info.level = std::max(info.level, upstream_info.level + 1);
+                if (!info.heaviest_upstream || upstream_info.weight > info.weight) {
+                    info.heaviest_upstream = upstream;
+                    info.weight = upstream_info.weight;
+                }
+            }
+        }
+        info.rows = estimate(process);
+        info.weight += std::max<size_type>(info.rows.value_or(1), 1);
+        infos_.emplace(std::addressof(process), info);
+    }
+
+    [[nodiscard]] std::optional<size_type> estimate(plan::process const& process) {
+        for (auto&& expr : process.operators()) {
+            switch (expr.kind()) {
+                case relation::scan::tag:
+                    return estimate(unsafe_downcast<relation::scan>(expr));
+                case relation::find::tag:
+                    return estimate(unsafe_downcast<relation::find>(expr));
+                case relation::values::tag:
+                    return unsafe_downcast<relation::values>(expr).rows().size();
+                case relation::step::take_flat::tag:
+                    return estimate(unsafe_downcast<relation::step::take_flat>(expr).source());
+                case relation::step::take_group::tag:
+                    return estimate(unsafe_downcast<relation::step::take_group>(expr).source());
+                case relation::step::take_cogroup::tag: {
+                    std::optional<size_type> result { 0 };
+                    for (auto&& group : unsafe_downcast<relation::step::take_cogroup>(expr).groups()) {
+                        result = add(result, estimate(group.source()));
+                    }
+                    return result;
+                }
+                default:
+                    break;
+            }
+        }
+        return {};
+    }
+
+    [[nodiscard]] std::optional<size_type> estimate(descriptor::relation const& source) const {
+        auto&& exchange = binding::extract<plan::exchange>(source);
+        std::optional<size_type> result { 0 };
+        for (auto&& upstream : exchange.upstreams()) {
+            result = add(result, infos_.at(std::addressof(upstream)).rows);
+        }
+        return result;
+    }
+
+    [[nodiscard]] std::optional<size_type> estimate(relation::scan const& expr) {
+        if (!index_estimator_) {
+            return {};
+        }
+        auto&& lower = expr.lower().keys();
+        auto&& upper = expr.upper().keys();
+        std::size_t index = 0;
+        for (std::size_t n = std::min(lower.size(), upper.size()); index < n; ++index) {
+            if (lower[index] != upper[index]) {
+                break;
+            }
+            auto&& column = binding::extract<storage::column>(lower[index].variable());
+            search_keys_.emplace_back(column, lower[index].value());
+        }
+        if (index < lower.size() || index < upper.size()) {
+            // the rest is a range of the next key
+            auto const* lower_key = index < lower.size() ? std::addressof(lower[index]) : nullptr;
+            auto const* upper_key = index < upper.size() ? std::addressof(upper[index]) : nullptr;
+            auto&& key_variable = lower_key != nullptr ? lower_key->variable() : upper_key->variable();
+            auto&& column = binding::extract<storage::column>(key_variable);
+            optional_ptr<::takatori::scalar::expression const> lower_value {};
+            optional_ptr<::takatori::scalar::expression const> upper_value {};
+            if (lower_key != nullptr && lower_key->variable() == key_variable) {
+                lower_value = lower_key->value();
+            }
+            if (upper_key != nullptr && upper_key->variable() == key_variable) {
+                upper_value = upper_key->value();
+            }
+            search_keys_.emplace_back(
+                    column,
+                    lower_value,
+                    is_inclusive(expr.lower().kind()),
+                    upper_value,
+                    is_inclusive(expr.upper().kind()));
+        }
+        return estimate(expr.source(), expr.columns());
+    }
+
+    [[nodiscard]] std::optional<size_type> estimate(relation::find const& expr) {
+        if (!index_estimator_) {
+            return {};
+        }
+        for (auto&& key : expr.keys()) {
+            auto&& column = binding::extract<storage::column>(key.variable());
+            search_keys_.emplace_back(column, key.value());
+        }
+        return estimate(expr.source(), expr.columns());
+    }
+
+    template<class Columns>
+    [[nodiscard]] std::optional<size_type> estimate(descriptor::relation const& source, Columns const& columns) {
+        auto&& index = binding::extract<storage::index>(source);
+        values_.reserve(columns.size());
+        for (auto&& column : columns) {
+            values_.emplace_back(binding::extract<storage::column>(column.source()));
+        }
+        auto result = (*index_estimator_)(index, search_keys_, {}, values_);
+        search_keys_.clear();
+        values_.clear();
+        return result.count();
+    }
+};
+
+} // namespace
+
+step_plan_scheduler::step_plan_scheduler(
+        size_type max_parallelism,
+        size_type rows_per_worker,
+        optional_ptr<index_estimator const> index_estimator) noexcept :
+    max_parallelism_ { std::max<size_type>(max_parallelism, 1) },
+    rows_per_worker_ { std::max<size_type>(rows_per_worker, 1) },
+    index_estimator_ { index_estimator }
+{}
+
+step_plan_scheduler::size_type step_plan_scheduler::max_parallelism() const noexcept {
+    return max_parallelism_;
+}
+
+step_plan_scheduler::size_type step_plan_scheduler::rows_per_worker() const noexcept {
+    return rows_per_worker_;
+}
+
+step_plan_scheduler::info_map step_plan_scheduler::operator()(plan::graph_type const& graph) const {
+    engine e { index_estimator_ };
+    e.schedule(graph);
+    auto&& infos = e.infos();
+
+    // the critical path ends with the heaviest process,
+    // and we break ties by the deepest level and then by the first one in the graph, to keep it reproducible
+    optional_ptr<plan::process const> tail {};
+    process_info const* tail_info {};
+    for (auto&& step : graph) {
+        if (step.kind() != plan::process::tag) {
+            continue;
+        }
+        auto&& process = unsafe_downcast<plan::process>(step);
+        auto found = infos.find(std::addressof(process));
+        if (found == infos.end()) {
+            continue;
+        }
+        auto&& info = found->second;
+        if (!tail
+                || info.weight > tail_info->weight
+                || (info.weight == tail_info->weight && info.level > tail_info->level)) {
+            tail = process;
+            tail_info = std::addressof(info);
+        }
+    }
+    std::unordered_set<plan::process const*> critical {};
+    for (auto current = tail; current; current = infos.at(current.get()).heaviest_upstream) {
+        critical.emplace(current.get());
+    }
+
+    info_map results {};
+    results.reserve(infos.size());
+    for (auto&& [process, info] : infos) {
+        size_type parallelism = 1;
+        if (info.rows) {
+            parallelism = (*info.rows + rows_per_worker_ - 1) / rows_per_worker_;
+            parallelism = std::clamp<size_type>(parallelism, 1, max_parallelism_);
+        }
+        results.emplace(
+                process,
+                process_schedule {
+                        info.level,
+                        critical.find(process) != critical.end(),
+                        info.rows,
+                        parallelism,
+                });
+    }
+    return results;
+}
+
+} // namespace yugawara::analyzer
@@ -0,0 +1,55 @@
+#include <yugawara/analyzer/variable_layout.h>
+
+namespace yugawara::analyzer {
+
+variable_layout::variable_layout(std::size_t record_size, std::size_t record_alignment) noexcept :
+    record_size_ { record_size },
+    record_alignment_ { record_alignment }
+{}
+
+std::size_t variable_layout::record_size() const noexcept {
+    return record_size_;
+}
+
+std::size_t variable_layout::record_alignment() const noexcept {
+    return record_alignment_;
+}
+
+variable_layout::slot_map& variable_layout::slots() noexcept {
+    return slots_;
+}
+
+variable_layout::slot_map const& variable_layout::slots() const noexcept {
+    return slots_;
+}
+
+::takatori::util::optional_ptr<variable_slot const> variable_layout::find(
+        ::takatori::descriptor::variable const& variable) const {
+    if (auto it = slots_.find(variable); it != slots_.end()) {
+        return it->second;
+    }
+    return {};
+}
+
+std::ostream& operator<<(std::ostream& out, variable_layout const& value) {
+    out << "variable_layout(";
+    out << "record_size=" << value.record_size() << ", ";
+    out << "record_alignment=" << value.record_alignment() << ", ";
+    out << "slots={";
+    if (!value.slots().empty()) {
+        out << " ";
+        bool first = true;
+        for (auto&& [variable, slot] : value.slots()) {
+            if (!first) {
+                out << ",";
+            }
+            out << " " << variable << ": " << slot;
+            first = false;
+        }
+        out << " ";
+    }
+    out << "})";
+    return out;
+}
+
+} // namespace yugawara::analyzer
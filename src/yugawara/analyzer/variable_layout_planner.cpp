@@ -0,0 +1,291 @@
+#include <yugawara/analyzer/variable_layout_planner.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <boost/dynamic_bitset.hpp>
+
+#include <tsl/hopscotch_map.h>
+
+#include <takatori/util/exception.h>
+
+namespace yugawara::analyzer {
+
+using ::takatori::util::throw_exception;
+
+namespace {
+
+using mask_type = ::boost::dynamic_bitset<std::uintptr_t>;
+using shape = variable_layout_planner::shape;
+
+constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+[[nodiscard]] constexpr std::size_t align_up(std::size_t offset, std::size_t alignment) noexcept {
+    return (offset + alignment - 1) / alignment * alignment;
+}
+
+class engine {
+public:
+    explicit engine(
+            ::takatori::graph::graph<block> const& blocks,
+            variable_liveness_analyzer& liveness,
+            variable_layout_planner::shape_provider const& shapes,
+            variable_layout_planner::info_map& results) noexcept :
+        blocks_ { blocks },
+        liveness_ { liveness },
+        shapes_ { shapes },
+        results_ { results }
+    {}
+
+    void operator()() {
+        schedule();
+        compute_lifetimes();
+        allocate();
+        arrange();
+        build();
+    }
+
+private:
+    struct node {
+        block const* source;
+        variable_liveness_info const* info;
+        std::size_t parent;
+        mask_type alive {}; // alive in this block
+        mask_type propagate {}; // alive at the end of this block
+    };
+
+    struct variable_entry {
+        ::takatori::descriptor::variable variable;
+        shape value_shape;
+        std::size_t begin { npos };
+        std::size_t end { npos };
+        std::size_t slot { npos };
+    };
+
+    struct slot_entry {
+        shape slot_shape;
+        std::size_t end;
+        std::size_t offset {};
+    };
+
+    ::takatori::graph::graph<block> const& blocks_;
+    variable_liveness_analyzer& liveness_;
+    variable_layout_planner::shape_provider const& shapes_;
+    variable_layout_planner::info_map& results_;
+
+    // blocks in depth-first pre-order, that is, each parent always precedes its children
+    std::vector<node> nodes_ {};
+
+    // dense variable numbering
+    std::vector<variable_entry> variables_ {};
+    ::tsl::hopscotch_map<
+            ::takatori::descriptor::variable,
+            std::size_t,
+            std::hash<::takatori::descriptor::variable>,
+            std::equal_to<>> indices_ {};
+
+    std::vector<slot_entry> slots_ {};
+    std::size_t record_size_ {};
+    std::size_t record_alignment_ { 1 };
+
+    void schedule() {
+        nodes_.reserve(blocks_.size());
+        std::vector<std::pair<block const*, std::size_t>> work {};
+        for (auto&& head : blocks_) {
+            if (!head.upstreams().empty()) {
+                continue;
+            }
+            work.emplace_back(std::addressof(head), npos);
+            while (!work.empty()) {
+                auto [bp, parent] = work.back();
+                work.pop_back();
+                auto&& info = liveness_.inspect(*bp, {
+                        variable_liveness_kind::define,
+                        variable_liveness_kind::kill,
+                });
+                for (auto&& v : info.define()) {
+                    index_of(v);
+                }
+                std::size_t index = nodes_.size();
+                nodes_.push_back(node { bp, std::addressof(info), parent });
+                for (auto&& succ : bp->downstreams()) {
+                    work.emplace_back(std::addressof(succ), index);
+                }
+            }
+        }
+    }
+
+    void compute_lifetimes() {
+        auto size = variables_.size();
+        mask_type define { size };
+        mask_type kill { size };
+        for (std::size_t i = 0, n = nodes_.size(); i < n; ++i) {
+            auto&& current = nodes_[i];
+            define.reset();
+            kill.reset();
+            for (auto&& v : current.info->define()) {
+                define.set(index_of(v));
+            }
+            for (auto&& v : current.info->kill()) {
+                if (auto it = indices_.find(v); it != indices_.end()) {
+                    kill.set(it->second);
+                }
+            }
+            if (current.parent == npos) {
+                current.alive.resize(size);
+            } else {
+                current.alive = nodes_[current.parent].propagate;
+                current.alive -= kill;
+            }
+            current.alive |= define;
+
+            // variables which are both defined and killed here are never used anywhere
+            current.propagate = current.alive - (define & kill);
+
+            for (auto index = current.alive.find_first();
+                    index != mask_type::npos;
+                    index = current.alive.find_next(index)) {
+                auto&& entry = variables_[index];
+                if (entry.begin == npos) {
+                    entry.begin = i;
+                }
+                entry.end = i;
+            }
+        }
+    }
+
+    void allocate() {
+        std::vector<std::size_t> order {};
+        order.reserve(variables_.size());
+        for (std::size_t i = 0, n = variables_.size(); i < n; ++i) {
+            if (variables_[i].begin != npos) {
+                order.emplace_back(i);
+            }
+        }
+        std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+            return variables_[a].begin < variables_[b].begin;
+        });
+        for (auto index : order) {
+            auto&& entry = variables_[index];
+            auto&& value_shape = entry.value_shape;
+
+            // find the smallest slot which is already released and can hold the value
+            std::size_t found = npos;
+            for (std::size_t i = 0, n = slots_.size(); i < n; ++i) {
+                auto&& slot = slots_[i];
+                if (slot.end >= entry.begin
+                        || slot.slot_shape.size < value_shape.size
+                        || slot.slot_shape.alignment < value_shape.alignment) {
+                    continue;
+                }
+                if (found == npos || slot.slot_shape.size < slots_[found].slot_shape.size) {
+                    found = i;
+                }
+            }
+            if (found == npos) {
+                found = slots_.size();
+                slots_.push_back(slot_entry { value_shape, entry.end });
+            } else {
+                slots_[found].end = entry.end;
+            }
+            entry.slot = found;
+        }
+    }
+
+    void arrange() {
+        std::vector<std::size_t> order {};
+        order.reserve(slots_.size());
+        for (std::size_t i = 0, n = slots_.size(); i < n; ++i) {
+            order.emplace_back(i);
+        }
+        // place the slots from the largest alignment, so that no padding is required between them
+        std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+            auto&& left = slots_[a].slot_shape;
+            auto&& right = slots_[b].slot_shape;
+            if (left.alignment != right.alignment) {
+                return left.alignment > right.alignment;
+            }
+            return left.size > right.size;
+        });
+        std::size_t offset = 0;
+        for (auto index : order) {
+            auto&& slot = slots_[index];
+            slot.offset = align_up(offset, slot.slot_shape.alignment);
+            offset = slot.offset + slot.slot_shape.size;
+            record_alignment_ = std::max(record_alignment_, slot.slot_shape.alignment);
+        }
+        record_size_ = align_up(offset, record_alignment_);
+    }
+
+    void build() {
+        results_.reserve(blocks_.size());
+        for (auto&& bp : blocks_) {
+            results_.emplace(std::addressof(bp), variable_layout { record_size_, record_alignment_ });
+        }
+        for (auto&& current : nodes_) {
+            auto&& slots = results_[current.source].slots();
+            for (auto index = current.alive.find_first();
+                    index != mask_type::npos;
+                    index = current.alive.find_next(index)) {
+                auto&& entry = variables_[index];
+                auto&& slot = slots_[entry.slot];
+                slots.emplace(
+                        entry.variable,
+                        variable_slot {
+                                slot.offset,
+                                entry.value_shape.size,
+                                entry.value_shape.alignment,
+                        });
+            }
+        }
+    }
+
+    std::size_t index_of(::takatori::descriptor::variable const& variable) {
+        if (auto it = indices_.find(variable); it != indices_.end()) {
+            return it->second;
+        }
+        auto value_shape = shapes_(variable);
+        if (value_shape.alignment == 0) {
+            value_shape.alignment = 1;
+        }
+        std::size_t index = variables_.size();
+        variables_.push_back(variable_entry { variable, value_shape });
+        indices_.emplace(variable, index);
+        return index;
+    }
+};
+
+} // namespace
+
+variable_layout_planner::variable_layout_planner(
+        ::takatori::graph::graph<block> const& blocks,
+        variable_liveness_analyzer& liveness,
+        shape_provider shapes) :
+    graph_ { blocks },
+    liveness_ { liveness },
+    shapes_ { std::move(shapes) }
+{}
+
+variable_layout_planner::info const& variable_layout_planner::inspect(block const& target) {
+    if (!blocks_) {
+        plan();
+    }
+    auto it = blocks_->find(std::addressof(target));
+    if (it == blocks_->end()) {
+        throw_exception(std::invalid_argument("block is out of scope"));
+    }
+    return it->second;
+}
+
+void variable_layout_planner::plan() {
+    info_map results {};
+    engine e { graph_, liveness_, shapes_, results };
+    e();
+    blocks_ = std::move(results);
+}
+
+} // namespace yugawara::analyzer
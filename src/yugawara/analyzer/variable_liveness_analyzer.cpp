@@ -1,5 +1,13 @@
 #include <yugawara/analyzer/variable_liveness_analyzer.h>
 
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include <boost/dynamic_bitset.hpp>
+
+#include <tsl/hopscotch_map.h>
+
 #include <takatori/scalar/dispatch.h>
 #include <takatori/scalar/walk.h>
 
@@ -254,24 +262,13 @@ private:
     }
 };
 
-struct liveness {
-    block const* const define {};
-    block const* use {};
-};
-
-// FIXME: using hopscotch_map is prefer, but some compilation errors will occur around polymorphic_allocator
-using liveness_map = std::unordered_map<
-        std::reference_wrapper<::takatori::descriptor::variable const>,
-        liveness,
-        std::hash<::takatori::descriptor::variable>,
-        std::equal_to<::takatori::descriptor::variable>>; // NOLINT(modernize-use-transparent-functors)
-
 class kill_analyzer {
 public:
+    using mask_type = ::boost::dynamic_bitset<std::uintptr_t>;
+
     explicit kill_analyzer(block_info_map& blocks) noexcept : blocks_(blocks) {}
 
     void operator()() {
-        liveness_map lvs {};
         block const* first {};
         for (auto&& [bp, info] : blocks_) {
             (void) info;
@@ -283,129 +280,144 @@ public:
                 }
             }
         }
-        process(first, lvs);
-        if (!lvs.empty()) {
-            throw_exception(std::domain_error("unhandled variable"));
+        if (first == nullptr) {
+            return;
         }
+        schedule(first);
+        build_masks();
+        propagate_definitions();
+        propagate_uses();
+        compute_kills();
     }
 
 private:
-    block_info_map& blocks_;
-
-    // find use in branches for each defined variable
-    std::vector<block const*> still_live {};
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    struct node {
+        block const* source;
+        block_info* info;
+        std::size_t parent;
+        mask_type define {};
+        mask_type use {};
+        mask_type available {}; // defined in the strict ancestors
+        mask_type live {}; // used in this block or its descendants
+    };
 
-    // NOLINTNEXTLINE(readability-function-cognitive-complexity)
-    void process(block const* bp, liveness_map& lvs) {
-        auto&& info = get_info(bp);
+    block_info_map& blocks_;
 
-        // collect all defined variables
-        for (auto&& v : info.define()) {
-            auto [it, success] = lvs.try_emplace(v, liveness { bp }); // define here
-            (void) it;
-            if (!success) {
-                throw_exception(std::domain_error(string_builder {}
-                        << "multiple definition: " << v
-                        << " in block " << bp->front()
-                        << string_builder::to_string));
+    // blocks in pre-order, that is, each parent always precedes its children
+    std::vector<node> nodes_ {};
+
+    // dense variable numbering
+    std::vector<::takatori::descriptor::variable> variables_ {};
+    ::tsl::hopscotch_map<
+            ::takatori::descriptor::variable,
+            std::size_t,
+            std::hash<::takatori::descriptor::variable>,
+            std::equal_to<>> indices_ {};
+
+    void schedule(block const* first) {
+        nodes_.reserve(blocks_.size());
+        std::vector<std::pair<block const*, std::size_t>> work {};
+        work.emplace_back(first, npos);
+        while (!work.empty()) {
+            auto [bp, parent] = work.back();
+            work.pop_back();
+            std::size_t index = nodes_.size();
+            nodes_.push_back(node { bp, std::addressof(get_info(bp)), parent });
+            for (auto&& succ : bp->downstreams()) {
+                work.emplace_back(std::addressof(succ), index);
             }
         }
+    }
 
-        // marks all used blocks
-        for (auto&& v : info.use()) {
-            if (is_definable(v)) {
-                if (auto it = lvs.find(v); it != lvs.end()) {
-                    auto&& lv = it->second;
-                    lv.use = bp;
-                } else {
-                    throw_exception(std::domain_error(string_builder {}
-                            << "undefined variable: " << v
-                            << " in block " << bp->front()
-                            << string_builder::to_string));
+    void build_masks() {
+        for (auto&& n : nodes_) {
+            for (auto&& v : n.info->define()) {
+                index_of(v);
+            }
+        }
+        auto size = variables_.size();
+        for (auto&& n : nodes_) {
+            n.define.resize(size);
+            n.use.resize(size);
+            for (auto&& v : n.info->define()) {
+                n.define.set(index_of(v));
+            }
+            for (auto&& v : n.info->use()) {
+                if (is_definable(v)) {
+                    if (auto it = indices_.find(v); it != indices_.end()) {
+                        n.use.set(it->second);
+                    } else {
+                        throw_exception(std::domain_error(string_builder {}
+                                << "undefined variable: " << v
+                                << " in block " << n.source->front()
+                                << string_builder::to_string));
+                    }
                 }
             }
         }
+    }
 
-        auto succs = bp->downstreams();
-        if (succs.empty()) {
-            // kill used blocks
-            for (auto it = lvs.begin(); it != lvs.end();) {
-                auto&& lv = it->second;
-                if (lv.use == bp) { // last use = self
-                    // NOTE: we don't record as kill because this is on tail of graph (trivial kill)
-                    it = lvs.erase(it);
-                } else {
-                    ++it;
-                }
+    void propagate_definitions() {
+        for (auto&& n : nodes_) {
+            if (n.parent == npos) {
+                n.available.resize(variables_.size());
+            } else {
+                auto&& parent = nodes_[n.parent];
+                n.available = parent.available | parent.define;
             }
-        } else if (succs.size() == 1) {
-            // NOTE: continue to the succeeding block
-            auto const* succp = std::addressof(succs[0]);
-            process(succp, lvs);
-
-            // kill used blocks
-            auto&& succ_info = get_info(succp);
-            for (auto it = lvs.begin(); it != lvs.end();) {
-                auto&& lv = it->second;
-                if (lv.use == bp) { // last use = self
-                    succ_info.kill().emplace(it->first);
-                    it = lvs.erase(it);
-                } else {
-                    ++it;
-                }
+            if (auto conflict = n.available & n.define; conflict.any()) {
+                throw_exception(std::domain_error(string_builder {}
+                        << "multiple definition: " << variables_[conflict.find_first()]
+                        << " in block " << n.source->front()
+                        << string_builder::to_string));
             }
-        } else {
-            std::vector<liveness_map> branches {};
-            branches.reserve(succs.size());
-            for (auto&& succ : succs) {
-                auto const* succp = std::addressof(succ);
-                process(succp, branches.emplace_back(lvs));
+            if (auto undefined = n.use - (n.available | n.define); undefined.any()) {
+                throw_exception(std::domain_error(string_builder {}
+                        << "undefined variable: " << variables_[undefined.find_first()]
+                        << " in block " << n.source->front()
+                        << string_builder::to_string));
             }
-            still_live.reserve(succs.size());
-            for (auto it = lvs.begin(); it != lvs.end();) {
-                still_live.clear();
-                auto&& v = it->first;
-                std::size_t index = 0;
-                for (auto&& lvs_branch : branches) {
-                    if (lvs_branch.find(v) != lvs_branch.end()) {
-                        // liveness entry still exists
-                        still_live.emplace_back(std::addressof(succs[index]));
-                    }
-                    ++index;
-                }
-                // used in all branches
-                if (still_live.empty()) {
-                    // just remove the entry (already killed in branch)
-                    it = lvs.erase(it);
-                } else if (still_live.size() < branches.size()) {
-                    // kill the first block of branches, ...
-                    for (auto const* bp_branch : still_live) {
-                        auto&& info_branch = get_info(bp_branch);
-                        info_branch.kill().emplace(v);
-                    }
+        }
+    }
 
-                    // and remove the entry
-                    it = lvs.erase(it);
-                } else {
-                    // no branches use the variable
-                    ++it;
-                }
+    void propagate_uses() {
+        for (auto&& n : nodes_) {
+            n.live = n.use;
+        }
+        for (std::size_t i = nodes_.size(); i > 0; --i) {
+            auto&& n = nodes_[i - 1];
+            if (n.parent != npos) {
+                nodes_[n.parent].live |= n.live;
             }
         }
+    }
 
-        // kill defined (but not used) variables
-        for (auto it = lvs.begin(); it != lvs.end();) {
-            auto&& [v, lv] = *it;
-            if (lv.define == bp) {
-                BOOST_ASSERT(lv.use == nullptr); // NOLINT
-                info.kill().emplace(v);
-                it = lvs.erase(it);
-            } else {
-                ++it;
+    void compute_kills() {
+        for (auto&& n : nodes_) {
+            // variables defined here but never used, or
+            // variables which were used in the parent or its other branches, but never used from here
+            // NOTE: we don't record the last use in the tail blocks as kill (trivial kill)
+            mask_type dead = n.define;
+            if (n.parent != npos) {
+                dead |= n.available & nodes_[n.parent].live;
+            }
+            dead -= n.live;
+            for (auto index = dead.find_first(); index != mask_type::npos; index = dead.find_next(index)) {
+                n.info->kill().emplace(variables_[index]);
             }
         }
     }
 
+    std::size_t index_of(::takatori::descriptor::variable const& variable) {
+        auto [it, success] = indices_.emplace(variable, variables_.size());
+        if (success) {
+            variables_.emplace_back(variable);
+        }
+        return it->second;
+    }
+
     block_info& get_info(block const* bp) {
         auto it = blocks_.find(bp);
         if (it == blocks_.end()) {
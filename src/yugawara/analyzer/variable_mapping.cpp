@@ -7,17 +7,15 @@ namespace yugawara::analyzer {
 using ::takatori::util::throw_exception;
 
 variable_resolution const& variable_mapping::find(::takatori::descriptor::variable const& variable) const {
-    if (auto it = mapping_.find(variable); it != mapping_.end()) {
-        return it->second;
+    if (auto const* found = mapping_.find(variable)) {
+        return *found;
     }
     static variable_resolution unresolved {};
     return unresolved;
 }
 
 void variable_mapping::each(consumer_type const& consumer) const {
-    for (auto&& [descriptor, resolution] : mapping_) {
-        consumer(descriptor, resolution);
-    }
+    mapping_.each(consumer);
 }
 
 variable_resolution const& variable_mapping::bind(
@@ -25,12 +23,10 @@ variable_resolution const& variable_mapping::bind(
         variable_resolution resolution,
         bool overwrite) {
     if (overwrite) {
-        auto [iter, success] = mapping_.insert_or_assign(variable, std::move(resolution));
-        (void) success;
-        return iter->second;
+        return mapping_.insert_or_assign(variable, std::move(resolution));
     }
-    if (auto [iter, success] = mapping_.emplace(variable, std::move(resolution)); success) {
-        return iter->second;
+    if (auto [stored, success] = mapping_.try_emplace(variable, std::move(resolution)); success) {
+        return stored;
     }
     throw_exception(std::domain_error("rebind variable"));
 }
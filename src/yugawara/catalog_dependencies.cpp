@@ -0,0 +1,100 @@
+#include <yugawara/catalog_dependencies.h>
+
+#include <algorithm>
+#include <memory>
+
+namespace yugawara {
+
+using ::takatori::util::sequence_view;
+
+namespace {
+
+template<class T>
+bool contains(std::vector<T const*> const& elements, T const& element) noexcept {
+    return std::find(elements.begin(), elements.end(), std::addressof(element)) != elements.end();
+}
+
+template<class T>
+void insert(std::vector<T const*>& elements, T const& element) {
+    if (!contains(elements, element)) {
+        elements.emplace_back(std::addressof(element));
+    }
+}
+
+} // namespace
+
+catalog_dependencies& catalog_dependencies::add(storage::relation const& element) {
+    insert(relations_, element);
+    return *this;
+}
+
+catalog_dependencies& catalog_dependencies::add(storage::index const& element) {
+    insert(indices_, element);
+    insert<storage::relation>(relations_, element.table());
+    return *this;
+}
+
+catalog_dependencies& catalog_dependencies::add(variable::declaration const& element) {
+    insert(variables_, element);
+    return *this;
+}
+
+catalog_dependencies& catalog_dependencies::add(function::declaration const& element) {
+    insert(functions_, element);
+    return *this;
+}
+
+catalog_dependencies& catalog_dependencies::add(aggregate::declaration const& element) {
+    insert(aggregates_, element);
+    return *this;
+}
+
+bool catalog_dependencies::depends_on(storage::relation const& element) const noexcept {
+    return contains(relations_, element);
+}
+
+bool catalog_dependencies::depends_on(storage::index const& element) const noexcept {
+    return contains(indices_, element);
+}
+
+bool catalog_dependencies::depends_on(variable::declaration const& element) const noexcept {
+    return contains(variables_, element);
+}
+
+bool catalog_dependencies::depends_on(function::declaration const& element) const noexcept {
+    return contains(functions_, element);
+}
+
+bool catalog_dependencies::depends_on(aggregate::declaration const& element) const noexcept {
+    return contains(aggregates_, element);
+}
+
+sequence_view<storage::relation const* const> catalog_dependencies::relations() const noexcept {
+    return relations_;
+}
+
+sequence_view<storage::index const* const> catalog_dependencies::indices() const noexcept {
+    return indices_;
+}
+
+sequence_view<variable::declaration const* const> catalog_dependencies::variables() const noexcept {
+    return variables_;
+}
+
+sequence_view<function::declaration const* const> catalog_dependencies::functions() const noexcept {
+    return functions_;
+}
+
+sequence_view<aggregate::declaration const* const> catalog_dependencies::aggregates() const noexcept {
+    return aggregates_;
+}
+
+bool catalog_dependencies::empty() const noexcept {
+    return relations_.empty()
+        && indices_.empty()
+        && variables_.empty()
+        && functions_.empty()
+        && aggregates_.empty();
+}
+
+} // namespace yugawara
@@ -22,6 +22,26 @@ yugawara::compiled_info::compiled_info(
     variable_mapping_ { std::move(variable_mapping) }
 {}
 
+yugawara::compiled_info::compiled_info(
+        std::shared_ptr<analyzer::expression_mapping const> expression_mapping,
+        std::shared_ptr<analyzer::variable_mapping const> variable_mapping,
+        std::shared_ptr<analyzer::exchange_column_layout_map const> exchange_layouts) noexcept :
+    expression_mapping_ { std::move(expression_mapping) },
+    variable_mapping_ { std::move(variable_mapping) },
+    exchange_layouts_ { std::move(exchange_layouts) }
+{}
+
+yugawara::compiled_info::compiled_info(
+        std::shared_ptr<analyzer::expression_mapping const> expression_mapping,
+        std::shared_ptr<analyzer::variable_mapping const> variable_mapping,
+        std::shared_ptr<analyzer::exchange_column_layout_map const> exchange_layouts,
+        std::shared_ptr<analyzer::partitioned_exchange_set const> partitioned_exchanges) noexcept :
+    expression_mapping_ { std::move(expression_mapping) },
+    variable_mapping_ { std::move(variable_mapping) },
+    exchange_layouts_ { std::move(exchange_layouts) },
+    partitioned_exchanges_ { std::move(partitioned_exchanges) }
+{}
+
 ::takatori::type::data const& compiled_info::type_of(scalar::expression const& expression) const {
     auto&& resolution = expression_mapping_->find(expression);
     if (resolution) {
@@ -51,6 +71,24 @@ yugawara::compiled_info::compiled_info(
     fail();
 }
 
+::takatori::util::optional_ptr<analyzer::exchange_column_layout const> compiled_info::exchange_layout_of(
+        ::takatori::plan::exchange const& exchange) const {
+    if (!exchange_layouts_) {
+        return {};
+    }
+    if (auto it = exchange_layouts_->find(std::addressof(exchange)); it != exchange_layouts_->end()) {
+        return it->second;
+    }
+    return {};
+}
+
+bool compiled_info::is_partitioned(::takatori::plan::exchange const& exchange) const {
+    if (!partitioned_exchanges_) {
+        return false;
+    }
+    return partitioned_exchanges_->find(std::addressof(exchange)) != partitioned_exchanges_->end();
+}
+
 analyzer::expression_mapping const& compiled_info::expressions() const noexcept {
     return *expression_mapping_;
 }
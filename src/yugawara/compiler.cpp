@@ -4,6 +4,7 @@
 
 #include <takatori/util/assertion.h>
 #include <takatori/util/clonable.h>
+#include <takatori/util/downcast.h>
 
 #include <yugawara/analyzer/expression_analyzer.h>
 #include <yugawara/analyzer/intermediate_plan_normalizer.h>
@@ -13,6 +14,10 @@
 #include <yugawara/storage/basic_prototype_processor.h>
 #include <yugawara/storage/resolve_prototype.h>
 
+#include "analyzer/details/arrange_exchange_columns.h"
+#include "analyzer/details/balance_expressions.h"
+#include "analyzer/details/collapse_in_list.h"
+#include "analyzer/details/collect_partitioned_exchanges.h"
 #include "details/collect_restricted_features.h"
 
 namespace yugawara {
@@ -29,6 +34,7 @@ namespace plan = ::takatori::plan;
 namespace statement = ::takatori::statement;
 
 using ::takatori::util::clone_unique;
+using ::takatori::util::unsafe_downcast;
 
 using ::yugawara::util::either;
 
@@ -113,11 +119,14 @@ public:
     }
 
     result_type compile(relation::graph_type&& plan) {
+        // rebalance deep chains and collapse large IN lists before the expression analyzer recursively walks them
+        analyzer::details::balance_expressions(plan);
+        analyzer::details::collapse_in_list(plan);
         expression_analyzer_.resolve(plan, true, type_repository_);
         if (expression_analyzer_.has_diagnostics()) {
             return result_type { build_error(expression_analyzer_) };
         }
-        expression_mapping_->clear();
+        expression_analyzer_.retain_expressions();
         variable_mapping_->clear();
 
         if (auto diagnostics = do_normalize(plan); !diagnostics.empty()) {
@@ -148,10 +157,31 @@ public:
             }
         }
 
+        for (auto&& invariant : invariants_) {
+            expression_analyzer_.resolve(invariant.value(), true, type_repository_);
+            expression_analyzer_.variables().bind(
+                    invariant.variable(),
+                    analyzer::variable_resolution { invariant.value() },
+                    true);
+        }
         expression_analyzer_.resolve(*stmt, true, type_repository_);
+        expression_analyzer_.clear_retained_expressions();
         if (expression_analyzer_.has_diagnostics()) {
             return result_type { build_error(expression_analyzer_) };
         }
+        if (options_.enable_exchange_column_arrangement() && stmt->kind() == statement::execute::tag) {
+            auto&& plan = unsafe_downcast<statement::execute>(*stmt).execution_plan();
+            exchange_layouts_ = std::make_shared<analyzer::exchange_column_layout_map>(
+                    analyzer::details::arrange_exchange_columns(
+                            plan,
+                            info_type { expression_mapping_, variable_mapping_ },
+                            options_.exchange_column_shapes()));
+        }
+        if (options_.enable_partitioning_analysis() && stmt->kind() == statement::execute::tag) {
+            auto&& plan = unsafe_downcast<statement::execute>(*stmt).execution_plan();
+            partitioned_exchanges_ = std::make_shared<analyzer::partitioned_exchange_set>(
+                    analyzer::details::collect_partitioned_exchanges(plan));
+        }
         return build_success(std::move(stmt));
     }
 
@@ -161,6 +191,9 @@ private:
     std::shared_ptr<analyzer::variable_mapping> variable_mapping_;
     analyzer::expression_analyzer expression_analyzer_;
     type::repository type_repository_;
+    std::vector<analyzer::invariant_declaration> invariants_ {};
+    std::shared_ptr<analyzer::exchange_column_layout_map const> exchange_layouts_ {};
+    std::shared_ptr<analyzer::partitioned_exchange_set const> partitioned_exchanges_ {};
 
     result_type build_success(std::unique_ptr<statement::statement> result) {
         BOOST_ASSERT(!expression_analyzer_.has_diagnostics()); // NOLINT
@@ -169,7 +202,10 @@ private:
                 info_type {
                         std::move(expression_mapping_),
                         std::move(variable_mapping_),
+                        std::move(exchange_layouts_),
+                        std::move(partitioned_exchanges_),
                 },
+                std::move(invariants_),
         };
     }
 
@@ -185,14 +221,23 @@ private:
         analyzer::intermediate_plan_optimizer sub {};
         sub.options().runtime_features() = options_.runtime_features();
         sub.options().index_estimator(options_.index_estimator());
+        sub.options().exchange_column_shapes(options_.exchange_column_shapes());
         sub.options().enable_disjunction_range_hinting() = options_.enable_disjunction_range_hinting();
         sub.options().enable_external_variable_inlining() = options_.enable_external_variable_inlining();
+        sub.options().enable_projection_pushdown() = options_.enable_projection_pushdown();
+        sub.options().broadcast_build_size_limit() = options_.broadcast_build_size_limit();
+        sub.options().broadcast_fan_out() = options_.broadcast_fan_out();
+        sub.options().broadcast_row_threshold() = options_.broadcast_row_threshold();
+        sub.options().enable_common_subexpression_elimination() = options_.enable_common_subexpression_elimination();
+        sub.options().enable_invariant_hoisting() = options_.enable_invariant_hoisting();
         sub(graph);
+        invariants_ = std::move(sub.invariants());
     }
 
     plan::graph_type do_plan(relation::graph_type&& graph) {
         analyzer::step_plan_builder sub {};
         sub.options().runtime_features() = options_.runtime_features();
+        sub.options().enable_exchange_fusion() = options_.enable_exchange_fusion();
         return sub(std::move(graph));
     }
 };
@@ -206,6 +251,8 @@ result_type compiler::operator()(compiler_options const& options, relation::grap
 }
 
 result_type compiler::operator()(options_type const& options, std::unique_ptr<statement::statement> statement) {
+    // rebalance deep chains before the expression analyzer recursively walks them
+    analyzer::details::balance_expressions(*statement);
     engine e { options };
     return e.compile(std::move(statement));
 }
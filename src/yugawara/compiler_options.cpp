@@ -72,4 +72,85 @@ bool compiler_options::enable_external_variable_inlining() const noexcept {
     return enable_external_variable_inlining_;
 }
 
+bool& compiler_options::enable_projection_pushdown() noexcept {
+    return enable_projection_pushdown_;
+}
+
+bool compiler_options::enable_projection_pushdown() const noexcept {
+    return enable_projection_pushdown_;
+}
+
+std::size_t& compiler_options::broadcast_build_size_limit() noexcept {
+    return broadcast_build_size_limit_;
+}
+
+std::size_t compiler_options::broadcast_build_size_limit() const noexcept {
+    return broadcast_build_size_limit_;
+}
+
+std::size_t& compiler_options::broadcast_fan_out() noexcept {
+    return broadcast_fan_out_;
+}
+
+std::size_t compiler_options::broadcast_fan_out() const noexcept {
+    return broadcast_fan_out_;
+}
+
+std::size_t& compiler_options::broadcast_row_threshold() noexcept {
+    return broadcast_row_threshold_;
+}
+
+std::size_t compiler_options::broadcast_row_threshold() const noexcept {
+    return broadcast_row_threshold_;
+}
+
+bool& compiler_options::enable_common_subexpression_elimination() noexcept {
+    return enable_common_subexpression_elimination_;
+}
+
+bool compiler_options::enable_common_subexpression_elimination() const noexcept {
+    return enable_common_subexpression_elimination_;
+}
+
+bool& compiler_options::enable_invariant_hoisting() noexcept {
+    return enable_invariant_hoisting_;
+}
+
+bool compiler_options::enable_invariant_hoisting() const noexcept {
+    return enable_invariant_hoisting_;
+}
+
+bool& compiler_options::enable_exchange_column_arrangement() noexcept {
+    return enable_exchange_column_arrangement_;
+}
+
+bool compiler_options::enable_exchange_column_arrangement() const noexcept {
+    return enable_exchange_column_arrangement_;
+}
+
+analyzer::exchange_column_shape_provider const& compiler_options::exchange_column_shapes() const noexcept {
+    return exchange_column_shapes_;
+}
+
+compiler_options& compiler_options::exchange_column_shapes(analyzer::exchange_column_shape_provider shapes) {
+    exchange_column_shapes_ = std::move(shapes);
+    return *this;
+}
+
+bool& compiler_options::enable_partitioning_analysis() noexcept {
+    return enable_partitioning_analysis_;
+}
+
+bool compiler_options::enable_partitioning_analysis() const noexcept {
+    return enable_partitioning_analysis_;
+}
+
+bool& compiler_options::enable_exchange_fusion() noexcept {
+    return enable_exchange_fusion_;
+}
+
+bool compiler_options::enable_exchange_fusion() const noexcept {
+    return enable_exchange_fusion_;
+}
+
 } // namespace yugawara
\ No newline at end of file
@@ -2,6 +2,8 @@
 
 #include <yugawara/binding/extract.h>
 
+#include "details/collect_dependencies.h"
+
 namespace yugawara {
 
 namespace descriptor = ::takatori::descriptor;
@@ -21,6 +23,15 @@ yugawara::compiler_result::compiler_result(
     info_ { std::move(info) }
 {}
 
+compiler_result::compiler_result(
+        std::unique_ptr<statement::statement> statement,
+        info_type info,
+        std::vector<analyzer::invariant_declaration> invariants) noexcept :
+    statement_ { std::move(statement) },
+    info_ { std::move(info) },
+    invariants_ { std::move(invariants) }
+{}
+
 compiler_result::compiler_result(std::vector<diagnostic_type> diagnostics) noexcept :
     diagnostics_ { std::move(diagnostics) }
 {}
@@ -61,6 +72,17 @@ info_type const& compiler_result::info() const noexcept {
     return info_;
 }
 
+sequence_view<analyzer::invariant_declaration const> compiler_result::invariants() const noexcept {
+    return invariants_;
+}
+
+catalog_dependencies compiler_result::dependencies() const {
+    if (!success()) {
+        return {};
+    }
+    return details::collect_dependencies(*statement_, info_);
+}
+
 sequence_view<diagnostic_type const> compiler_result::diagnostics() const noexcept {
     return diagnostics_;
 }
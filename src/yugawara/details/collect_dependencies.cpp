@@ -0,0 +1,138 @@
+#include "collect_dependencies.h"
+
+#include <takatori/scalar/function_call.h>
+
+#include <takatori/relation/find.h>
+#include <takatori/relation/scan.h>
+#include <takatori/relation/join_find.h>
+#include <takatori/relation/join_scan.h>
+#include <takatori/relation/write.h>
+
+#include <takatori/plan/process.h>
+
+#include <takatori/statement/execute.h>
+#include <takatori/statement/write.h>
+
+#include <takatori/util/downcast.h>
+
+#include <yugawara/binding/extract.h>
+
+#include <yugawara/storage/column.h>
+
+namespace yugawara::details {
+
+namespace descriptor = ::takatori::descriptor;
+namespace scalar = ::takatori::scalar;
+namespace trelation = ::takatori::relation;
+namespace tplan = ::takatori::plan;
+namespace tstatement = ::takatori::statement;
+
+using ::takatori::util::unsafe_downcast;
+
+using analyzer::variable_resolution_kind;
+
+namespace {
+
+class engine {
+public:
+    explicit engine(catalog_dependencies& results) noexcept :
+        results_ { results }
+    {}
+
+    void process(tstatement::statement const& statement) {
+        switch (statement.kind()) {
+            case tstatement::execute::tag:
+                for (auto&& step : unsafe_downcast<tstatement::execute>(statement).execution_plan()) {
+                    if (step.kind() == tplan::process::tag) {
+                        process(unsafe_downcast<tplan::process>(step));
+                    }
+                }
+                break;
+            case tstatement::write::tag:
+                add(unsafe_downcast<tstatement::write>(statement).destination());
+                break;
+            default:
+                // DDL targets are not a part of catalog dependencies
+                break;
+        }
+    }
+
+    void process(tplan::process const& step) {
+        for (auto&& expression : step.operators()) {
+            switch (expression.kind()) {
+                case trelation::find::tag:
+                    add(unsafe_downcast<trelation::find>(expression).source());
+                    break;
+                case trelation::scan::tag:
+                    add(unsafe_downcast<trelation::scan>(expression).source());
+                    break;
+                case trelation::join_find::tag:
+                    add(unsafe_downcast<trelation::join_find>(expression).source());
+                    break;
+                case trelation::join_scan::tag:
+                    add(unsafe_downcast<trelation::join_scan>(expression).source());
+                    break;
+                case trelation::write::tag:
+                    add(unsafe_downcast<trelation::write>(expression).destination());
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+
+    void process(compiled_info const& info) {
+        info.expressions().each([&](scalar::expression const& expression, analyzer::expression_resolution const&) {
+            if (expression.kind() == scalar::function_call::tag) {
+                auto&& call = unsafe_downcast<scalar::function_call>(expression);
+                if (auto function = binding::extract_if(call.function())) {
+                    results_.add(*function);
+                }
+            }
+        });
+        info.variables().each([&](descriptor::variable const&, analyzer::variable_resolution const& resolution) {
+            switch (resolution.kind()) {
+                case variable_resolution_kind::table_column:
+                    if (auto owner = resolution.element<variable_resolution_kind::table_column>().optional_owner()) {
+                        results_.add(*owner);
+                    }
+                    break;
+                case variable_resolution_kind::external:
+                    results_.add(resolution.element<variable_resolution_kind::external>());
+                    break;
+                case variable_resolution_kind::function_call:
+                    results_.add(resolution.element<variable_resolution_kind::function_call>());
+                    break;
+                case variable_resolution_kind::aggregation:
+                    results_.add(resolution.element<variable_resolution_kind::aggregation>());
+                    break;
+                default:
+                    break;
+            }
+        });
+    }
+
+private:
+    catalog_dependencies& results_;
+
+    void add(descriptor::relation const& relation) {
+        // join_find and join_scan may refer exchanges instead of indices
+        if (auto index = binding::extract_if<storage::index>(relation)) {
+            results_.add(*index);
+        }
+    }
+};
+
+} // namespace
+
+catalog_dependencies collect_dependencies(
+        tstatement::statement const& statement,
+        compiled_info const& info) {
+    catalog_dependencies results {};
+    engine e { results };
+    e.process(statement);
+    e.process(info);
+    return results;
+}
+
+} // namespace yugawara::details
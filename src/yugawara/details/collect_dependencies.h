@@ -0,0 +1,20 @@
+#pragma once
+
+#include <takatori/statement/statement.h>
+
+#include <yugawara/catalog_dependencies.h>
+#include <yugawara/compiled_info.h>
+
+namespace yugawara::details {
+
+/**
+ * @brief collects catalog elements which the given compiled statement depends on.
+ * @param statement the compiled statement
+ * @param info the compiled information of the statement
+ * @return the dependent catalog elements
+ */
+[[nodiscard]] catalog_dependencies collect_dependencies(
+        ::takatori::statement::statement const& statement,
+        compiled_info const& info);
+
+} // namespace yugawara::details
@@ -70,6 +70,16 @@ declaration& declaration::name(declaration::name_type name) noexcept {
     return *this;
 }
 
+template<class T>
+void declaration::replace_provider(std::shared_ptr<T>& target, std::shared_ptr<T> provider) noexcept {
+    // keep the epoch increasing even if the new provider has a smaller epoch than the old one
+    if (target) {
+        replaced_epoch_ += target->epoch();
+    }
+    replaced_epoch_ += 1;
+    target = std::move(provider);
+}
+
 storage::provider& declaration::storage_provider() const noexcept {
     if (auto* p = storage_provider_.get(); p != nullptr) {
         return *p;
@@ -83,7 +93,7 @@ std::shared_ptr<storage::provider> declaration::shared_storage_provider() const
 }
 
 declaration& declaration::storage_provider(std::shared_ptr<storage::provider> provider) noexcept {
-    storage_provider_ = std::move(provider);
+    replace_provider(storage_provider_, std::move(provider));
     return *this;
 }
 
@@ -100,7 +110,7 @@ std::shared_ptr<variable::provider> declaration::shared_variable_provider() cons
 }
 
 declaration& declaration::variable_provider(std::shared_ptr<variable::provider> provider) noexcept {
-    variable_provider_ = std::move(provider);
+    replace_provider(variable_provider_, std::move(provider));
     return *this;
 }
 
@@ -117,7 +127,7 @@ std::shared_ptr<function::provider> declaration::shared_function_provider() cons
 }
 
 declaration& declaration::function_provider(std::shared_ptr<function::provider> provider) noexcept {
-    function_provider_ = std::move(provider);
+    replace_provider(function_provider_, std::move(provider));
     return *this;
 }
 
@@ -134,7 +144,7 @@ std::shared_ptr<aggregate::provider> declaration::shared_set_function_provider()
 }
 
 declaration& declaration::set_function_provider(std::shared_ptr<aggregate::provider> provider) noexcept {
-    set_function_provider_ = std::move(provider);
+    replace_provider(set_function_provider_, std::move(provider));
     return *this;
 }
 
@@ -151,10 +161,19 @@ std::shared_ptr<type::provider> declaration::shared_type_provider() const noexce
 }
 
 declaration& declaration::type_provider(std::shared_ptr<type::provider> provider) noexcept {
-    type_provider_ = std::move(provider);
+    replace_provider(type_provider_, std::move(provider));
     return *this;
 }
 
+declaration::epoch_type declaration::epoch() const noexcept {
+    return replaced_epoch_
+        + storage_provider().epoch()
+        + variable_provider().epoch()
+        + function_provider().epoch()
+        + set_function_provider().epoch()
+        + type_provider().epoch();
+}
+
 declaration::description_type const& declaration::description() const noexcept {
     return description_;
 }
@@ -31,6 +31,10 @@ std::shared_ptr<index const> provider::find_primary_index(class table const& tab
     return result;
 }
 
+provider::epoch_type provider::epoch() const noexcept {
+    return 0;
+}
+
 void provider::bless(relation const& element) {
     if (element.owner_ == nullptr || element.owner_ == this) {
         element.owner_ = this;
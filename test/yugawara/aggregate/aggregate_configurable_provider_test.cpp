@@ -199,4 +199,35 @@ TEST_F(aggregate_configurable_provider_test, each_name_parent) {
     EXPECT_EQ(r[1]->definition_id(), 3);
 }
 
+TEST_F(aggregate_configurable_provider_test, epoch) {
+    auto p1 = std::make_shared<configurable_provider>();
+    auto p2 = std::make_shared<configurable_provider>(p1);
+    EXPECT_EQ(p2->epoch(), 0);
+
+    auto&& f1 = p1->add({
+            1,
+            "f",
+            t::int4(),
+            {
+                    t::int8(),
+            },
+    });
+    auto e1 = p2->epoch();
+    EXPECT_GT(e1, 0);
+
+    p2->add({
+            2,
+            "g",
+            t::int4(),
+            {
+                    t::int8(),
+            },
+    });
+    auto e2 = p2->epoch();
+    EXPECT_GT(e2, e1);
+
+    EXPECT_TRUE(p1->remove(*f1));
+    EXPECT_GT(p2->epoch(), e2);
+}
+
 } // namespace yugawara::aggregate
@@ -0,0 +1,168 @@
+#include <yugawara/analyzer/details/arrange_exchange_columns.h>
+
+#include <gtest/gtest.h>
+
+#include <takatori/type/primitive.h>
+#include <takatori/type/character.h>
+#include <takatori/type/unknown.h>
+
+#include <takatori/plan/graph.h>
+#include <takatori/plan/group.h>
+#include <takatori/plan/broadcast.h>
+
+#include <takatori/util/downcast.h>
+
+#include <yugawara/binding/factory.h>
+
+#include <yugawara/testing/utils.h>
+
+namespace yugawara::analyzer::details {
+
+// import test utils
+using namespace ::yugawara::testing;
+
+class arrange_exchange_columns_test : public ::testing::Test {
+protected:
+    binding::factory bindings;
+    std::shared_ptr<variable_mapping> variables = std::make_shared<variable_mapping>();
+
+    compiled_info info() {
+        return compiled_info {
+                std::make_shared<expression_mapping>(),
+                variables,
+        };
+    }
+
+    descriptor::variable column(std::string_view label, ::takatori::type::data&& type) {
+        auto result = bindings.exchange_column(label);
+        variables->bind(result, std::move(type), true);
+        return result;
+    }
+
+    // mimics the runtime value encoding
+    static std::optional<exchange_column_shape> shape_of(::takatori::type::data const& type) {
+        using kind = ::takatori::type::type_kind;
+        switch (type.kind()) {
+            case kind::unknown:
+                return exchange_column_shape { 0, 1 };
+            case kind::int2:
+                return exchange_column_shape { 2, 2 };
+            case kind::int4:
+                return exchange_column_shape { 4, 4 };
+            case kind::int8:
+            case kind::float8:
+                return exchange_column_shape { 8, 8 };
+            case kind::character: {
+                auto&& string = ::takatori::util::unsafe_downcast<t::character>(type);
+                if (auto length = string.length(); !string.varying() && length) {
+                    return exchange_column_shape { *length, 1 };
+                }
+                return {};
+            }
+            default:
+                return {};
+        }
+    }
+};
+
+TEST_F(arrange_exchange_columns_test, group) {
+    plan::graph_type p;
+    auto c0 = column("c0", t::character(t::varying, 10));
+    auto c1 = column("c1", t::int8());
+    auto c2 = column("c2", t::int2());
+    auto c3 = column("c3", t::int4());
+    auto&& e0 = p.insert(plan::group {
+            { c0, c1, c2, c3, },
+            { c3, },
+            { c0, },
+    });
+
+    auto layouts = arrange_exchange_columns(p, info(), shape_of);
+
+    // keys, and then fixed-width columns from the largest alignment
+    ASSERT_EQ(e0.columns().size(), 4);
+    EXPECT_EQ(e0.columns()[0], c3);
+    EXPECT_EQ(e0.columns()[1], c0);
+    EXPECT_EQ(e0.columns()[2], c1);
+    EXPECT_EQ(e0.columns()[3], c2);
+
+    // the fixed-size prefix is broken at the variable-length key
+    auto it = layouts.find(std::addressof(e0));
+    ASSERT_NE(it, layouts.end());
+    EXPECT_EQ(it->second.key_count(), 2);
+    EXPECT_EQ(it->second.key_prefix_size(), 4);
+}
+
+TEST_F(arrange_exchange_columns_test, broadcast) {
+    plan::graph_type p;
+    auto c0 = column("c0", t::character(t::varying, 10));
+    auto c1 = column("c1", t::int2());
+    auto c2 = column("c2", t::character(4));
+    auto c3 = column("c3", t::float8());
+    auto&& e0 = p.insert(plan::broadcast {
+            { c0, c1, c2, c3, },
+    });
+
+    auto layouts = arrange_exchange_columns(p, info(), shape_of);
+
+    ASSERT_EQ(e0.columns().size(), 4);
+    EXPECT_EQ(e0.columns()[0], c3);
+    EXPECT_EQ(e0.columns()[1], c1);
+    EXPECT_EQ(e0.columns()[2], c2);
+    EXPECT_EQ(e0.columns()[3], c0);
+
+    auto it = layouts.find(std::addressof(e0));
+    ASSERT_NE(it, layouts.end());
+    EXPECT_EQ(it->second.key_count(), 0);
+    EXPECT_EQ(it->second.key_prefix_size(), 0);
+}
+
+TEST_F(arrange_exchange_columns_test, without_shapes) {
+    plan::graph_type p;
+    auto c0 = column("c0", t::character(t::varying, 10));
+    auto c1 = column("c1", t::int8());
+    auto c2 = column("c2", t::int2());
+    auto c3 = column("c3", t::int4());
+    auto&& e0 = p.insert(plan::group {
+            { c0, c1, c2, c3, },
+            { c3, },
+    });
+
+    auto layouts = arrange_exchange_columns(p, info(), {});
+
+    // only moves keys to the head
+    ASSERT_EQ(e0.columns().size(), 4);
+    EXPECT_EQ(e0.columns()[0], c3);
+    EXPECT_EQ(e0.columns()[1], c0);
+    EXPECT_EQ(e0.columns()[2], c1);
+    EXPECT_EQ(e0.columns()[3], c2);
+
+    auto it = layouts.find(std::addressof(e0));
+    ASSERT_NE(it, layouts.end());
+    EXPECT_EQ(it->second.key_count(), 1);
+    EXPECT_EQ(it->second.key_prefix_size(), 0);
+}
+
+TEST_F(arrange_exchange_columns_test, unknown) {
+    plan::graph_type p;
+    auto c0 = column("c0", t::unknown());
+    auto c1 = column("c1", t::int4());
+    auto&& e0 = p.insert(plan::group {
+            { c0, c1, },
+            { c0, c1, },
+    });
+
+    auto layouts = arrange_exchange_columns(p, info(), shape_of);
+
+    ASSERT_EQ(e0.columns().size(), 2);
+    EXPECT_EQ(e0.columns()[0], c0);
+    EXPECT_EQ(e0.columns()[1], c1);
+
+    // the unknown type is always treated as variable-length
+    auto it = layouts.find(std::addressof(e0));
+    ASSERT_NE(it, layouts.end());
+    EXPECT_EQ(it->second.key_count(), 2);
+    EXPECT_EQ(it->second.key_prefix_size(), 0);
+}
+
+} // namespace yugawara::analyzer::details
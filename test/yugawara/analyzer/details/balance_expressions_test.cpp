@@ -0,0 +1,251 @@
+#include <yugawara/analyzer/details/balance_expressions.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+#include <takatori/scalar/coalesce.h>
+#include <takatori/scalar/conditional.h>
+
+#include <takatori/relation/scan.h>
+#include <takatori/relation/filter.h>
+#include <takatori/relation/values.h>
+#include <takatori/relation/emit.h>
+
+#include <takatori/util/downcast.h>
+
+#include <yugawara/binding/factory.h>
+#include <yugawara/storage/configurable_provider.h>
+
+#include <yugawara/analyzer/details/decompose_predicate.h>
+
+#include <yugawara/testing/utils.h>
+
+namespace yugawara::analyzer::details {
+
+// import test utils
+using namespace ::yugawara::testing;
+
+class balance_expressions_test : public ::testing::Test {
+protected:
+    binding::factory bindings;
+    storage::configurable_provider storages;
+
+    std::shared_ptr<storage::table> t0 = storages.add_table({
+            "T0",
+            {
+                    { "C0", t::int4() },
+            },
+    });
+    descriptor::variable t0c0 = bindings(t0->columns()[0]);
+
+    std::shared_ptr<storage::index> i0 = storages.add_index({ t0, "I0", });
+
+    descriptor::variable c0 = bindings.stream_variable("c0");
+
+    std::unique_ptr<scalar::expression> chain(scalar::binary_operator kind, std::size_t count) {
+        std::unique_ptr<scalar::expression> result = term(0);
+        for (std::size_t i = 1; i < count; ++i) {
+            result = std::make_unique<scalar::binary>(kind, std::move(result), term(i));
+        }
+        return result;
+    }
+
+    scalar::binary chain_value(scalar::binary_operator kind, std::size_t count) {
+        auto result = chain(kind, count);
+        return std::move(::takatori::util::unsafe_downcast<scalar::binary>(*result));
+    }
+
+    std::unique_ptr<scalar::expression> term(std::size_t index) {
+        return std::make_unique<scalar::compare>(compare(varref(c0), constant(static_cast<int>(index))));
+    }
+
+    static std::size_t depth(scalar::expression const& expr) {
+        if (expr.kind() != scalar::binary::tag) {
+            return 1;
+        }
+        auto&& binary = ::takatori::util::unsafe_downcast<scalar::binary>(expr);
+        return std::max(depth(binary.left()), depth(binary.right())) + 1;
+    }
+
+    std::vector<scalar::expression const*> terms(scalar::expression& expr) {
+        std::vector<scalar::expression const*> results {};
+        decompose_predicate(expr, [&](auto&& term) -> void {
+            results.emplace_back(std::addressof(term.get()));
+        });
+        return results;
+    }
+};
+
+TEST_F(balance_expressions_test, short_chain) {
+    auto expr = chain(scalar::binary_operator::conditional_and, 3);
+    balance_expressions(*expr);
+
+    EXPECT_EQ(*expr, (land(
+            land(
+                    compare(varref(c0), constant(0)),
+                    compare(varref(c0), constant(1))),
+            compare(varref(c0), constant(2)))));
+}
+
+TEST_F(balance_expressions_test, balance) {
+    auto expr = chain(scalar::binary_operator::conditional_and, 8);
+    balance_expressions(*expr);
+
+    EXPECT_EQ(*expr, (land(
+            land(
+                    land(
+                            compare(varref(c0), constant(0)),
+                            compare(varref(c0), constant(1))),
+                    land(
+                            compare(varref(c0), constant(2)),
+                            compare(varref(c0), constant(3)))),
+            land(
+                    land(
+                            compare(varref(c0), constant(4)),
+                            compare(varref(c0), constant(5))),
+                    land(
+                            compare(varref(c0), constant(6)),
+                            compare(varref(c0), constant(7)))))));
+}
+
+TEST_F(balance_expressions_test, mixed_operators) {
+    auto expr = chain(scalar::binary_operator::conditional_or, 4);
+    auto expr_ptr = expr.get();
+    balance_expressions(*expr, 2);
+
+    // the root node is kept
+    EXPECT_EQ(expr.get(), expr_ptr);
+    EXPECT_EQ(*expr, (lor(
+            lor(
+                    compare(varref(c0), constant(0)),
+                    compare(varref(c0), constant(1))),
+            lor(
+                    compare(varref(c0), constant(2)),
+                    compare(varref(c0), constant(3))))));
+
+    // does not merge different operators
+    auto other = std::make_unique<scalar::binary>(
+            scalar::binary_operator::conditional_and,
+            chain(scalar::binary_operator::conditional_or, 4),
+            term(4));
+    balance_expressions(*other, 2);
+    EXPECT_EQ(*other, (land(
+            lor(
+                    lor(
+                            compare(varref(c0), constant(0)),
+                            compare(varref(c0), constant(1))),
+                    lor(
+                            compare(varref(c0), constant(2)),
+                            compare(varref(c0), constant(3)))),
+            compare(varref(c0), constant(4)))));
+}
+
+TEST_F(balance_expressions_test, already_balanced) {
+    auto expr = chain(scalar::binary_operator::conditional_and, 10);
+    balance_expressions(*expr);
+    ASSERT_EQ(depth(*expr), 5);
+
+    auto&& root = ::takatori::util::unsafe_downcast<scalar::binary>(*expr);
+    auto const* left = std::addressof(root.left());
+    auto const* right = std::addressof(root.right());
+
+    // keeps the balanced chain as is
+    balance_expressions(*expr);
+    EXPECT_EQ(std::addressof(root.left()), left);
+    EXPECT_EQ(std::addressof(root.right()), right);
+    EXPECT_EQ(depth(*expr), 5);
+}
+
+TEST_F(balance_expressions_test, deep) {
+    constexpr std::size_t count = 100'000;
+    auto expr = chain(scalar::binary_operator::conditional_and, count);
+    balance_expressions(*expr);
+    EXPECT_EQ(depth(*expr), 18);
+
+    auto results = terms(*expr);
+    ASSERT_EQ(results.size(), count);
+    EXPECT_EQ(*results.front(), compare(varref(c0), constant(0)));
+    EXPECT_EQ(*results.back(), compare(varref(c0), constant(static_cast<int>(count - 1))));
+}
+
+TEST_F(balance_expressions_test, nested_coalesce) {
+    scalar::coalesce expr {
+            {
+                    constant(0),
+                    chain_value(scalar::binary_operator::conditional_and, 10),
+            },
+    };
+    balance_expressions(expr);
+
+    auto&& alternative = expr.alternatives()[1];
+    EXPECT_EQ(depth(alternative), 5);
+    EXPECT_EQ(terms(alternative).size(), 10);
+}
+
+TEST_F(balance_expressions_test, nested_conditional) {
+    scalar::conditional expr {
+            {
+                    scalar::conditional::alternative {
+                            chain_value(scalar::binary_operator::conditional_and, 10),
+                            constant(1),
+                    },
+            },
+            chain_value(scalar::binary_operator::conditional_or, 10),
+    };
+    balance_expressions(expr);
+
+    auto&& condition = expr.alternatives()[0].condition();
+    EXPECT_EQ(depth(condition), 5);
+    EXPECT_EQ(terms(condition).size(), 10);
+
+    ASSERT_TRUE(expr.default_expression());
+    EXPECT_EQ(depth(*expr.default_expression()), 5);
+}
+
+TEST_F(balance_expressions_test, graph) {
+    /*
+     * scan:r0 - filter:r1 - emit:r2
+     */
+    relation::graph_type r;
+    auto&& r0 = r.insert(relation::scan {
+            bindings(*i0),
+            {
+                    { t0c0, c0 },
+            },
+    });
+    auto&& r1 = r.insert(relation::filter {
+            chain(scalar::binary_operator::conditional_and, 10),
+    });
+    auto&& r2 = r.insert(relation::emit { c0 });
+    r0.output() >> r1.input();
+    r1.output() >> r2.input();
+
+    balance_expressions(r);
+
+    EXPECT_EQ(depth(r1.condition()), 5);
+    EXPECT_EQ(terms(r1.condition()).size(), 10);
+}
+
+TEST_F(balance_expressions_test, graph_values) {
+    /*
+     * values:r0 - emit:r1
+     */
+    relation::graph_type r;
+    auto&& r0 = r.insert(relation::values {
+            { c0 },
+            {
+                    { chain_value(scalar::binary_operator::conditional_and, 10) },
+            },
+    });
+    auto&& r1 = r.insert(relation::emit { c0 });
+    r0.output() >> r1.input();
+
+    balance_expressions(r);
+
+    auto&& value = r0.rows()[0].elements()[0];
+    EXPECT_EQ(depth(value), 5);
+    EXPECT_EQ(terms(value).size(), 10);
+}
+
+} // namespace yugawara::analyzer::details
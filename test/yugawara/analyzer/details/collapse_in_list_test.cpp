@@ -0,0 +1,172 @@
+#include <yugawara/analyzer/details/collapse_in_list.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+#include <takatori/value/unknown.h>
+
+#include <takatori/relation/scan.h>
+#include <takatori/relation/filter.h>
+#include <takatori/relation/emit.h>
+
+#include <takatori/util/clone.h>
+#include <takatori/util/downcast.h>
+
+#include <yugawara/binding/factory.h>
+#include <yugawara/storage/configurable_provider.h>
+
+#include <yugawara/testing/utils.h>
+
+namespace yugawara::analyzer::details {
+
+// import test utils
+using namespace ::yugawara::testing;
+
+class collapse_in_list_test : public ::testing::Test {
+protected:
+    binding::factory bindings;
+    storage::configurable_provider storages;
+
+    std::shared_ptr<storage::table> t0 = storages.add_table({
+            "T0",
+            {
+                    { "C0", t::int4() },
+                    { "C1", t::int4() },
+            },
+    });
+    descriptor::variable t0c0 = bindings(t0->columns()[0]);
+    descriptor::variable t0c1 = bindings(t0->columns()[1]);
+
+    std::shared_ptr<storage::index> i0 = storages.add_index({ t0, "I0", });
+
+    descriptor::variable c0 = bindings.stream_variable("c0");
+    descriptor::variable c1 = bindings.stream_variable("c1");
+
+    static std::unique_ptr<scalar::expression> apply(scalar::expression&& expr) {
+        return collapse_in_list(::takatori::util::clone_unique(std::move(expr)));
+    }
+
+    static std::size_t depth(scalar::expression const& expr) {
+        if (expr.kind() != scalar::binary::tag) {
+            return 1;
+        }
+        auto&& binary = ::takatori::util::unsafe_downcast<scalar::binary>(expr);
+        return std::max(depth(binary.left()), depth(binary.right())) + 1;
+    }
+};
+
+TEST_F(collapse_in_list_test, simple) {
+    auto result = apply(lor(
+            lor(
+                    lor(
+                            compare(varref(c0), constant(3)),
+                            compare(constant(1), varref(c0))),
+                    compare(varref(c0), constant(3))),
+            compare(varref(c0), constant(2))));
+
+    EXPECT_EQ(*result, (lor(
+            compare(constant(1), varref(c0)),
+            lor(
+                    compare(varref(c0), constant(2)),
+                    compare(varref(c0), constant(3))))));
+}
+
+TEST_F(collapse_in_list_test, heterogeneous) {
+    auto result = apply(lor(
+            lor(
+                    lor(
+                            compare(varref(c0), constant(3)),
+                            compare(varref(c1), constant(1))),
+                    compare(varref(c0), constant(3))),
+            compare(varref(c0), constant(2))));
+
+    // keeps the order of terms, only rebalances the tree
+    EXPECT_EQ(*result, (lor(
+            lor(
+                    compare(varref(c0), constant(3)),
+                    compare(varref(c1), constant(1))),
+            lor(
+                    compare(varref(c0), constant(3)),
+                    compare(varref(c0), constant(2))))));
+}
+
+TEST_F(collapse_in_list_test, null) {
+    auto result = apply(lor(
+            lor(
+                    compare(varref(c0), constant(2)),
+                    compare(varref(c0), scalar::immediate { v::unknown {}, t::int4 {} })),
+            compare(varref(c0), constant(1))));
+
+    EXPECT_EQ(*result, (lor(
+            compare(varref(c0), constant(2)),
+            lor(
+                    compare(varref(c0), scalar::immediate { v::unknown {}, t::int4 {} }),
+                    compare(varref(c0), constant(1))))));
+}
+
+TEST_F(collapse_in_list_test, conjunction) {
+    auto result = apply(land(
+            compare(varref(c1), constant(0)),
+            lor(
+                    compare(varref(c0), constant(2)),
+                    compare(varref(c0), constant(1)))));
+
+    EXPECT_EQ(*result, (land(
+            compare(varref(c1), constant(0)),
+            lor(
+                    compare(varref(c0), constant(1)),
+                    compare(varref(c0), constant(2))))));
+}
+
+TEST_F(collapse_in_list_test, large) {
+    constexpr std::size_t count = 5'000;
+    std::unique_ptr<scalar::expression> chain = std::make_unique<scalar::compare>(
+            compare(varref(c0), constant(static_cast<int>(count - 1))));
+    for (std::size_t i = 1; i < count; ++i) {
+        chain = std::make_unique<scalar::binary>(
+                scalar::binary_operator::conditional_or,
+                std::move(chain),
+                std::make_unique<scalar::compare>(compare(varref(c0), constant(static_cast<int>(count - 1 - i)))));
+    }
+    auto result = collapse_in_list(std::move(chain));
+    EXPECT_EQ(depth(*result), 14);
+
+    auto const* leftmost = result.get();
+    while (leftmost->kind() == scalar::binary::tag) {
+        leftmost = std::addressof(::takatori::util::unsafe_downcast<scalar::binary>(*leftmost).left());
+    }
+    EXPECT_EQ(*leftmost, compare(varref(c0), constant(0)));
+}
+
+TEST_F(collapse_in_list_test, graph) {
+    /*
+     * scan:r0 - filter:r1 - emit:r2
+     */
+    relation::graph_type r;
+    auto&& r0 = r.insert(relation::scan {
+            bindings(*i0),
+            {
+                    { t0c0, c0 },
+                    { t0c1, c1 },
+            },
+    });
+    auto&& r1 = r.insert(relation::filter {
+            lor(
+                    lor(
+                            compare(varref(c0), constant(2)),
+                            compare(varref(c0), constant(2))),
+                    compare(varref(c0), constant(1))),
+    });
+    auto&& r2 = r.insert(relation::emit { c0, c1 });
+    r0.output() >> r1.input();
+    r1.output() >> r2.input();
+
+    collapse_in_list(r);
+
+    EXPECT_EQ(r1.condition(), (lor(
+            compare(varref(c0), constant(1)),
+            compare(varref(c0), constant(2)))));
+}
+
+} // namespace yugawara::analyzer::details
@@ -1,5 +1,7 @@
 #include <yugawara/analyzer/details/collect_join_keys.h>
 
+#include <limits>
+
 #include <gtest/gtest.h>
 
 #include <takatori/relation/graph.h>
@@ -66,7 +68,16 @@ protected:
             relation::graph_type& graph,
             collect_join_keys_feature_set features = collect_join_keys_feature_universe) {
         flow_volume_info vinfo {};
-        collect_join_keys(graph, vinfo, features);
+        apply(graph, vinfo, features);
+    }
+
+    void apply(
+            relation::graph_type& graph,
+            flow_volume_info const& vinfo,
+            collect_join_keys_feature_set features = collect_join_keys_feature_universe,
+            std::size_t broadcast_build_size_limit = std::numeric_limits<std::size_t>::max(),
+            std::size_t broadcast_fan_out = 4) {
+        collect_join_keys(graph, vinfo, features, broadcast_build_size_limit, broadcast_fan_out, 1'000);
         remove_redundant_conditions(graph);
     }
 };
@@ -513,4 +524,256 @@ TEST_F(collect_join_keys_test, cogroup_suppress_broadcast) {
     EXPECT_EQ(join.condition(), compare(varref(cr0), constant(0), cmp::equal));
 }
 
+TEST_F(collect_join_keys_test, broadcast_size_limit) {
+    relation::graph_type r;
+    auto cl0 = bindings.stream_variable("cl0");
+    auto cl1 = bindings.stream_variable("cl0");
+    auto&& inl = r.insert(relation::scan {
+            bindings(*i0),
+            {
+                    { bindings(t0c0), cl0 },
+                    { bindings(t0c1), cl1 },
+            },
+    });
+    auto cr0 = bindings.stream_variable("cr0");
+    auto cr1 = bindings.stream_variable("cr0");
+    auto&& inr = r.insert(relation::scan {
+            bindings(*i1),
+            {
+                    { bindings(t1c0), cr0 },
+                    { bindings(t1c0), cr1 },
+            },
+    });
+    auto&& join = r.insert(relation::intermediate::join {
+            relation::join_kind::left_outer,
+            land(
+                    compare(cl0, cr0),
+                    compare(varref(cr1), constant(0), cmp::equal)),
+    });
+
+    auto&& out = r.insert(relation::emit { cl0, cr0 });
+    inl.output() >> join.left();
+    inr.output() >> join.right();
+    join.output() >> out.input();
+
+    flow_volume_info vinfo {};
+    vinfo.add(inl.output(), { 10'000, 8 });
+    vinfo.add(inr.output(), { 10'000, 8 });
+
+    apply(r, vinfo, collect_join_keys_feature_universe, 10'000);
+    EXPECT_GT(inl.output(), join.left());
+    EXPECT_GT(inr.output(), join.right());
+
+    EXPECT_EQ(join.lower().kind(), endpoint_kind::prefixed_inclusive);
+    ASSERT_EQ(join.lower().keys().size(), 1);
+    EXPECT_EQ(join.lower().keys()[0].variable(), cr0);
+    EXPECT_EQ(join.lower().keys()[0].value(), varref(cl0));
+
+    EXPECT_EQ(join.upper().kind(), endpoint_kind::prefixed_inclusive);
+    ASSERT_EQ(join.upper().keys().size(), 1);
+    EXPECT_EQ(join.upper().keys()[0].variable(), cr0);
+    EXPECT_EQ(join.upper().keys()[0].value(), varref(cl0));
+
+    EXPECT_EQ(join.condition(), compare(varref(cr1), constant(0), cmp::equal));
+}
+
+TEST_F(collect_join_keys_test, broadcast_size_limit_no_key_pairs) {
+    relation::graph_type r;
+    auto cl0 = bindings.stream_variable("cl0");
+    auto cl1 = bindings.stream_variable("cl0");
+    auto&& inl = r.insert(relation::scan {
+            bindings(*i0),
+            {
+                    { bindings(t0c0), cl0 },
+                    { bindings(t0c1), cl1 },
+            },
+    });
+    auto cr0 = bindings.stream_variable("cr0");
+    auto cr1 = bindings.stream_variable("cr0");
+    auto&& inr = r.insert(relation::scan {
+            bindings(*i1),
+            {
+                    { bindings(t1c0), cr0 },
+                    { bindings(t1c0), cr1 },
+            },
+    });
+    auto&& join = r.insert(relation::intermediate::join {
+            relation::join_kind::left_outer,
+            compare(
+                    varref { cr0 },
+                    binary {
+                            binary_operator::add,
+                            varref { cl0 },
+                            varref { cl1 },
+                    }),
+    });
+
+    auto&& out = r.insert(relation::emit { cl0, cr0 });
+    inl.output() >> join.left();
+    inr.output() >> join.right();
+    join.output() >> out.input();
+
+    flow_volume_info vinfo {};
+    vinfo.add(inl.output(), { 10, 8 });
+    vinfo.add(inr.output(), { 1'000'000, 8 });
+
+    apply(r, vinfo, collect_join_keys_feature_universe, 1'000'000);
+    EXPECT_GT(inl.output(), join.left());
+    EXPECT_GT(inr.output(), join.right());
+
+    // never broadcast the large input even if co-group gathers all rows into a single group
+    EXPECT_EQ(join.lower().kind(), endpoint_kind::unbound);
+    ASSERT_EQ(join.lower().keys().size(), 0);
+
+    EXPECT_EQ(join.upper().kind(), endpoint_kind::unbound);
+    ASSERT_EQ(join.upper().keys().size(), 0);
+
+    EXPECT_EQ(join.condition(), compare(
+            varref { cr0 },
+            binary {
+                    binary_operator::add,
+                    varref { cl0 },
+                    varref { cl1 },
+            }));
+}
+
+TEST_F(collect_join_keys_test, broadcast_size_limit_no_key_pairs_both) {
+    relation::graph_type r;
+    auto cl0 = bindings.stream_variable("cl0");
+    auto&& inl = r.insert(relation::scan {
+            bindings(*i0),
+            {
+                    { bindings(t0c0), cl0 },
+            },
+    });
+    auto cr0 = bindings.stream_variable("cr0");
+    auto&& inr = r.insert(relation::scan {
+            bindings(*i1),
+            {
+                    { bindings(t1c0), cr0 },
+            },
+    });
+    auto&& join = r.insert(relation::intermediate::join {
+            relation::join_kind::inner,
+            compare(cl0, cr0, cmp::less),
+    });
+
+    auto&& out = r.insert(relation::emit { cl0, cr0 });
+    inl.output() >> join.left();
+    inr.output() >> join.right();
+    join.output() >> out.input();
+
+    flow_volume_info vinfo {};
+    vinfo.add(inl.output(), { 1'000'000, 8 });
+    vinfo.add(inr.output(), { 1'000'000, 8 });
+
+    apply(r, vinfo, collect_join_keys_feature_universe, 1'000'000);
+    EXPECT_GT(inl.output(), join.left());
+    EXPECT_GT(inr.output(), join.right());
+
+    // neither input can be broadcast
+    EXPECT_EQ(join.lower().kind(), endpoint_kind::unbound);
+    ASSERT_EQ(join.lower().keys().size(), 0);
+
+    EXPECT_EQ(join.upper().kind(), endpoint_kind::unbound);
+    ASSERT_EQ(join.upper().keys().size(), 0);
+
+    EXPECT_EQ(join.condition(), compare(cl0, cr0, cmp::less));
+}
+
+TEST_F(collect_join_keys_test, broadcast_cost) {
+    relation::graph_type r;
+    auto cl0 = bindings.stream_variable("cl0");
+    auto&& inl = r.insert(relation::scan {
+            bindings(*i0),
+            {
+                    { bindings(t0c0), cl0 },
+            },
+    });
+    auto cr0 = bindings.stream_variable("cr0");
+    auto cr1 = bindings.stream_variable("cr1");
+    auto&& inr = r.insert(relation::scan {
+            bindings(*i1),
+            {
+                    { bindings(t1c0), cr0 },
+                    { bindings(t1c1), cr1 },
+            },
+    });
+    auto&& join = r.insert(relation::intermediate::join {
+            relation::join_kind::left_outer,
+            land(
+                    compare(cl0, cr0),
+                    compare(varref(cr1), constant(0), cmp::equal)),
+    });
+
+    auto&& out = r.insert(relation::emit { cl0, cr0 });
+    inl.output() >> join.left();
+    inr.output() >> join.right();
+    join.output() >> out.input();
+
+    flow_volume_info vinfo {};
+    vinfo.add(inl.output(), { 1'000'000, 8 });
+    vinfo.add(inr.output(), { 10'000, 8 });
+
+    apply(r, vinfo);
+    EXPECT_GT(inl.output(), join.left());
+    EXPECT_GT(inr.output(), join.right());
+
+    // broadcast the smaller right input
+    EXPECT_EQ(join.lower().kind(), endpoint_kind::prefixed_inclusive);
+    ASSERT_EQ(join.lower().keys().size(), 2);
+    EXPECT_EQ(join.lower().keys()[0].variable(), cr0);
+    EXPECT_EQ(join.lower().keys()[0].value(), varref(cl0));
+    EXPECT_EQ(join.lower().keys()[1].variable(), cr1);
+    EXPECT_EQ(join.lower().keys()[1].value(), constant(0));
+    EXPECT_EQ(join.condition(), nullptr);
+}
+
+TEST_F(collect_join_keys_test, broadcast_fan_out) {
+    relation::graph_type r;
+    auto cl0 = bindings.stream_variable("cl0");
+    auto&& inl = r.insert(relation::scan {
+            bindings(*i0),
+            {
+                    { bindings(t0c0), cl0 },
+            },
+    });
+    auto cr0 = bindings.stream_variable("cr0");
+    auto cr1 = bindings.stream_variable("cr1");
+    auto&& inr = r.insert(relation::scan {
+            bindings(*i1),
+            {
+                    { bindings(t1c0), cr0 },
+                    { bindings(t1c1), cr1 },
+            },
+    });
+    auto&& join = r.insert(relation::intermediate::join {
+            relation::join_kind::left_outer,
+            land(
+                    compare(cl0, cr0),
+                    compare(varref(cr1), constant(0), cmp::equal)),
+    });
+
+    auto&& out = r.insert(relation::emit { cl0, cr0 });
+    inl.output() >> join.left();
+    inr.output() >> join.right();
+    join.output() >> out.input();
+
+    flow_volume_info vinfo {};
+    vinfo.add(inl.output(), { 1'000'000, 8 });
+    vinfo.add(inr.output(), { 10'000, 8 });
+
+    // 10'000 * 8 * 1'000 > (1'000'000 + 10'000) * 8
+    apply(r, vinfo, collect_join_keys_feature_universe, std::numeric_limits<std::size_t>::max(), 1'000);
+    EXPECT_GT(inl.output(), join.left());
+    EXPECT_GT(inr.output(), join.right());
+
+    // co-group is cheaper than broadcast to many consumers
+    EXPECT_EQ(join.lower().kind(), endpoint_kind::prefixed_inclusive);
+    ASSERT_EQ(join.lower().keys().size(), 1);
+    EXPECT_EQ(join.lower().keys()[0].variable(), cr0);
+    EXPECT_EQ(join.lower().keys()[0].value(), varref(cl0));
+    EXPECT_EQ(join.condition(), compare(varref(cr1), constant(0), cmp::equal));
+}
+
 } // namespace yugawara::analyzer::details
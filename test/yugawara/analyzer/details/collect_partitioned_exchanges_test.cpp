@@ -0,0 +1,284 @@
+#include <yugawara/analyzer/details/collect_partitioned_exchanges.h>
+
+#include <gtest/gtest.h>
+
+#include <takatori/relation/step/join.h>
+
+#include <takatori/plan/graph.h>
+#include <takatori/plan/process.h>
+#include <takatori/plan/group.h>
+
+#include <yugawara/binding/factory.h>
+
+#include <yugawara/testing/utils.h>
+
+namespace yugawara::analyzer::details {
+
+// import test utils
+using namespace ::yugawara::testing;
+
+class collect_partitioned_exchanges_test : public ::testing::Test {
+protected:
+    binding::factory bindings;
+
+    plan::group& group(plan::graph_type& p, descriptor::variable const& k, descriptor::variable const& v) {
+        return p.insert(plan::group {
+                { k, v, },
+                { k, },
+        });
+    }
+};
+
+TEST_F(collect_partitioned_exchanges_test, take_group) {
+    /*
+     * [take_group:r0 - offer:ro]:p0
+     * e0 { k0, v0 } GROUP BY k0
+     * e1 { k1, v1 } GROUP BY k1
+     */
+    plan::graph_type p;
+    auto k0 = bindings.exchange_column("k0");
+    auto v0 = bindings.exchange_column("v0");
+    auto k1 = bindings.exchange_column("k1");
+    auto v1 = bindings.exchange_column("v1");
+    auto&& e0 = group(p, k0, v0);
+    auto&& e1 = group(p, k1, v1);
+
+    auto c0 = bindings.stream_variable("c0");
+    auto c1 = bindings.stream_variable("c1");
+    auto&& p0 = p.insert(plan::process {});
+    auto& r0 = p0.operators().insert(take_group {
+            bindings(e0),
+            {
+                    { k0, c0 },
+                    { v0, c1 },
+            },
+    });
+    auto& ro = p0.operators().insert(offer {
+            bindings(e1),
+            {
+                    { c0, k1 },
+                    { c1, v1 },
+            },
+    });
+    r0.output() >> ro.input();
+
+    auto results = collect_partitioned_exchanges(p);
+    EXPECT_TRUE(results.find(std::addressof(e1)) != results.end());
+    EXPECT_TRUE(results.find(std::addressof(e0)) == results.end());
+}
+
+TEST_F(collect_partitioned_exchanges_test, different_keys) {
+    /*
+     * [take_group:r0 - offer:ro]:p0
+     * e0 { k0, v0 } GROUP BY k0
+     * e1 { k1, v1 } GROUP BY k1, but k1 comes from v0
+     */
+    plan::graph_type p;
+    auto k0 = bindings.exchange_column("k0");
+    auto v0 = bindings.exchange_column("v0");
+    auto k1 = bindings.exchange_column("k1");
+    auto v1 = bindings.exchange_column("v1");
+    auto&& e0 = group(p, k0, v0);
+    auto&& e1 = group(p, k1, v1);
+
+    auto c0 = bindings.stream_variable("c0");
+    auto c1 = bindings.stream_variable("c1");
+    auto&& p0 = p.insert(plan::process {});
+    auto& r0 = p0.operators().insert(take_group {
+            bindings(e0),
+            {
+                    { k0, c0 },
+                    { v0, c1 },
+            },
+    });
+    auto& ro = p0.operators().insert(offer {
+            bindings(e1),
+            {
+                    { c1, k1 },
+                    { c0, v1 },
+            },
+    });
+    r0.output() >> ro.input();
+
+    auto results = collect_partitioned_exchanges(p);
+    EXPECT_TRUE(results.empty());
+}
+
+TEST_F(collect_partitioned_exchanges_test, take_cogroup_left_outer) {
+    /*
+     * [take_cogroup:r0 - join:r1 - offer:ro]:p0
+     * e0 { k0, v0 } GROUP BY k0
+     * e1 { k1, v1 } GROUP BY k1
+     * join { LEFT OUTER }
+     * e2 { k2, v2 } GROUP BY k2, from the left key
+     */
+    plan::graph_type p;
+    auto k0 = bindings.exchange_column("k0");
+    auto v0 = bindings.exchange_column("v0");
+    auto k1 = bindings.exchange_column("k1");
+    auto v1 = bindings.exchange_column("v1");
+    auto k2 = bindings.exchange_column("k2");
+    auto v2 = bindings.exchange_column("v2");
+    auto&& e0 = group(p, k0, v0);
+    auto&& e1 = group(p, k1, v1);
+    auto&& e2 = group(p, k2, v2);
+
+    auto l0 = bindings.stream_variable("l0");
+    auto l1 = bindings.stream_variable("l1");
+    auto r0c0 = bindings.stream_variable("r0");
+    auto r0c1 = bindings.stream_variable("r1");
+    auto&& p0 = p.insert(plan::process {});
+    auto& r0 = p0.operators().insert(take_cogroup {
+            {
+                    bindings(e0),
+                    {
+                            { k0, l0 },
+                            { v0, l1 },
+                    },
+            },
+            {
+                    bindings(e1),
+                    {
+                            { k1, r0c0 },
+                            { v1, r0c1 },
+                    },
+            },
+    });
+    auto& r1 = p0.operators().insert(relation::step::join {
+            relation::join_kind::left_outer,
+    });
+    auto& ro = p0.operators().insert(offer {
+            bindings(e2),
+            {
+                    { l0, k2 },
+                    { r0c1, v2 },
+            },
+    });
+    r0.output() >> r1.input();
+    r1.output() >> ro.input();
+
+    auto results = collect_partitioned_exchanges(p);
+    EXPECT_TRUE(results.find(std::addressof(e2)) != results.end());
+}
+
+TEST_F(collect_partitioned_exchanges_test, take_cogroup_null_supplied) {
+    /*
+     * [take_cogroup:r0 - join:r1 - offer:ro]:p0
+     * e0 { k0, v0 } GROUP BY k0
+     * e1 { k1, v1 } GROUP BY k1
+     * join { LEFT OUTER }
+     * e2 { k2, v2 } GROUP BY k2, from the right key
+     */
+    plan::graph_type p;
+    auto k0 = bindings.exchange_column("k0");
+    auto v0 = bindings.exchange_column("v0");
+    auto k1 = bindings.exchange_column("k1");
+    auto v1 = bindings.exchange_column("v1");
+    auto k2 = bindings.exchange_column("k2");
+    auto v2 = bindings.exchange_column("v2");
+    auto&& e0 = group(p, k0, v0);
+    auto&& e1 = group(p, k1, v1);
+    auto&& e2 = group(p, k2, v2);
+
+    auto l0 = bindings.stream_variable("l0");
+    auto l1 = bindings.stream_variable("l1");
+    auto r0c0 = bindings.stream_variable("r0");
+    auto r0c1 = bindings.stream_variable("r1");
+    auto&& p0 = p.insert(plan::process {});
+    auto& r0 = p0.operators().insert(take_cogroup {
+            {
+                    bindings(e0),
+                    {
+                            { k0, l0 },
+                            { v0, l1 },
+                    },
+            },
+            {
+                    bindings(e1),
+                    {
+                            { k1, r0c0 },
+                            { v1, r0c1 },
+                    },
+            },
+    });
+    auto& r1 = p0.operators().insert(relation::step::join {
+            relation::join_kind::left_outer,
+    });
+    auto& ro = p0.operators().insert(offer {
+            bindings(e2),
+            {
+                    { r0c0, k2 },
+                    { l1, v2 },
+            },
+    });
+    r0.output() >> r1.input();
+    r1.output() >> ro.input();
+
+    // the right keys become null in the unmatched records
+    auto results = collect_partitioned_exchanges(p);
+    EXPECT_TRUE(results.empty());
+}
+
+TEST_F(collect_partitioned_exchanges_test, multiple_sources) {
+    /*
+     * [take_group:r0 - offer:ro0]:p0
+     * [take_group:r1 - offer:ro1]:p1
+     * e0 { k0, v0 } GROUP BY k0
+     * e1 { k1, v1 } GROUP BY k1
+     * e2 { k2, v2 } GROUP BY k2, from e0.k0 and e1.v1
+     */
+    plan::graph_type p;
+    auto k0 = bindings.exchange_column("k0");
+    auto v0 = bindings.exchange_column("v0");
+    auto k1 = bindings.exchange_column("k1");
+    auto v1 = bindings.exchange_column("v1");
+    auto k2 = bindings.exchange_column("k2");
+    auto v2 = bindings.exchange_column("v2");
+    auto&& e0 = group(p, k0, v0);
+    auto&& e1 = group(p, k1, v1);
+    auto&& e2 = group(p, k2, v2);
+
+    auto a0 = bindings.stream_variable("a0");
+    auto a1 = bindings.stream_variable("a1");
+    auto&& p0 = p.insert(plan::process {});
+    auto& r0 = p0.operators().insert(take_group {
+            bindings(e0),
+            {
+                    { k0, a0 },
+                    { v0, a1 },
+            },
+    });
+    auto& ro0 = p0.operators().insert(offer {
+            bindings(e2),
+            {
+                    { a0, k2 },
+                    { a1, v2 },
+            },
+    });
+    r0.output() >> ro0.input();
+
+    auto b0 = bindings.stream_variable("b0");
+    auto b1 = bindings.stream_variable("b1");
+    auto&& p1 = p.insert(plan::process {});
+    auto& r1 = p1.operators().insert(take_group {
+            bindings(e1),
+            {
+                    { k1, b0 },
+                    { v1, b1 },
+            },
+    });
+    auto& ro1 = p1.operators().insert(offer {
+            bindings(e2),
+            {
+                    { b1, k2 },
+                    { b0, v2 },
+            },
+    });
+    r1.output() >> ro1.input();
+
+    // the records from p1 are not partitioned by k2
+    auto results = collect_partitioned_exchanges(p);
+    EXPECT_TRUE(results.empty());
+}
+
+} // namespace yugawara::analyzer::details
@@ -0,0 +1,196 @@
+#include <yugawara/analyzer/details/eliminate_common_subexpressions.h>
+
+#include <gtest/gtest.h>
+
+#include <takatori/scalar/binary.h>
+
+#include <takatori/relation/scan.h>
+#include <takatori/relation/project.h>
+#include <takatori/relation/filter.h>
+#include <takatori/relation/emit.h>
+#include <takatori/relation/intermediate/join.h>
+
+#include <yugawara/binding/factory.h>
+#include <yugawara/storage/configurable_provider.h>
+
+#include <yugawara/testing/utils.h>
+
+namespace yugawara::analyzer::details {
+
+// import test utils
+using namespace ::yugawara::testing;
+
+using ::takatori::scalar::binary;
+using ::takatori::scalar::binary_operator;
+
+using cmp = ::takatori::scalar::comparison_operator;
+
+class eliminate_common_subexpressions_test : public ::testing::Test {
+protected:
+    binding::factory bindings;
+    storage::configurable_provider storages;
+
+    std::shared_ptr<storage::table> t0 = storages.add_table({
+            "T0",
+            {
+                    { "C0", t::int4() },
+                    { "C1", t::int4() },
+            },
+    });
+    descriptor::variable t0c0 = bindings(t0->columns()[0]);
+    descriptor::variable t0c1 = bindings(t0->columns()[1]);
+
+    std::shared_ptr<storage::index> i0 = storages.add_index({ t0, "I0", });
+
+    relation::scan& scan(relation::graph_type& r, descriptor::variable c0, descriptor::variable c1) {
+        return r.insert(relation::scan {
+                bindings(*i0),
+                {
+                        { t0c0, std::move(c0) },
+                        { t0c1, std::move(c1) },
+                },
+        });
+    }
+
+    static binary mul(descriptor::variable const& a, descriptor::variable const& b) {
+        return binary { binary_operator::multiply, varref { a }, varref { b } };
+    }
+};
+
+TEST_F(eliminate_common_subexpressions_test, project) {
+    /*
+     * scan:r0 - project:r1 - emit:ro
+     * project { x := c0 * c1 + 1, y := c0 * c1 - 1 }
+     */
+    relation::graph_type r;
+    auto c0 = bindings.stream_variable("c0");
+    auto c1 = bindings.stream_variable("c1");
+    auto x = bindings.stream_variable("x");
+    auto y = bindings.stream_variable("y");
+    auto&& r0 = scan(r, c0, c1);
+    auto&& r1 = r.insert(relation::project {
+            relation::project::column { x, binary { binary_operator::add, mul(c0, c1), constant(1) } },
+            relation::project::column { y, binary { binary_operator::subtract, mul(c0, c1), constant(1) } },
+    });
+    auto&& ro = r.insert(relation::emit { x, y });
+    r0.output() >> r1.input();
+    r1.output() >> ro.input();
+
+    eliminate_common_subexpressions(r);
+
+    ASSERT_EQ(r.size(), 4);
+    auto&& p = next<relation::project>(r0.output());
+    ASSERT_EQ(p.columns().size(), 1);
+    auto&& cse = p.columns()[0];
+    EXPECT_EQ(cse.value(), mul(c0, c1));
+    EXPECT_EQ(&next<relation::project>(p.output()), &r1);
+
+    auto&& columns = r1.columns();
+    ASSERT_EQ(columns.size(), 2);
+    EXPECT_EQ(columns[0].value(), (binary { binary_operator::add, varref { cse.variable() }, constant(1) }));
+    EXPECT_EQ(columns[1].value(), (binary { binary_operator::subtract, varref { cse.variable() }, constant(1) }));
+}
+
+TEST_F(eliminate_common_subexpressions_test, reuse_upstream) {
+    /*
+     * scan:r0 - project:r1 - filter:r2 - emit:ro
+     * project { x := c0 * c1 }
+     * filter { c0 * c1 > 10 }
+     */
+    relation::graph_type r;
+    auto c0 = bindings.stream_variable("c0");
+    auto c1 = bindings.stream_variable("c1");
+    auto x = bindings.stream_variable("x");
+    auto&& r0 = scan(r, c0, c1);
+    auto&& r1 = r.insert(relation::project {
+            relation::project::column { x, mul(c0, c1) },
+    });
+    auto&& r2 = r.insert(relation::filter {
+            compare(mul(c0, c1), constant(10), cmp::greater),
+    });
+    auto&& ro = r.insert(relation::emit { x });
+    r0.output() >> r1.input();
+    r1.output() >> r2.input();
+    r2.output() >> ro.input();
+
+    eliminate_common_subexpressions(r);
+
+    ASSERT_EQ(r.size(), 4);
+    EXPECT_EQ(r1.columns()[0].value(), mul(c0, c1));
+    EXPECT_EQ(r2.condition(), compare(varref { x }, constant(10), cmp::greater));
+}
+
+TEST_F(eliminate_common_subexpressions_test, conditional) {
+    /*
+     * scan:r0 - filter:r1 - emit:ro
+     * filter { c0 <> 0 AND c1 / c0 > 1 AND c1 / c0 < 5 }
+     */
+    relation::graph_type r;
+    auto c0 = bindings.stream_variable("c0");
+    auto c1 = bindings.stream_variable("c1");
+    auto&& r0 = scan(r, c0, c1);
+    auto div = [&]() {
+        return binary { binary_operator::divide, varref { c1 }, varref { c0 } };
+    };
+    auto&& r1 = r.insert(relation::filter {
+            land(
+                    land(
+                            compare(varref { c0 }, constant(0), cmp::not_equal),
+                            compare(div(), constant(1), cmp::greater)),
+                    compare(div(), constant(5), cmp::less)),
+    });
+    auto&& ro = r.insert(relation::emit { c0 });
+    r0.output() >> r1.input();
+    r1.output() >> ro.input();
+
+    eliminate_common_subexpressions(r);
+
+    // the division may raise an error, so that it must not be computed before its guard
+    ASSERT_EQ(r.size(), 3);
+    EXPECT_EQ(r1.condition(), land(
+            land(
+                    compare(varref { c0 }, constant(0), cmp::not_equal),
+                    compare(div(), constant(1), cmp::greater)),
+            compare(div(), constant(5), cmp::less)));
+}
+
+TEST_F(eliminate_common_subexpressions_test, outer_join) {
+    /*
+     * scan:r0 ----------------\
+     *                          join:r3 - filter:r4 - emit:ro
+     * scan:r1 - project:r2 ---/
+     * project { x := c0 * c1 }
+     * join { LEFT OUTER }
+     * filter { c0 * c1 > 10 }
+     */
+    relation::graph_type r;
+    auto l0 = bindings.stream_variable("l0");
+    auto l1 = bindings.stream_variable("l1");
+    auto c0 = bindings.stream_variable("c0");
+    auto c1 = bindings.stream_variable("c1");
+    auto x = bindings.stream_variable("x");
+    auto&& r0 = scan(r, l0, l1);
+    auto&& r1 = scan(r, c0, c1);
+    auto&& r2 = r.insert(relation::project {
+            relation::project::column { x, mul(c0, c1) },
+    });
+    auto&& r3 = r.insert(relation::intermediate::join {
+            relation::join_kind::left_outer,
+    });
+    auto&& r4 = r.insert(relation::filter {
+            compare(mul(c0, c1), constant(10), cmp::greater),
+    });
+    auto&& ro = r.insert(relation::emit { l0, x });
+    r0.output() >> r3.left();
+    r1.output() >> r2.input();
+    r2.output() >> r3.right();
+    r3.output() >> r4.input();
+    r4.output() >> ro.input();
+
+    eliminate_common_subexpressions(r);
+
+    // x may be null even if c0 * c1 is not null
+    EXPECT_EQ(r4.condition(), compare(mul(c0, c1), constant(10), cmp::greater));
+}
+
+} // namespace yugawara::analyzer::details
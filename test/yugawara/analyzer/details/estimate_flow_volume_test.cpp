@@ -0,0 +1,212 @@
+#include <yugawara/analyzer/details/estimate_flow_volume.h>
+
+#include <gtest/gtest.h>
+
+#include <takatori/type/primitive.h>
+
+#include <takatori/relation/graph.h>
+#include <takatori/relation/scan.h>
+#include <takatori/relation/filter.h>
+#include <takatori/relation/project.h>
+#include <takatori/relation/values.h>
+#include <takatori/relation/emit.h>
+
+#include <yugawara/binding/factory.h>
+#include <yugawara/storage/configurable_provider.h>
+
+#include <yugawara/analyzer/details/default_index_estimator.h>
+
+#include <yugawara/testing/utils.h>
+
+namespace yugawara::analyzer::details {
+
+// import test utils
+using namespace ::yugawara::testing;
+
+using ::takatori::util::sequence_view;
+
+class estimate_flow_volume_test: public ::testing::Test {
+protected:
+    binding::factory bindings {};
+
+    storage::configurable_provider storages;
+
+    std::shared_ptr<storage::table> t0 = storages.add_table({
+            "T0",
+            {
+                    { "C0", t::int4() },
+                    { "C1", t::int8() },
+                    { "C2", t::int4() },
+            },
+    });
+    storage::column const& t0c0 = t0->columns()[0];
+    storage::column const& t0c1 = t0->columns()[1];
+    storage::column const& t0c2 = t0->columns()[2];
+
+    std::shared_ptr<storage::index> i0 = storages.add_index({ t0, "I0", { t0c0 }, });
+
+    /**
+     * @brief returns 1,000 rows for full scan, or 10 rows for scan with search keys.
+     */
+    class counting_estimator : public index_estimator {
+    public:
+        [[nodiscard]] result operator()(
+                storage::index const&,
+                sequence_view<search_key const> search_keys,
+                sequence_view<sort_key const>,
+                sequence_view<column_ref const>) const override {
+            return { 1.0, search_keys.empty() ? 1'000 : 10, {} };
+        }
+    };
+
+    static std::optional<exchange_column_shape> shape_of(::takatori::type::data const& type) {
+        if (type == t::int4()) {
+            return exchange_column_shape { 4, 4 };
+        }
+        if (type == t::int8()) {
+            return exchange_column_shape { 8, 8 };
+        }
+        return {};
+    }
+};
+
+TEST_F(estimate_flow_volume_test, scan) {
+    relation::graph_type r;
+    auto c0 = bindings.stream_variable("c0");
+    auto c1 = bindings.stream_variable("c1");
+    auto&& in = r.insert(relation::scan {
+            bindings(*i0),
+            {
+                    { bindings(t0c0), c0 },
+                    { bindings(t0c1), c1 },
+            },
+    });
+    auto&& out = r.insert(relation::emit { c0 });
+    in.output() >> out.input();
+
+    auto result = estimate_flow_volume(r, counting_estimator {}, shape_of);
+
+    auto vol = result.find(out.input());
+    ASSERT_TRUE(vol);
+    EXPECT_EQ(vol->row_count, 1'000);
+    EXPECT_EQ(vol->column_size, 4 + 8);
+}
+
+TEST_F(estimate_flow_volume_test, scan_without_shapes) {
+    relation::graph_type r;
+    auto c0 = bindings.stream_variable("c0");
+    auto c1 = bindings.stream_variable("c1");
+    auto&& in = r.insert(relation::scan {
+            bindings(*i0),
+            {
+                    { bindings(t0c0), c0 },
+                    { bindings(t0c1), c1 },
+            },
+    });
+    auto&& out = r.insert(relation::emit { c0 });
+    in.output() >> out.input();
+
+    auto result = estimate_flow_volume(r, counting_estimator {}, {});
+
+    auto vol = result.find(out.input());
+    ASSERT_TRUE(vol);
+    EXPECT_EQ(vol->row_count, 1'000);
+    EXPECT_GT(vol->column_size, 0);
+}
+
+TEST_F(estimate_flow_volume_test, scan_unknown_count) {
+    relation::graph_type r;
+    auto c0 = bindings.stream_variable("c0");
+    auto&& in = r.insert(relation::scan {
+            bindings(*i0),
+            {
+                    { bindings(t0c0), c0 },
+            },
+    });
+    auto&& out = r.insert(relation::emit { c0 });
+    in.output() >> out.input();
+
+    auto result = estimate_flow_volume(r, default_index_estimator {}, shape_of);
+
+    EXPECT_FALSE(result.find(out.input()));
+}
+
+TEST_F(estimate_flow_volume_test, filter) {
+    relation::graph_type r;
+    auto c0 = bindings.stream_variable("c0");
+    auto c2 = bindings.stream_variable("c2");
+    auto&& in = r.insert(relation::scan {
+            bindings(*i0),
+            {
+                    { bindings(t0c0), c0 },
+                    { bindings(t0c2), c2 },
+            },
+    });
+    auto&& f0 = r.insert(relation::filter {
+            compare(varref(c0), constant(1)),
+    });
+    auto&& out = r.insert(relation::emit { c0 });
+    in.output() >> f0.input();
+    f0.output() >> out.input();
+
+    auto result = estimate_flow_volume(r, counting_estimator {}, shape_of);
+
+    // estimated with search keys from the filter
+    auto vol = result.find(out.input());
+    ASSERT_TRUE(vol);
+    EXPECT_EQ(vol->row_count, 10);
+    EXPECT_EQ(vol->column_size, 4 + 4);
+}
+
+TEST_F(estimate_flow_volume_test, project) {
+    relation::graph_type r;
+    auto c0 = bindings.stream_variable("c0");
+    auto&& in = r.insert(relation::scan {
+            bindings(*i0),
+            {
+                    { bindings(t0c0), c0 },
+            },
+    });
+    auto x0 = bindings.stream_variable("x0");
+    auto&& p0 = r.insert(relation::project {
+            relation::project::column {
+                    varref { c0 },
+                    x0,
+            },
+    });
+    auto&& out = r.insert(relation::emit { x0 });
+    in.output() >> p0.input();
+    p0.output() >> out.input();
+
+    auto result = estimate_flow_volume(r, counting_estimator {}, shape_of);
+
+    auto scan_vol = result.find(p0.input());
+    ASSERT_TRUE(scan_vol);
+    auto vol = result.find(out.input());
+    ASSERT_TRUE(vol);
+    EXPECT_EQ(vol->row_count, 1'000);
+    EXPECT_GT(vol->column_size, scan_vol->column_size);
+}
+
+TEST_F(estimate_flow_volume_test, values) {
+    relation::graph_type r;
+    auto c0 = bindings.stream_variable("c0");
+    auto&& in = r.insert(relation::values {
+            { c0 },
+            {
+                    { constant(1) },
+                    { constant(2) },
+                    { constant(3) },
+            },
+    });
+    auto&& out = r.insert(relation::emit { c0 });
+    in.output() >> out.input();
+
+    auto result = estimate_flow_volume(r, counting_estimator {}, shape_of);
+
+    auto vol = result.find(out.input());
+    ASSERT_TRUE(vol);
+    EXPECT_EQ(vol->row_count, 3);
+}
+
+} // namespace yugawara::analyzer::details
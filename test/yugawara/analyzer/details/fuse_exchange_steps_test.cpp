@@ -0,0 +1,248 @@
+#include <yugawara/analyzer/details/fuse_exchange_steps.h>
+
+#include <gtest/gtest.h>
+
+#include <takatori/type/primitive.h>
+
+#include <takatori/relation/scan.h>
+#include <takatori/relation/emit.h>
+
+#include <takatori/relation/intermediate/distinct.h>
+#include <takatori/relation/intermediate/limit.h>
+#include <takatori/relation/intermediate/union.h>
+
+#include <takatori/plan/graph.h>
+#include <takatori/plan/forward.h>
+#include <takatori/plan/group.h>
+
+#include <yugawara/binding/factory.h>
+#include <yugawara/storage/configurable_provider.h>
+
+#include <yugawara/analyzer/details/collect_exchange_steps.h>
+
+#include <yugawara/testing/utils.h>
+
+namespace yugawara::analyzer::details {
+
+// import test utils
+using namespace ::yugawara::testing;
+
+class fuse_exchange_steps_test : public ::testing::Test {
+protected:
+    binding::factory bindings;
+
+    storage::configurable_provider storages;
+
+    std::shared_ptr<storage::table> t0 = storages.add_table({
+            "T0",
+            {
+                    { "C0", t::int4() },
+                    { "C1", t::int4() },
+            },
+    });
+    descriptor::variable t0c0 = bindings(t0->columns()[0]);
+    descriptor::variable t0c1 = bindings(t0->columns()[1]);
+
+    std::shared_ptr<storage::index> i0 = storages.add_index({ t0, "I0", });
+
+    relation::scan& scan(relation::graph_type& r, descriptor::variable c0, descriptor::variable c1) {
+        return r.insert(relation::scan {
+                bindings(*i0),
+                {
+                        { t0c0, std::move(c0) },
+                        { t0c1, std::move(c1) },
+                },
+        });
+    }
+
+    void apply(relation::graph_type& r, plan::graph_type& p) {
+        step_plan_builder_options options {};
+        collect_exchange_steps(r, p, options);
+        fuse_exchange_steps(r, p);
+    }
+};
+
+TEST_F(fuse_exchange_steps_test, union_all_distinct) {
+    /*
+     * scan:r0 -\
+     *           union:r2 - distinct:r3 - emit:r4
+     * scan:r1 -/
+     */
+    relation::graph_type r;
+    auto cl0 = bindings.stream_variable("cl0");
+    auto cl1 = bindings.stream_variable("cl1");
+    auto cr0 = bindings.stream_variable("cr0");
+    auto cr1 = bindings.stream_variable("cr1");
+    auto co0 = bindings.stream_variable("co0");
+    auto co1 = bindings.stream_variable("co1");
+    auto& r0 = scan(r, cl0, cl1);
+    auto& r1 = scan(r, cr0, cr1);
+    auto& r2 = r.insert(relation::intermediate::union_ {
+            {
+                    { cl0, cr0, co0, },
+                    { cl1, cr1, co1, },
+            },
+            relation::set_quantifier::all,
+    });
+    auto& r3 = r.insert(relation::intermediate::distinct {
+            co0,
+    });
+    auto& r4 = r.insert(relation::emit {
+            co0,
+            co1,
+    });
+    r0.output() >> r2.left();
+    r1.output() >> r2.right();
+    r2.output() >> r3.input();
+    r3.output() >> r4.input();
+
+    plan::graph_type p;
+    apply(r, p);
+
+    /*
+     * scan:r0 - offer:r5 -\
+     *                      [group]:e0 - take_group:r7 - flatten:r8 - emit:r4
+     * scan:r1 - offer:r6 -/
+     */
+    ASSERT_EQ(p.size(), 1);
+    ASSERT_EQ(r.size(), 7);
+
+    auto&& r5 = next<offer>(r0.output());
+    auto&& r6 = next<offer>(r1.output());
+    auto&& r8 = next<flatten>(r4.input());
+    auto&& r7 = next<take_group>(r8.input());
+
+    auto&& e0 = resolve<plan::group>(r5.destination());
+    EXPECT_TRUE(p.contains(e0));
+    EXPECT_EQ(r6.destination(), r5.destination());
+    EXPECT_EQ(r7.source(), r5.destination());
+
+    ASSERT_EQ(r5.columns().size(), 2);
+    EXPECT_EQ(r5.columns()[0].source(), cl0);
+    EXPECT_EQ(r5.columns()[0].destination(), co0);
+
+    ASSERT_EQ(e0.group_keys().size(), 1);
+    EXPECT_EQ(e0.group_keys()[0], co0);
+}
+
+TEST_F(fuse_exchange_steps_test, limit_top_n) {
+    /*
+     * scan:r0 - limit:r1 - limit:r2 - emit:r3
+     * limit:r1 { count=100, sort=c0 }
+     * limit:r2 { count=10 }
+     */
+    relation::graph_type r;
+    auto c0 = bindings.stream_variable("c0");
+    auto c1 = bindings.stream_variable("c1");
+    auto& r0 = scan(r, c0, c1);
+    auto& r1 = r.insert(relation::intermediate::limit {
+            100,
+            {},
+            {
+                    c0,
+            },
+    });
+    auto& r2 = r.insert(relation::intermediate::limit {
+            10,
+    });
+    auto& r3 = r.insert(relation::emit {
+            c0,
+    });
+    r0.output() >> r1.input();
+    r1.output() >> r2.input();
+    r2.output() >> r3.input();
+
+    plan::graph_type p;
+    apply(r, p);
+
+    /*
+     * scan:r0 - offer:r4 - [group{sort=c0, limit=10}]:e0 - take_group:r5 - flatten:r6 - emit:r3
+     */
+    ASSERT_EQ(p.size(), 1);
+    ASSERT_EQ(r.size(), 5);
+
+    auto&& r4 = next<offer>(r0.output());
+    auto&& r6 = next<flatten>(r3.input());
+    auto&& r5 = next<take_group>(r6.input());
+
+    auto&& e0 = resolve<plan::group>(r4.destination());
+    EXPECT_EQ(r5.source(), r4.destination());
+    EXPECT_EQ(e0.group_keys().size(), 0);
+    EXPECT_EQ(e0.sort_keys().size(), 1);
+    EXPECT_EQ(e0.limit(), 10);
+}
+
+TEST_F(fuse_exchange_steps_test, limit_keep) {
+    /*
+     * scan:r0 - distinct:r1 - limit:r2 - emit:r3
+     * limit:r2 { count=10 }
+     */
+    relation::graph_type r;
+    auto c0 = bindings.stream_variable("c0");
+    auto c1 = bindings.stream_variable("c1");
+    auto& r0 = scan(r, c0, c1);
+    auto& r1 = r.insert(relation::intermediate::distinct {
+            c0,
+    });
+    auto& r2 = r.insert(relation::intermediate::limit {
+            10,
+    });
+    auto& r3 = r.insert(relation::emit {
+            c0,
+    });
+    r0.output() >> r1.input();
+    r1.output() >> r2.input();
+    r2.output() >> r3.input();
+
+    plan::graph_type p;
+    apply(r, p);
+
+    // the group limit is applied to individual groups, so that the forward limit must be kept
+    ASSERT_EQ(p.size(), 2);
+    auto&& take = next<take_flat>(r3.input());
+    auto&& e1 = resolve<plan::forward>(take.source());
+    EXPECT_EQ(e1.limit(), 10);
+}
+
+TEST_F(fuse_exchange_steps_test, group_group) {
+    /*
+     * scan:r0 - distinct:r1 - distinct:r2 - emit:r3
+     */
+    relation::graph_type r;
+    auto c0 = bindings.stream_variable("c0");
+    auto c1 = bindings.stream_variable("c1");
+    auto& r0 = scan(r, c0, c1);
+    auto& r1 = r.insert(relation::intermediate::distinct {
+            c0,
+    });
+    auto& r2 = r.insert(relation::intermediate::distinct {
+            c0,
+    });
+    auto& r3 = r.insert(relation::emit {
+            c0,
+    });
+    r0.output() >> r1.input();
+    r1.output() >> r2.input();
+    r2.output() >> r3.input();
+
+    plan::graph_type p;
+    apply(r, p);
+
+    /*
+     * scan:r0 - offer:r4 - [group{c0, limit=1}]:e0 - take_group:r5 - flatten:r6 - emit:r3
+     */
+    ASSERT_EQ(p.size(), 1);
+    ASSERT_EQ(r.size(), 5);
+
+    auto&& r4 = next<offer>(r0.output());
+    auto&& r6 = next<flatten>(r3.input());
+    auto&& r5 = next<take_group>(r6.input());
+
+    auto&& e0 = resolve<plan::group>(r4.destination());
+    EXPECT_EQ(r5.source(), r4.destination());
+    ASSERT_EQ(e0.group_keys().size(), 1);
+    EXPECT_EQ(e0.group_keys()[0], c0);
+    EXPECT_EQ(e0.limit(), 1);
+}
+
+} // namespace yugawara::analyzer::details
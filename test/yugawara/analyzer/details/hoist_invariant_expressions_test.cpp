@@ -0,0 +1,366 @@
+#include <yugawara/analyzer/details/hoist_invariant_expressions.h>
+
+#include <gtest/gtest.h>
+
+#include <takatori/scalar/binary.h>
+#include <takatori/scalar/cast.h>
+#include <takatori/scalar/function_call.h>
+
+#include <takatori/type/decimal.h>
+#include <takatori/value/decimal.h>
+
+#include <takatori/relation/scan.h>
+#include <takatori/relation/filter.h>
+#include <takatori/relation/emit.h>
+
+#include <yugawara/binding/factory.h>
+#include <yugawara/binding/extract.h>
+#include <yugawara/storage/configurable_provider.h>
+#include <yugawara/function/declaration.h>
+
+#include <yugawara/testing/utils.h>
+
+namespace yugawara::analyzer::details {
+
+// import test utils
+using namespace ::yugawara::testing;
+
+using ::takatori::scalar::binary;
+using ::takatori::scalar::binary_operator;
+
+using cmp = ::takatori::scalar::comparison_operator;
+
+class hoist_invariant_expressions_test : public ::testing::Test {
+protected:
+    binding::factory bindings;
+    storage::configurable_provider storages;
+
+    std::shared_ptr<storage::table> t0 = storages.add_table({
+            "T0",
+            {
+                    { "C0", t::int4() },
+                    { "C1", t::int4() },
+            },
+    });
+    descriptor::variable t0c0 = bindings(t0->columns()[0]);
+    descriptor::variable t0c1 = bindings(t0->columns()[1]);
+
+    std::shared_ptr<storage::index> i0 = storages.add_index({ t0, "I0", });
+
+    descriptor::variable p0 = bindings.external_variable({ "p0", t::int4() });
+    descriptor::variable p1 = bindings.external_variable({ "p1", t::int4() });
+
+    relation::scan& scan(relation::graph_type& r, descriptor::variable c0, descriptor::variable c1) {
+        return r.insert(relation::scan {
+                bindings(*i0),
+                {
+                        { t0c0, std::move(c0) },
+                        { t0c1, std::move(c1) },
+                },
+        });
+    }
+};
+
+TEST_F(hoist_invariant_expressions_test, simple) {
+    /*
+     * scan:r0 - filter:r1 - emit:ro
+     * filter { c0 = 1 AND p0 < p1 }
+     */
+    relation::graph_type r;
+    auto c0 = bindings.stream_variable("c0");
+    auto c1 = bindings.stream_variable("c1");
+    auto&& r0 = scan(r, c0, c1);
+    auto&& r1 = r.insert(relation::filter {
+            land(
+                    compare(varref { c0 }, constant(1)),
+                    compare(varref { p0 }, varref { p1 }, cmp::less)),
+    });
+    auto&& ro = r.insert(relation::emit { c0 });
+    r0.output() >> r1.input();
+    r1.output() >> ro.input();
+
+    auto invariants = hoist_invariant_expressions(r);
+
+    ASSERT_EQ(invariants.size(), 1);
+    auto&& v = invariants[0];
+    EXPECT_EQ(binding::kind_of(v.variable()), binding::variable_info_kind::frame_variable);
+    EXPECT_EQ(v.value(), compare(varref { p0 }, varref { p1 }, cmp::less));
+    EXPECT_EQ(r1.condition(), land(
+            compare(varref { c0 }, constant(1)),
+            varref { v.variable() }));
+}
+
+TEST_F(hoist_invariant_expressions_test, trivial) {
+    /*
+     * scan:r0 - filter:r1 - emit:ro
+     * filter { c0 = p0 AND c1 = 1 }
+     */
+    relation::graph_type r;
+    auto c0 = bindings.stream_variable("c0");
+    auto c1 = bindings.stream_variable("c1");
+    auto&& r0 = scan(r, c0, c1);
+    auto&& r1 = r.insert(relation::filter {
+            land(
+                    compare(varref { c0 }, varref { p0 }),
+                    compare(varref { c1 }, constant(1))),
+    });
+    auto&& ro = r.insert(relation::emit { c0 });
+    r0.output() >> r1.input();
+    r1.output() >> ro.input();
+
+    auto invariants = hoist_invariant_expressions(r);
+
+    ASSERT_EQ(invariants.size(), 0);
+    EXPECT_EQ(r1.condition(), land(
+            compare(varref { c0 }, varref { p0 }),
+            compare(varref { c1 }, constant(1))));
+}
+
+TEST_F(hoist_invariant_expressions_test, shared) {
+    /*
+     * scan:r0 - filter:r1 - emit:ro
+     * filter { (p0 < p1 OR c0 = 1) AND (p0 < p1 OR c1 = 1) }
+     */
+    relation::graph_type r;
+    auto c0 = bindings.stream_variable("c0");
+    auto c1 = bindings.stream_variable("c1");
+    auto&& r0 = scan(r, c0, c1);
+    auto&& r1 = r.insert(relation::filter {
+            land(
+                    lor(
+                            compare(varref { p0 }, varref { p1 }, cmp::less),
+                            compare(varref { c0 }, constant(1))),
+                    lor(
+                            compare(varref { p0 }, varref { p1 }, cmp::less),
+                            compare(varref { c1 }, constant(1)))),
+    });
+    auto&& ro = r.insert(relation::emit { c0 });
+    r0.output() >> r1.input();
+    r1.output() >> ro.input();
+
+    auto invariants = hoist_invariant_expressions(r);
+
+    ASSERT_EQ(invariants.size(), 1);
+    auto&& v = invariants[0].variable();
+    EXPECT_EQ(r1.condition(), land(
+            lor(varref { v }, compare(varref { c0 }, constant(1))),
+            lor(varref { v }, compare(varref { c1 }, constant(1)))));
+}
+
+TEST_F(hoist_invariant_expressions_test, conditional_error) {
+    /*
+     * scan:r0 - filter:r1 - emit:ro
+     * filter { c0 <> 0 AND c1 = p0 / p1 }
+     */
+    relation::graph_type r;
+    auto c0 = bindings.stream_variable("c0");
+    auto c1 = bindings.stream_variable("c1");
+    auto&& r0 = scan(r, c0, c1);
+    auto&& r1 = r.insert(relation::filter {
+            land(
+                    compare(varref { c0 }, constant(0), cmp::not_equal),
+                    compare(varref { c1 }, binary { binary_operator::divide, varref { p0 }, varref { p1 } })),
+    });
+    auto&& ro = r.insert(relation::emit { c0 });
+    r0.output() >> r1.input();
+    r1.output() >> ro.input();
+
+    auto invariants = hoist_invariant_expressions(r);
+
+    // the division is still evaluated only if it is referred, because the runtime evaluates invariants lazily
+    ASSERT_EQ(invariants.size(), 1);
+    auto&& v = invariants[0];
+    EXPECT_EQ(v.value(), (binary { binary_operator::divide, varref { p0 }, varref { p1 } }));
+    EXPECT_EQ(r1.condition(), land(
+            compare(varref { c0 }, constant(0), cmp::not_equal),
+            compare(varref { c1 }, varref { v.variable() })));
+}
+
+TEST_F(hoist_invariant_expressions_test, guarded_error) {
+    /*
+     * scan:r0 - filter:r1 - filter:r2 - emit:ro
+     * filter:r1 { p0 <> 0 }
+     * filter:r2 { c0 = 10 / p0 }
+     */
+    relation::graph_type r;
+    auto c0 = bindings.stream_variable("c0");
+    auto c1 = bindings.stream_variable("c1");
+    auto&& r0 = scan(r, c0, c1);
+    auto&& r1 = r.insert(relation::filter {
+            compare(varref { p0 }, constant(0), cmp::not_equal),
+    });
+    auto&& r2 = r.insert(relation::filter {
+            compare(varref { c0 }, binary { binary_operator::divide, constant(10), varref { p0 } }),
+    });
+    auto&& ro = r.insert(relation::emit { c0 });
+    r0.output() >> r1.input();
+    r1.output() >> r2.input();
+    r2.output() >> ro.input();
+
+    auto invariants = hoist_invariant_expressions(r);
+
+    ASSERT_EQ(invariants.size(), 2);
+    auto&& v0 = invariants[0];
+    EXPECT_EQ(v0.value(), compare(varref { p0 }, constant(0), cmp::not_equal));
+    EXPECT_EQ(r1.condition(), varref { v0.variable() });
+
+    // the division is only evaluated when r2 first refers it, that is, after the guard holds
+    auto&& v1 = invariants[1];
+    EXPECT_EQ(v1.value(), (binary { binary_operator::divide, constant(10), varref { p0 } }));
+    EXPECT_EQ(r2.condition(), compare(varref { c0 }, varref { v1.variable() }));
+}
+
+TEST_F(hoist_invariant_expressions_test, arithmetic) {
+    /*
+     * scan:r0 - filter:r1 - emit:ro
+     * filter { c0 < p0 * 1.08 }
+     */
+    relation::graph_type r;
+    auto c0 = bindings.stream_variable("c0");
+    auto c1 = bindings.stream_variable("c1");
+    auto&& r0 = scan(r, c0, c1);
+    auto rate = [] {
+        return scalar::immediate { v::decimal { "1.08" }, t::decimal { 3, 2 } };
+    };
+    auto&& r1 = r.insert(relation::filter {
+            compare(varref { c0 }, binary { binary_operator::multiply, varref { p0 }, rate() }, cmp::less),
+    });
+    auto&& ro = r.insert(relation::emit { c0 });
+    r0.output() >> r1.input();
+    r1.output() >> ro.input();
+
+    auto invariants = hoist_invariant_expressions(r);
+
+    ASSERT_EQ(invariants.size(), 1);
+    auto&& v = invariants[0];
+    EXPECT_EQ(v.value(), (binary { binary_operator::multiply, varref { p0 }, rate() }));
+    EXPECT_EQ(r1.condition(), compare(varref { c0 }, varref { v.variable() }, cmp::less));
+}
+
+TEST_F(hoist_invariant_expressions_test, cast) {
+    /*
+     * scan:r0 - filter:r1 - emit:ro
+     * filter { c0 = CAST(p0 AS INT) }
+     */
+    relation::graph_type r;
+    auto c0 = bindings.stream_variable("c0");
+    auto c1 = bindings.stream_variable("c1");
+    auto&& r0 = scan(r, c0, c1);
+    auto&& r1 = r.insert(relation::filter {
+            compare(varref { c0 }, scalar::cast { t::int4 {}, scalar::cast_loss_policy::error, varref { p0 } }),
+    });
+    auto&& ro = r.insert(relation::emit { c0 });
+    r0.output() >> r1.input();
+    r1.output() >> ro.input();
+
+    auto invariants = hoist_invariant_expressions(r);
+
+    ASSERT_EQ(invariants.size(), 1);
+    auto&& v = invariants[0];
+    EXPECT_EQ(v.value(), (scalar::cast { t::int4 {}, scalar::cast_loss_policy::error, varref { p0 } }));
+    EXPECT_EQ(r1.condition(), compare(varref { c0 }, varref { v.variable() }));
+}
+
+TEST_F(hoist_invariant_expressions_test, function_call_deterministic) {
+    /*
+     * scan:r0 - filter:r1 - emit:ro
+     * filter { c0 = f(p0) }
+     */
+    auto f = bindings.function({
+            function::declaration::minimum_user_function_id + 1,
+            "f",
+            t::int4 {},
+            {
+                    t::int4 {},
+            },
+            {
+                    function::function_feature::scalar_function,
+                    function::function_feature::deterministic,
+            },
+    });
+    relation::graph_type r;
+    auto c0 = bindings.stream_variable("c0");
+    auto c1 = bindings.stream_variable("c1");
+    auto&& r0 = scan(r, c0, c1);
+    auto&& r1 = r.insert(relation::filter {
+            compare(varref { c0 }, scalar::function_call { f, { varref { p0 } } }),
+    });
+    auto&& ro = r.insert(relation::emit { c0 });
+    r0.output() >> r1.input();
+    r1.output() >> ro.input();
+
+    auto invariants = hoist_invariant_expressions(r);
+
+    ASSERT_EQ(invariants.size(), 1);
+    auto&& v = invariants[0];
+    EXPECT_EQ(v.value(), (scalar::function_call { f, { varref { p0 } } }));
+    EXPECT_EQ(r1.condition(), compare(varref { c0 }, varref { v.variable() }));
+}
+
+TEST_F(hoist_invariant_expressions_test, function_call_not_deterministic) {
+    /*
+     * scan:r0 - filter:r1 - emit:ro
+     * filter { c0 = f(p0 + 1) }
+     */
+    auto f = bindings.function({
+            function::declaration::minimum_user_function_id + 1,
+            "f",
+            t::int4 {},
+            {
+                    t::int4 {},
+            },
+    });
+    relation::graph_type r;
+    auto c0 = bindings.stream_variable("c0");
+    auto c1 = bindings.stream_variable("c1");
+    auto&& r0 = scan(r, c0, c1);
+    auto&& r1 = r.insert(relation::filter {
+            compare(varref { c0 }, scalar::function_call {
+                    f,
+                    {
+                            binary { binary_operator::add, varref { p0 }, constant(1) },
+                    },
+            }),
+    });
+    auto&& ro = r.insert(relation::emit { c0 });
+    r0.output() >> r1.input();
+    r1.output() >> ro.input();
+
+    auto invariants = hoist_invariant_expressions(r);
+
+    // only the argument is hoisted
+    ASSERT_EQ(invariants.size(), 1);
+    auto&& v = invariants[0];
+    EXPECT_EQ(v.value(), (binary { binary_operator::add, varref { p0 }, constant(1) }));
+    EXPECT_EQ(r1.condition(), compare(varref { c0 }, scalar::function_call { f, { varref { v.variable() } } }));
+}
+
+TEST_F(hoist_invariant_expressions_test, whole_condition) {
+    /*
+     * scan:r0 - filter:r1 - emit:ro
+     * filter { p0 = 1 OR p1 = 2 }
+     */
+    relation::graph_type r;
+    auto c0 = bindings.stream_variable("c0");
+    auto c1 = bindings.stream_variable("c1");
+    auto&& r0 = scan(r, c0, c1);
+    auto&& r1 = r.insert(relation::filter {
+            lor(
+                    compare(varref { p0 }, constant(1)),
+                    compare(varref { p1 }, constant(2))),
+    });
+    auto&& ro = r.insert(relation::emit { c0 });
+    r0.output() >> r1.input();
+    r1.output() >> ro.input();
+
+    auto invariants = hoist_invariant_expressions(r);
+
+    ASSERT_EQ(invariants.size(), 1);
+    auto&& v = invariants[0];
+    EXPECT_EQ(v.value(), lor(
+            compare(varref { p0 }, constant(1)),
+            compare(varref { p1 }, constant(2))));
+    EXPECT_EQ(r1.condition(), varref { v.variable() });
+}
+
+} // namespace yugawara::analyzer::details
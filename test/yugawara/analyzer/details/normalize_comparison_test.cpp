@@ -0,0 +1,97 @@
+#include <yugawara/analyzer/details/normalize_comparison.h>
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <limits>
+
+#include <takatori/scalar/binary.h>
+#include <takatori/util/clonable.h>
+
+#include <yugawara/binding/factory.h>
+
+#include <yugawara/testing/utils.h>
+
+namespace yugawara::analyzer::details {
+
+// import test utils
+using namespace ::yugawara::testing;
+
+using ::takatori::scalar::binary;
+using ::takatori::scalar::binary_operator;
+using ::takatori::scalar::comparison_operator;
+
+using ::takatori::util::clone_unique;
+using ::takatori::util::ownership_reference;
+
+class normalize_comparison_test : public ::testing::Test {
+protected:
+    binding::factory bindings;
+    descriptor::variable c0 = bindings.stream_variable("c0");
+    descriptor::variable c1 = bindings.stream_variable("c1");
+
+    bool apply(std::unique_ptr<scalar::expression>& expr) {
+        return normalize_comparison(ownership_reference<scalar::expression> { expr }, [&](descriptor::variable const& v) {
+            return v == c0;
+        });
+    }
+};
+
+TEST_F(normalize_comparison_test, add) {
+    // c0 + 5 > 10
+    auto orig = compare(
+            binary { binary_operator::add, varref(c0), constant(5) },
+            constant(10),
+            comparison_operator::greater);
+    auto expr = clone_unique<scalar::expression&>(orig);
+    ASSERT_TRUE(apply(expr));
+    EXPECT_EQ(*expr, compare(varref(c0), constant(5), comparison_operator::greater));
+}
+
+TEST_F(normalize_comparison_test, subtract_nested) {
+    // 10 >= (1 + c0) - 3
+    auto orig = compare(
+            constant(10),
+            binary {
+                    binary_operator::subtract,
+                    binary { binary_operator::add, constant(1), varref(c0) },
+                    constant(3),
+            },
+            comparison_operator::greater_equal);
+    auto expr = clone_unique<scalar::expression&>(orig);
+    ASSERT_TRUE(apply(expr));
+    EXPECT_EQ(*expr, compare(varref(c0), constant(12), comparison_operator::less_equal));
+}
+
+TEST_F(normalize_comparison_test, negate) {
+    // 3 - c0 < 1
+    auto orig = compare(
+            binary { binary_operator::subtract, constant(3), varref(c0) },
+            constant(1),
+            comparison_operator::less);
+    auto expr = clone_unique<scalar::expression&>(orig);
+    ASSERT_TRUE(apply(expr));
+    EXPECT_EQ(*expr, compare(varref(c0), constant(2), comparison_operator::greater));
+}
+
+TEST_F(normalize_comparison_test, not_integral) {
+    auto orig = compare(
+            binary { binary_operator::add, varref(c1), constant(5) },
+            constant(10),
+            comparison_operator::greater);
+    auto expr = clone_unique<scalar::expression&>(orig);
+    EXPECT_FALSE(apply(expr));
+    EXPECT_EQ(*expr, orig);
+}
+
+TEST_F(normalize_comparison_test, overflow) {
+    auto orig = compare(
+            binary { binary_operator::subtract, varref(c0), constant(1) },
+            constant(std::numeric_limits<std::int32_t>::max()),
+            comparison_operator::greater);
+    auto expr = clone_unique<scalar::expression&>(orig);
+    EXPECT_FALSE(apply(expr));
+    EXPECT_EQ(*expr, orig);
+}
+
+} // namespace yugawara::analyzer::details
@@ -2,6 +2,9 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <vector>
+
 #include <takatori/type/primitive.h>
 #include <takatori/type/table.h>
 
@@ -1071,7 +1074,7 @@ TEST_F(push_down_filters_test, project_flush) {
             },
     });
     auto&& rf = r.insert(relation::filter {
-            compare(varref(x1), constant(0)),
+            compare(varref(x1), varref(x0)),
     });
     r0.output() >> r1.input();
     r1.output() >> rf.input();
@@ -1083,7 +1086,66 @@ TEST_F(push_down_filters_test, project_flush) {
     auto&& f0 = next<relation::filter>(r1.output());
     EXPECT_GT(f0.output(), rf.input());
 
-    EXPECT_EQ(f0.condition(), compare(varref(x1), constant(0)));
+    EXPECT_EQ(f0.condition(), compare(varref(x1), varref(x0)));
+    EXPECT_EQ(rf.condition(), boolean(true));
+}
+
+TEST_F(push_down_filters_test, project_substitute) {
+    /*
+     * scan:r0 - project:r1 - filter:rf - ...
+     */
+    relation::graph_type r;
+    auto c0 = bindings.stream_variable("c0");
+    auto c1 = bindings.stream_variable("c1");
+    auto c2 = bindings.stream_variable("c2");
+    auto&& r0 = r.insert(relation::scan {
+            bindings(*i0),
+            {
+                    { t0c0, c0 },
+                    { t0c1, c1 },
+                    { t0c2, c2 },
+            },
+    });
+    auto x0 = bindings.stream_variable("x0");
+    auto x1 = bindings.stream_variable("x1");
+    auto&& r1 = r.insert(relation::project {
+            relation::project::column {
+                    scalar::binary {
+                            scalar::binary_operator::add,
+                            scalar::variable_reference { c0 },
+                            constant(1),
+                    },
+                    x0,
+            },
+            relation::project::column {
+                    scalar::binary {
+                            scalar::binary_operator::add,
+                            scalar::variable_reference { c1 },
+                            constant(2),
+                    },
+                    x1,
+            },
+    });
+    auto&& rf = r.insert(relation::filter {
+            compare(varref(x1), constant(0)),
+    });
+    r0.output() >> r1.input();
+    r1.output() >> rf.input();
+
+    connect(rf.output());
+    apply(r);
+
+    /*
+     * scan:r0 - filter:f0 - filter(TRUE) - project:r1 - filter:rf - ...
+     */
+    ASSERT_EQ(r.size(), 6);
+    auto&& f0 = next<relation::filter>(r0.output());
+    auto&& f1 = next<relation::filter>(f0.output());
+    EXPECT_GT(f1.output(), r1.input());
+
+    // x1 = c1 + 2 = 0
+    EXPECT_EQ(f0.condition(), compare(varref(c1), constant(-2)));
+    EXPECT_EQ(f1.condition(), boolean(true));
     EXPECT_EQ(rf.condition(), boolean(true));
 }
 
@@ -1177,6 +1239,73 @@ TEST_F(push_down_filters_test, buffer) {
     EXPECT_EQ(rf.condition(), boolean(true));
 }
 
+TEST_F(push_down_filters_test, buffer_common) {
+    /*
+     *                    /- filter:rf0 - ...
+     * scan:r0 - buffer:r1
+     *                    \- filter:rf1 - ...
+     */
+    relation::graph_type r;
+    auto c0 = bindings.stream_variable("c0");
+    auto c1 = bindings.stream_variable("c1");
+    auto c2 = bindings.stream_variable("c2");
+    auto&& r0 = r.insert(relation::scan {
+            bindings(*i0),
+            {
+                    { t0c0, c0 },
+                    { t0c1, c1 },
+                    { t0c2, c2 },
+            },
+    });
+    auto&& r1 = r.insert(relation::buffer { 2 });
+    auto&& rf0 = r.insert(relation::filter {
+            land(
+                    compare(varref(c0), constant(0)),
+                    compare(varref(c1), constant(1))),
+    });
+    auto&& rf1 = r.insert(relation::filter {
+            land(
+                    compare(varref(c0), constant(0)),
+                    compare(varref(c2), constant(2))),
+    });
+    r0.output() >> r1.input();
+    r1.output_ports()[0] >> rf0.input();
+    r1.output_ports()[1] >> rf1.input();
+
+    connect(rf0.output());
+    connect(rf1.output());
+    apply(r);
+
+    /*
+     * scan:r0 - filter:f0 - filter:f1 - filter(TRUE) - buffer:r1 - filter:b0 - filter:rf0 - ...
+     *                                                            \- filter:b1 - filter:rf1 - ...
+     */
+    ASSERT_EQ(r.size(), 11);
+    auto&& f0 = next<relation::filter>(r0.output());
+    auto&& f1 = next<relation::filter>(f0.output());
+    auto&& b0 = next<relation::filter>(r1.output_ports()[0]);
+    auto&& b1 = next<relation::filter>(r1.output_ports()[1]);
+    EXPECT_GT(b0.output(), rf0.input());
+    EXPECT_GT(b1.output(), rf1.input());
+
+    std::vector<scalar::expression const*> terms {
+            std::addressof(f0.condition()),
+            std::addressof(f1.condition()),
+    };
+    auto contains = [&](scalar::expression const& expr) {
+        return std::any_of(terms.begin(), terms.end(), [&](auto* term) { return *term == expr; });
+    };
+    EXPECT_TRUE(contains(compare(varref(c0), constant(0))));
+    EXPECT_TRUE(contains(lor(
+            compare(varref(c1), constant(1)),
+            compare(varref(c2), constant(2)))));
+
+    EXPECT_EQ(b0.condition(), compare(varref(c1), constant(1)));
+    EXPECT_EQ(b1.condition(), compare(varref(c2), constant(2)));
+    EXPECT_EQ(rf0.condition(), land(boolean(true), boolean(true)));
+    EXPECT_EQ(rf1.condition(), land(boolean(true), boolean(true)));
+}
+
 TEST_F(push_down_filters_test, identify_flush) {
     /*
      * scan:r0 - identify:r1 - filter:rf - ...
@@ -1513,8 +1642,6 @@ TEST_F(push_down_filters_test, limit_relation_pass) {
     EXPECT_EQ(rf.condition(), boolean(true));
 }
 
-// FIXME: impl other than union both
-
 TEST_F(push_down_filters_test, union_relation_both) {
     /*
      * scan:rl -\
@@ -1566,6 +1693,68 @@ TEST_F(push_down_filters_test, union_relation_both) {
     EXPECT_EQ(rf.condition(), boolean(true));
 }
 
+TEST_F(push_down_filters_test, union_relation_pass) {
+    /*
+     * scan:rl -\
+     *           union_relation:r0 - filter:rf - ...
+     * scan:rr -/
+     */
+    relation::graph_type r;
+    auto cl0 = bindings.stream_variable("cl0");
+    auto cl1 = bindings.stream_variable("cl1");
+    auto cr0 = bindings.stream_variable("cr0");
+    auto cr1 = bindings.stream_variable("cr1");
+    auto&& rl = r.insert(relation::scan {
+            bindings(*i0),
+            {
+                    { t0c0, cl0 },
+                    { t0c1, cl1 },
+            },
+    });
+    auto&& rr = r.insert(relation::scan {
+            bindings(*i1),
+            {
+                    { t1c0, cr0 },
+                    { t1c1, cr1 },
+            },
+    });
+    auto x0 = bindings.stream_variable("x0");
+    auto x1 = bindings.stream_variable("x1");
+    auto x2 = bindings.stream_variable("x2");
+    auto&& r0 = r.insert(relation::intermediate::union_ {
+            { cl0, cr0, x0 },
+            { cl1,  {}, x1 },
+            {  {}, cr1, x2 },
+    });
+    auto&& rf = r.insert(relation::filter {
+            land(
+                    compare(varref(x0), constant(0)),
+                    compare(varref(x1), varref(x0))),
+    });
+    rl.output() >> r0.left();
+    rr.output() >> r0.right();
+    r0.output() >> rf.input();
+
+    connect(rf.output());
+    apply(r);
+
+    /*
+     * scan:rl - filter:fl - filter(TRUE) -\
+     *                                      union_relation:r0 - filter:f0 - filter:rf - ...
+     * scan:rr - filter:fr - filter(TRUE) -/
+     */
+    ASSERT_EQ(r.size(), 10);
+    auto&& fl = next<relation::filter>(rl.output());
+    auto&& fr = next<relation::filter>(rr.output());
+    auto&& f0 = next<relation::filter>(r0.output());
+    EXPECT_GT(f0.output(), rf.input());
+
+    EXPECT_EQ(fl.condition(), compare(varref(cl0), constant(0)));
+    EXPECT_EQ(fr.condition(), compare(varref(cr0), constant(0)));
+    EXPECT_EQ(f0.condition(), compare(varref(x1), varref(x0)));
+    EXPECT_EQ(rf.condition(), boolean(true));
+}
+
 TEST_F(push_down_filters_test, intersection_relation) {
     /*
      * scan:rl -\
@@ -1597,6 +1786,7 @@ TEST_F(push_down_filters_test, intersection_relation) {
     });
     auto&& r0 = r.insert(relation::intermediate::intersection {
             { cl0, cr0 },
+            relation::set_quantifier::all,
     });
     auto&& rf = r.insert(relation::filter {
             compare(varref(cl1), constant(0)),
@@ -1616,6 +1806,122 @@ TEST_F(push_down_filters_test, intersection_relation) {
     EXPECT_EQ(rf.condition(), boolean(true));
 }
 
+TEST_F(push_down_filters_test, intersection_relation_key) {
+    /*
+     * scan:rl -\
+     *           intersection_relation:r0 - filter:rf - ...
+     * scan:rr -/
+     */
+    relation::graph_type r;
+    auto cl0 = bindings.stream_variable("cl0");
+    auto cl1 = bindings.stream_variable("cl1");
+    auto cl2 = bindings.stream_variable("cl2");
+    auto cr0 = bindings.stream_variable("cr0");
+    auto cr1 = bindings.stream_variable("cr1");
+    auto cr2 = bindings.stream_variable("cr2");
+    auto&& rl = r.insert(relation::scan {
+            bindings(*i0),
+            {
+                    { t0c0, cl0 },
+                    { t0c1, cl1 },
+                    { t0c2, cl2 },
+            },
+    });
+    auto&& rr = r.insert(relation::scan {
+            bindings(*i0),
+            {
+                    { t1c0, cr0 },
+                    { t1c1, cr1 },
+                    { t1c2, cr2 },
+            },
+    });
+    auto&& r0 = r.insert(relation::intermediate::intersection {
+            { cl0, cr0 },
+            relation::set_quantifier::all,
+    });
+    auto&& rf = r.insert(relation::filter {
+            compare(varref(cl0), constant(0)),
+    });
+    rl.output() >> r0.left();
+    rr.output() >> r0.right();
+    r0.output() >> rf.input();
+
+    connect(rf.output());
+    apply(r);
+
+    /*
+     * scan:rl - filter:f0 ---------------------\
+     *                                           intersection_relation:r0 - filter:rf - ...
+     * scan:rr - filter:f1 - filter(TRUE):f2 ---/
+     */
+    ASSERT_EQ(r.size(), 8);
+    auto&& f0 = next<relation::filter>(rl.output());
+    EXPECT_GT(f0.output(), r0.left());
+    auto&& f1 = next<relation::filter>(rr.output());
+    auto&& f2 = next<relation::filter>(f1.output());
+    EXPECT_GT(f2.output(), r0.right());
+
+    EXPECT_EQ(f0.condition(), compare(varref(cl0), constant(0)));
+    EXPECT_EQ(f1.condition(), compare(varref(cr0), constant(0)));
+    EXPECT_EQ(f2.condition(), boolean(true));
+    EXPECT_EQ(rf.condition(), boolean(true));
+}
+
+TEST_F(push_down_filters_test, intersection_relation_distinct) {
+    /*
+     * scan:rl -\
+     *           intersection_relation:r0 - filter:rf - ...
+     * scan:rr -/
+     */
+    relation::graph_type r;
+    auto cl0 = bindings.stream_variable("cl0");
+    auto cl1 = bindings.stream_variable("cl1");
+    auto cl2 = bindings.stream_variable("cl2");
+    auto cr0 = bindings.stream_variable("cr0");
+    auto cr1 = bindings.stream_variable("cr1");
+    auto cr2 = bindings.stream_variable("cr2");
+    auto&& rl = r.insert(relation::scan {
+            bindings(*i0),
+            {
+                    { t0c0, cl0 },
+                    { t0c1, cl1 },
+                    { t0c2, cl2 },
+            },
+    });
+    auto&& rr = r.insert(relation::scan {
+            bindings(*i0),
+            {
+                    { t1c0, cr0 },
+                    { t1c1, cr1 },
+                    { t1c2, cr2 },
+            },
+    });
+    auto&& r0 = r.insert(relation::intermediate::intersection {
+            { cl0, cr0 },
+            relation::set_quantifier::distinct,
+    });
+    auto&& rf = r.insert(relation::filter {
+            compare(varref(cl1), constant(0)),
+    });
+    rl.output() >> r0.left();
+    rr.output() >> r0.right();
+    r0.output() >> rf.input();
+
+    connect(rf.output());
+    apply(r);
+
+    ASSERT_EQ(r.size(), 7);
+    auto&& f0 = next<relation::filter>(rl.output());
+    EXPECT_GT(f0.output(), r0.left());
+    auto&& f1 = next<relation::filter>(r0.output());
+    EXPECT_GT(f1.output(), rf.input());
+
+    // keep a copy, because the representative row of each group may change
+    EXPECT_EQ(f0.condition(), compare(varref(cl1), constant(0)));
+    EXPECT_EQ(f1.condition(), compare(varref(cl1), constant(0)));
+    EXPECT_EQ(rf.condition(), boolean(true));
+}
+
 TEST_F(push_down_filters_test, difference_relation) {
     /*
      * scan:rl -\
@@ -1647,6 +1953,7 @@ TEST_F(push_down_filters_test, difference_relation) {
     });
     auto&& r0 = r.insert(relation::intermediate::difference {
             { cl0, cr0 },
+            relation::set_quantifier::all,
     });
     auto&& rf = r.insert(relation::filter {
             compare(varref(cl1), constant(0)),
@@ -1666,6 +1973,122 @@ TEST_F(push_down_filters_test, difference_relation) {
     EXPECT_EQ(rf.condition(), boolean(true));
 }
 
+TEST_F(push_down_filters_test, difference_relation_key) {
+    /*
+     * scan:rl -\
+     *           difference_relation:r0 - filter:rd - ...
+     * scan:rr -/
+     */
+    relation::graph_type r;
+    auto cl0 = bindings.stream_variable("cl0");
+    auto cl1 = bindings.stream_variable("cl1");
+    auto cl2 = bindings.stream_variable("cl2");
+    auto cr0 = bindings.stream_variable("cr0");
+    auto cr1 = bindings.stream_variable("cr1");
+    auto cr2 = bindings.stream_variable("cr2");
+    auto&& rl = r.insert(relation::scan {
+            bindings(*i0),
+            {
+                    { t0c0, cl0 },
+                    { t0c1, cl1 },
+                    { t0c2, cl2 },
+            },
+    });
+    auto&& rr = r.insert(relation::scan {
+            bindings(*i0),
+            {
+                    { t1c0, cr0 },
+                    { t1c1, cr1 },
+                    { t1c2, cr2 },
+            },
+    });
+    auto&& r0 = r.insert(relation::intermediate::difference {
+            { cl0, cr0 },
+            relation::set_quantifier::all,
+    });
+    auto&& rf = r.insert(relation::filter {
+            compare(varref(cl0), constant(0)),
+    });
+    rl.output() >> r0.left();
+    rr.output() >> r0.right();
+    r0.output() >> rf.input();
+
+    connect(rf.output());
+    apply(r);
+
+    /*
+     * scan:rl - filter:f0 ---------------------\
+     *                                           difference_relation:r0 - filter:rf - ...
+     * scan:rr - filter:f1 - filter(TRUE):f2 ---/
+     */
+    ASSERT_EQ(r.size(), 8);
+    auto&& f0 = next<relation::filter>(rl.output());
+    EXPECT_GT(f0.output(), r0.left());
+    auto&& f1 = next<relation::filter>(rr.output());
+    auto&& f2 = next<relation::filter>(f1.output());
+    EXPECT_GT(f2.output(), r0.right());
+
+    EXPECT_EQ(f0.condition(), compare(varref(cl0), constant(0)));
+    EXPECT_EQ(f1.condition(), compare(varref(cr0), constant(0)));
+    EXPECT_EQ(f2.condition(), boolean(true));
+    EXPECT_EQ(rf.condition(), boolean(true));
+}
+
+TEST_F(push_down_filters_test, difference_relation_distinct) {
+    /*
+     * scan:rl -\
+     *           difference_relation:r0 - filter:rd - ...
+     * scan:rr -/
+     */
+    relation::graph_type r;
+    auto cl0 = bindings.stream_variable("cl0");
+    auto cl1 = bindings.stream_variable("cl1");
+    auto cl2 = bindings.stream_variable("cl2");
+    auto cr0 = bindings.stream_variable("cr0");
+    auto cr1 = bindings.stream_variable("cr1");
+    auto cr2 = bindings.stream_variable("cr2");
+    auto&& rl = r.insert(relation::scan {
+            bindings(*i0),
+            {
+                    { t0c0, cl0 },
+                    { t0c1, cl1 },
+                    { t0c2, cl2 },
+            },
+    });
+    auto&& rr = r.insert(relation::scan {
+            bindings(*i0),
+            {
+                    { t1c0, cr0 },
+                    { t1c1, cr1 },
+                    { t1c2, cr2 },
+            },
+    });
+    auto&& r0 = r.insert(relation::intermediate::difference {
+            { cl0, cr0 },
+            relation::set_quantifier::distinct,
+    });
+    auto&& rf = r.insert(relation::filter {
+            compare(varref(cl1), constant(0)),
+    });
+    rl.output() >> r0.left();
+    rr.output() >> r0.right();
+    r0.output() >> rf.input();
+
+    connect(rf.output());
+    apply(r);
+
+    ASSERT_EQ(r.size(), 7);
+    auto&& f0 = next<relation::filter>(rl.output());
+    EXPECT_GT(f0.output(), r0.left());
+    auto&& f1 = next<relation::filter>(r0.output());
+    EXPECT_GT(f1.output(), rf.input());
+
+    // keep a copy, because the representative row of each group may change
+    EXPECT_EQ(f0.condition(), compare(varref(cl1), constant(0)));
+    EXPECT_EQ(f1.condition(), compare(varref(cl1), constant(0)));
+    EXPECT_EQ(rf.condition(), boolean(true));
+}
+
 TEST_F(push_down_filters_test, escape) {
     /*
      * scan:r0 - escape:r1 - filter:rf - ...
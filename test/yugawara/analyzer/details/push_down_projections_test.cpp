@@ -0,0 +1,326 @@
+#include <yugawara/analyzer/details/push_down_projections.h>
+
+#include <gtest/gtest.h>
+
+#include <takatori/scalar/binary.h>
+
+#include <takatori/relation/scan.h>
+#include <takatori/relation/project.h>
+#include <takatori/relation/emit.h>
+#include <takatori/relation/intermediate/join.h>
+
+#include <yugawara/binding/factory.h>
+#include <yugawara/storage/configurable_provider.h>
+
+#include <yugawara/testing/utils.h>
+
+namespace yugawara::analyzer::details {
+
+// import test utils
+using namespace ::yugawara::testing;
+
+using ::takatori::scalar::binary;
+using ::takatori::scalar::binary_operator;
+
+class push_down_projections_test : public ::testing::Test {
+protected:
+    binding::factory bindings;
+    storage::configurable_provider storages;
+
+    std::shared_ptr<storage::table> t0 = storages.add_table({
+            "T0",
+            {
+                    { "C0", t::int4() },
+                    { "C1", t::int4() },
+            },
+    });
+    descriptor::variable t0c0 = bindings(t0->columns()[0]);
+    descriptor::variable t0c1 = bindings(t0->columns()[1]);
+
+    std::shared_ptr<storage::index> i0 = storages.add_index({ t0, "I0", });
+
+    relation::scan& scan(relation::graph_type& r, descriptor::variable c0, descriptor::variable c1) {
+        return r.insert(relation::scan {
+                bindings(*i0),
+                {
+                        { t0c0, std::move(c0) },
+                        { t0c1, std::move(c1) },
+                },
+        });
+    }
+
+    static binary mul(descriptor::variable const& a, descriptor::variable const& b) {
+        return binary { binary_operator::multiply, varref { a }, varref { b } };
+    }
+
+    static scalar::compare lt(descriptor::variable const& a, descriptor::variable const& b) {
+        return compare(varref { a }, varref { b }, scalar::comparison_operator::less);
+    }
+};
+
+TEST_F(push_down_projections_test, simple) {
+    /*
+     * scan:r0 - project:r1 - emit:ro
+     */
+    relation::graph_type r;
+    auto c0 = bindings.stream_variable("c0");
+    auto c1 = bindings.stream_variable("c1");
+    auto x = bindings.stream_variable("x");
+    auto&& r0 = scan(r, c0, c1);
+    auto&& r1 = r.insert(relation::project {
+            relation::project::column { x, mul(c0, c1) },
+    });
+    auto&& ro = r.insert(relation::emit { x });
+    r0.output() >> r1.input();
+    r1.output() >> ro.input();
+
+    push_down_projections(r);
+
+    ASSERT_EQ(r.size(), 3);
+    EXPECT_GT(r0.output(), r1.input());
+    EXPECT_GT(r1.output(), ro.input());
+}
+
+TEST_F(push_down_projections_test, inner_join) {
+    /*
+     * scan:r0 -\
+     *           join:r2 - project:r3 - project:r4 - emit:ro
+     * scan:r1 -/
+     * project:r3 { x := l0 < l1 }
+     * project:r4 { y := c0 < c1 }
+     */
+    relation::graph_type r;
+    auto l0 = bindings.stream_variable("l0");
+    auto l1 = bindings.stream_variable("l1");
+    auto c0 = bindings.stream_variable("c0");
+    auto c1 = bindings.stream_variable("c1");
+    auto x = bindings.stream_variable("x");
+    auto y = bindings.stream_variable("y");
+    auto&& r0 = scan(r, l0, l1);
+    auto&& r1 = scan(r, c0, c1);
+    auto&& r2 = r.insert(relation::intermediate::join {
+            relation::join_kind::inner,
+    });
+    auto&& r3 = r.insert(relation::project {
+            relation::project::column { x, lt(l0, l1) },
+    });
+    auto&& r4 = r.insert(relation::project {
+            relation::project::column { y, lt(c0, c1) },
+    });
+    auto&& ro = r.insert(relation::emit { x, y });
+    r0.output() >> r2.left();
+    r1.output() >> r2.right();
+    r2.output() >> r3.input();
+    r3.output() >> r4.input();
+    r4.output() >> ro.input();
+
+    push_down_projections(r);
+
+    // both inputs are acceptable for the values which never raise errors
+    ASSERT_EQ(r.size(), 6);
+    EXPECT_GT(r0.output(), r3.input());
+    EXPECT_GT(r3.output(), r2.left());
+    EXPECT_GT(r1.output(), r4.input());
+    EXPECT_GT(r4.output(), r2.right());
+    EXPECT_GT(r2.output(), ro.input());
+}
+
+TEST_F(push_down_projections_test, full_outer_join) {
+    /*
+     * scan:r0 -\
+     *           join:r2 - project:r3 - emit:ro
+     * scan:r1 -/
+     * project:r3 { x := l0 < l1 }
+     */
+    relation::graph_type r;
+    auto l0 = bindings.stream_variable("l0");
+    auto l1 = bindings.stream_variable("l1");
+    auto c0 = bindings.stream_variable("c0");
+    auto c1 = bindings.stream_variable("c1");
+    auto x = bindings.stream_variable("x");
+    auto&& r0 = scan(r, l0, l1);
+    auto&& r1 = scan(r, c0, c1);
+    auto&& r2 = r.insert(relation::intermediate::join {
+            relation::join_kind::full_outer,
+    });
+    auto&& r3 = r.insert(relation::project {
+            relation::project::column { x, lt(l0, l1) },
+    });
+    auto&& ro = r.insert(relation::emit { x, c0 });
+    r0.output() >> r2.left();
+    r1.output() >> r2.right();
+    r2.output() >> r3.input();
+    r3.output() >> ro.input();
+
+    push_down_projections(r);
+
+    // both inputs are null-supplying side
+    ASSERT_EQ(r.size(), 5);
+    EXPECT_GT(r2.output(), r3.input());
+    EXPECT_GT(r3.output(), ro.input());
+}
+
+TEST_F(push_down_projections_test, left_outer_join) {
+    /*
+     * scan:r0 -\
+     *           join:r2 - project:r3 - project:r4 - emit:ro
+     * scan:r1 -/
+     * project:r3 { x := l0 < l1 }
+     * project:r4 { y := c0 < c1 }
+     */
+    relation::graph_type r;
+    auto l0 = bindings.stream_variable("l0");
+    auto l1 = bindings.stream_variable("l1");
+    auto c0 = bindings.stream_variable("c0");
+    auto c1 = bindings.stream_variable("c1");
+    auto x = bindings.stream_variable("x");
+    auto y = bindings.stream_variable("y");
+    auto&& r0 = scan(r, l0, l1);
+    auto&& r1 = scan(r, c0, c1);
+    auto&& r2 = r.insert(relation::intermediate::join {
+            relation::join_kind::left_outer,
+    });
+    auto&& r3 = r.insert(relation::project {
+            relation::project::column { x, lt(l0, l1) },
+    });
+    auto&& r4 = r.insert(relation::project {
+            relation::project::column { y, lt(c0, c1) },
+    });
+    auto&& ro = r.insert(relation::emit { x, y });
+    r0.output() >> r2.left();
+    r1.output() >> r2.right();
+    r2.output() >> r3.input();
+    r3.output() >> r4.input();
+    r4.output() >> ro.input();
+
+    push_down_projections(r);
+
+    // the left input is preserved, and the right input is the null-supplying side
+    ASSERT_EQ(r.size(), 6);
+    EXPECT_GT(r0.output(), r3.input());
+    EXPECT_GT(r3.output(), r2.left());
+    EXPECT_GT(r1.output(), r2.right());
+    EXPECT_GT(r2.output(), r4.input());
+    EXPECT_GT(r4.output(), ro.input());
+}
+
+TEST_F(push_down_projections_test, may_raise_error) {
+    /*
+     * scan:r0 -\
+     *           join:r2 - project:r3 - emit:ro
+     * scan:r1 -/
+     * project:r3 { x := l0 * l1 }
+     */
+    relation::graph_type r;
+    auto l0 = bindings.stream_variable("l0");
+    auto l1 = bindings.stream_variable("l1");
+    auto c0 = bindings.stream_variable("c0");
+    auto c1 = bindings.stream_variable("c1");
+    auto x = bindings.stream_variable("x");
+    auto&& r0 = scan(r, l0, l1);
+    auto&& r1 = scan(r, c0, c1);
+    auto&& r2 = r.insert(relation::intermediate::join {
+            relation::join_kind::inner,
+    });
+    auto&& r3 = r.insert(relation::project {
+            relation::project::column { x, mul(l0, l1) },
+    });
+    auto&& ro = r.insert(relation::emit { x, c0 });
+    r0.output() >> r2.left();
+    r1.output() >> r2.right();
+    r2.output() >> r3.input();
+    r3.output() >> ro.input();
+
+    push_down_projections(r);
+
+    // the multiplication may overflow for the rows which the inner join discards
+    ASSERT_EQ(r.size(), 5);
+    EXPECT_GT(r2.output(), r3.input());
+    EXPECT_GT(r3.output(), ro.input());
+}
+
+TEST_F(push_down_projections_test, may_raise_error_left_outer_join) {
+    /*
+     * scan:r0 -\
+     *           join:r2 - project:r3 - emit:ro
+     * scan:r1 -/
+     * project:r3 { x := l0 * l1 }
+     */
+    relation::graph_type r;
+    auto l0 = bindings.stream_variable("l0");
+    auto l1 = bindings.stream_variable("l1");
+    auto c0 = bindings.stream_variable("c0");
+    auto c1 = bindings.stream_variable("c1");
+    auto x = bindings.stream_variable("x");
+    auto&& r0 = scan(r, l0, l1);
+    auto&& r1 = scan(r, c0, c1);
+    auto&& r2 = r.insert(relation::intermediate::join {
+            relation::join_kind::left_outer,
+    });
+    auto&& r3 = r.insert(relation::project {
+            relation::project::column { x, mul(l0, l1) },
+    });
+    auto&& ro = r.insert(relation::emit { x, c0 });
+    r0.output() >> r2.left();
+    r1.output() >> r2.right();
+    r2.output() >> r3.input();
+    r3.output() >> ro.input();
+
+    push_down_projections(r);
+
+    // the left outer join passes through all left input rows
+    ASSERT_EQ(r.size(), 5);
+    EXPECT_GT(r0.output(), r3.input());
+    EXPECT_GT(r3.output(), r2.left());
+    EXPECT_GT(r2.output(), ro.input());
+}
+
+TEST_F(push_down_projections_test, merge) {
+    /*
+     * scan:r0 -\
+     *           join:r2 - project:r3 - project:r4 - emit:ro
+     * scan:r1 -/
+     * project:r3 { x := l0 < l1 }
+     * project:r4 { y := l1 < l0 }
+     */
+    relation::graph_type r;
+    auto l0 = bindings.stream_variable("l0");
+    auto l1 = bindings.stream_variable("l1");
+    auto c0 = bindings.stream_variable("c0");
+    auto c1 = bindings.stream_variable("c1");
+    auto x = bindings.stream_variable("x");
+    auto y = bindings.stream_variable("y");
+    auto&& r0 = scan(r, l0, l1);
+    auto&& r1 = scan(r, c0, c1);
+    auto&& r2 = r.insert(relation::intermediate::join {
+            relation::join_kind::left_outer,
+    });
+    auto&& r3 = r.insert(relation::project {
+            relation::project::column { x, lt(l0, l1) },
+    });
+    auto&& r4 = r.insert(relation::project {
+            relation::project::column { y, lt(l1, l0) },
+    });
+    auto&& ro = r.insert(relation::emit { x, y, c0 });
+    r0.output() >> r2.left();
+    r1.output() >> r2.right();
+    r2.output() >> r3.input();
+    r3.output() >> r4.input();
+    r4.output() >> ro.input();
+
+    push_down_projections(r);
+
+    ASSERT_EQ(r.size(), 5);
+    auto&& p = next<relation::project>(r0.output());
+    EXPECT_GT(p.output(), r2.left());
+    EXPECT_GT(r2.output(), ro.input());
+
+    auto&& columns = p.columns();
+    ASSERT_EQ(columns.size(), 2);
+    EXPECT_EQ(columns[0].variable(), y);
+    EXPECT_EQ(columns[0].value(), lt(l1, l0));
+    EXPECT_EQ(columns[1].variable(), x);
+    EXPECT_EQ(columns[1].value(), lt(l0, l1));
+}
+
+} // namespace yugawara::analyzer::details
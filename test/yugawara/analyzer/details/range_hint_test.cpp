@@ -685,6 +685,39 @@ TEST_F(range_hint_test, entry_union_merge_variable) {
     EXPECT_EQ(left.upper_type(), range_hint_type::infinity);
 }
 
+TEST_F(range_hint_test, entry_intersect_immediate_owned) {
+    range_hint_entry entry {};
+    auto lower = std::make_unique<scalar::immediate>(constant(100));
+    auto* lower_ptr = lower.get();
+    entry.intersect_lower(std::move(lower), true); // 100 <= c
+
+    // takes over the value
+    EXPECT_EQ(entry.lower_type(), range_hint_type::inclusive);
+    EXPECT_EQ(std::addressof(as_immediate(entry.lower_value())), lower_ptr);
+
+    // keeps the current bound, and discards the incoming value
+    entry.intersect_lower(std::make_unique<scalar::immediate>(constant(50)), true); // 50 <= c
+    EXPECT_EQ(std::addressof(as_immediate(entry.lower_value())), lower_ptr);
+    EXPECT_EQ(as_immediate(entry.lower_value()), constant(100));
+}
+
+TEST_F(range_hint_test, entry_union_merge_owned) {
+    range_hint_entry left {};
+    left.intersect_lower(constant(110), true); // 110 <= c
+    left.intersect_upper(constant(190), false); // 190 > c
+
+    range_hint_entry right {};
+    right.intersect_lower(constant(100), true); // 100 <= c
+    right.intersect_upper(constant(200), false); // 200 > c
+    auto* lower_ptr = std::addressof(as_immediate(right.lower_value()));
+    auto* upper_ptr = std::addressof(as_immediate(right.upper_value()));
+
+    // (110 <= c < 190) || (100 <= c < 200) -> (100 <= c < 200), without copying the bounds of right
+    left.union_merge(std::move(right));
+    EXPECT_EQ(std::addressof(as_immediate(left.lower_value())), lower_ptr);
+    EXPECT_EQ(std::addressof(as_immediate(left.upper_value())), upper_ptr);
+}
+
 TEST_F(range_hint_test, map_simple) {
     range_hint_map map {};
 
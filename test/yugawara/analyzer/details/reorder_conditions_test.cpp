@@ -0,0 +1,227 @@
+#include <yugawara/analyzer/details/reorder_conditions.h>
+
+#include <gtest/gtest.h>
+
+#include <takatori/relation/scan.h>
+#include <takatori/relation/filter.h>
+#include <takatori/relation/emit.h>
+#include <takatori/relation/intermediate/join.h>
+
+#include <yugawara/binding/factory.h>
+#include <yugawara/storage/configurable_provider.h>
+
+#include <yugawara/testing/utils.h>
+
+namespace yugawara::analyzer::details {
+
+// import test utils
+using namespace ::yugawara::testing;
+
+using ::takatori::scalar::binary;
+using ::takatori::scalar::binary_operator;
+
+using cmp = ::takatori::scalar::comparison_operator;
+
+class reorder_conditions_test : public ::testing::Test {
+protected:
+    binding::factory bindings;
+    storage::configurable_provider storages;
+
+    std::shared_ptr<storage::table> t0 = storages.add_table({
+            "T0",
+            {
+                    { "C0", t::int4() },
+                    { "C1", t::int4() },
+                    { "C2", t::int4() },
+            },
+    });
+    descriptor::variable t0c0 = bindings(t0->columns()[0]);
+    descriptor::variable t0c1 = bindings(t0->columns()[1]);
+    descriptor::variable t0c2 = bindings(t0->columns()[2]);
+
+    std::shared_ptr<storage::index> i0 = storages.add_index({ t0, "I0", });
+
+    void apply(relation::graph_type& graph) {
+        reorder_conditions(graph);
+    }
+};
+
+TEST_F(reorder_conditions_test, stay) {
+    /*
+     * scan:r0 - filter:r1 - emit:ro
+     * filter { c0 = 0 AND c1 <> 1 }
+     */
+    relation::graph_type r;
+    auto c0 = bindings.stream_variable("c0");
+    auto c1 = bindings.stream_variable("c1");
+    auto& r0 = r.insert(relation::scan {
+            bindings(*i0),
+            {
+                    { t0c0, c0 },
+                    { t0c1, c1 },
+            },
+    });
+    auto& r1 = r.insert(relation::filter {
+            land(
+                    compare(varref { c0 }, constant(0)),
+                    compare(varref { c1 }, constant(1), cmp::not_equal)),
+    });
+    auto& ro = r.insert(relation::emit {
+            c0,
+    });
+    r0.output() >> r1.input();
+    r1.output() >> ro.input();
+
+    apply(r);
+
+    EXPECT_EQ(r1.condition(), land(
+            compare(varref { c0 }, constant(0)),
+            compare(varref { c1 }, constant(1), cmp::not_equal)));
+}
+
+TEST_F(reorder_conditions_test, selective) {
+    /*
+     * scan:r0 - filter:r1 - emit:ro
+     * filter { c0 <> 0 AND c1 = 1 }
+     */
+    relation::graph_type r;
+    auto c0 = bindings.stream_variable("c0");
+    auto c1 = bindings.stream_variable("c1");
+    auto& r0 = r.insert(relation::scan {
+            bindings(*i0),
+            {
+                    { t0c0, c0 },
+                    { t0c1, c1 },
+            },
+    });
+    auto& r1 = r.insert(relation::filter {
+            land(
+                    compare(varref { c0 }, constant(0), cmp::not_equal),
+                    compare(varref { c1 }, constant(1))),
+    });
+    auto& ro = r.insert(relation::emit {
+            c0,
+    });
+    r0.output() >> r1.input();
+    r1.output() >> ro.input();
+
+    apply(r);
+
+    EXPECT_EQ(r1.condition(), land(
+            compare(varref { c1 }, constant(1)),
+            compare(varref { c0 }, constant(0), cmp::not_equal)));
+}
+
+TEST_F(reorder_conditions_test, guarded) {
+    /*
+     * scan:r0 - filter:r1 - emit:ro
+     * filter { c0 <> 0 AND c1 / c0 = 1 AND c2 <> 2 }
+     */
+    relation::graph_type r;
+    auto c0 = bindings.stream_variable("c0");
+    auto c1 = bindings.stream_variable("c1");
+    auto c2 = bindings.stream_variable("c2");
+    auto& r0 = r.insert(relation::scan {
+            bindings(*i0),
+            {
+                    { t0c0, c0 },
+                    { t0c1, c1 },
+                    { t0c2, c2 },
+            },
+    });
+    auto& r1 = r.insert(relation::filter {
+            land(
+                    land(
+                            compare(varref { c0 }, constant(0), cmp::not_equal),
+                            compare(binary { binary_operator::divide, varref { c1 }, varref { c0 } }, constant(1))),
+                    compare(varref { c2 }, constant(2))),
+    });
+    auto& ro = r.insert(relation::emit {
+            c0,
+    });
+    r0.output() >> r1.input();
+    r1.output() >> ro.input();
+
+    apply(r);
+
+    // the division never precedes its guard
+    EXPECT_EQ(r1.condition(), land(
+            land(
+                    compare(varref { c2 }, constant(2)),
+                    compare(varref { c0 }, constant(0), cmp::not_equal)),
+            compare(binary { binary_operator::divide, varref { c1 }, varref { c0 } }, constant(1))));
+}
+
+TEST_F(reorder_conditions_test, filter_chain) {
+    /*
+     * scan:r0 - filter:r1 - filter:r2 - emit:ro
+     * filter { c0 <> 0 }
+     * filter { c1 = 1 }
+     */
+    relation::graph_type r;
+    auto c0 = bindings.stream_variable("c0");
+    auto c1 = bindings.stream_variable("c1");
+    auto& r0 = r.insert(relation::scan {
+            bindings(*i0),
+            {
+                    { t0c0, c0 },
+                    { t0c1, c1 },
+            },
+    });
+    auto& r1 = r.insert(relation::filter {
+            compare(varref { c0 }, constant(0), cmp::not_equal),
+    });
+    auto& r2 = r.insert(relation::filter {
+            compare(varref { c1 }, constant(1)),
+    });
+    auto& ro = r.insert(relation::emit {
+            c0,
+    });
+    r0.output() >> r1.input();
+    r1.output() >> r2.input();
+    r2.output() >> ro.input();
+
+    apply(r);
+
+    ASSERT_EQ(r.size(), 4);
+    EXPECT_EQ(r1.condition(), compare(varref { c1 }, constant(1)));
+    EXPECT_EQ(r2.condition(), compare(varref { c0 }, constant(0), cmp::not_equal));
+}
+
+TEST_F(reorder_conditions_test, join) {
+    relation::graph_type r;
+    auto cl0 = bindings.stream_variable("cl0");
+    auto&& inl = r.insert(relation::scan {
+            bindings(*i0),
+            {
+                    { t0c0, cl0 },
+            },
+    });
+    auto cr0 = bindings.stream_variable("cr0");
+    auto cr1 = bindings.stream_variable("cr1");
+    auto&& inr = r.insert(relation::scan {
+            bindings(*i0),
+            {
+                    { t0c0, cr0 },
+                    { t0c1, cr1 },
+            },
+    });
+    auto&& join = r.insert(relation::intermediate::join {
+            relation::join_kind::inner,
+            land(
+                    compare(varref { cl0 }, varref { cr0 }, cmp::less),
+                    compare(varref { cr1 }, constant(1))),
+    });
+    auto&& out = r.insert(relation::emit { cl0, cr0 });
+    inl.output() >> join.left();
+    inr.output() >> join.right();
+    join.output() >> out.input();
+
+    apply(r);
+
+    EXPECT_EQ(join.condition(), land(
+            compare(varref { cr1 }, constant(1)),
+            compare(varref { cl0 }, varref { cr0 }, cmp::less)));
+}
+
+} // namespace yugawara::analyzer::details
@@ -0,0 +1,181 @@
+#include <yugawara/analyzer/details/resolution_table.h>
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace yugawara::analyzer::details {
+
+class resolution_table_test : public ::testing::Test {
+protected:
+    // all keys collide on the same hash
+    struct colliding_hash {
+        std::size_t operator()(int) const noexcept {
+            return 0;
+        }
+    };
+};
+
+TEST_F(resolution_table_test, simple) {
+    resolution_table<int, std::string> table {};
+    EXPECT_EQ(table.find(1), nullptr);
+
+    auto [stored, success] = table.try_emplace(1, "a");
+    EXPECT_TRUE(success);
+    EXPECT_EQ(stored, "a");
+    EXPECT_EQ(table.size(), 1);
+
+    auto const* found = table.find(1);
+    ASSERT_TRUE(found);
+    EXPECT_EQ(*found, "a");
+}
+
+TEST_F(resolution_table_test, try_emplace_exists) {
+    resolution_table<int, std::string> table {};
+    table.try_emplace(1, "a");
+
+    std::string value { "b" };
+    auto [stored, success] = table.try_emplace(1, std::move(value));
+    EXPECT_FALSE(success);
+    EXPECT_EQ(stored, "a");
+    EXPECT_EQ(value, "b"); // NOLINT: not moved
+}
+
+TEST_F(resolution_table_test, insert_or_assign) {
+    resolution_table<int, std::string> table {};
+    auto&& first = table.insert_or_assign(1, "a");
+    auto&& second = table.insert_or_assign(1, "b");
+    EXPECT_EQ(std::addressof(first), std::addressof(second));
+    EXPECT_EQ(first, "b");
+    EXPECT_EQ(table.size(), 1);
+}
+
+TEST_F(resolution_table_test, stable_reference) {
+    resolution_table<int, int> table {};
+    auto&& first = table.insert_or_assign(0, 100);
+    for (int i = 1; i < 10'000; ++i) {
+        table.insert_or_assign(i, i + 100);
+    }
+    EXPECT_EQ(table.size(), 10'000);
+    EXPECT_EQ(std::addressof(first), table.find(0));
+    for (int i = 0; i < 10'000; ++i) {
+        auto const* found = table.find(i);
+        ASSERT_TRUE(found) << i;
+        EXPECT_EQ(*found, i + 100);
+    }
+    EXPECT_EQ(table.find(10'000), nullptr);
+}
+
+TEST_F(resolution_table_test, erase) {
+    resolution_table<int, int, colliding_hash> table {};
+    for (int i = 0; i < 10; ++i) {
+        table.insert_or_assign(i, i);
+    }
+    EXPECT_TRUE(table.erase(3));
+    EXPECT_TRUE(table.erase(0));
+    EXPECT_FALSE(table.erase(3));
+    EXPECT_EQ(table.size(), 8);
+
+    for (int i = 0; i < 10; ++i) {
+        if (i == 0 || i == 3) {
+            EXPECT_EQ(table.find(i), nullptr) << i;
+        } else {
+            ASSERT_TRUE(table.find(i)) << i;
+            EXPECT_EQ(*table.find(i), i);
+        }
+    }
+
+    table.insert_or_assign(3, 30);
+    ASSERT_TRUE(table.find(3));
+    EXPECT_EQ(*table.find(3), 30);
+}
+
+TEST_F(resolution_table_test, each) {
+    resolution_table<int, int> table {};
+    for (int i = 0; i < 5; ++i) {
+        table.insert_or_assign(i, i * 10);
+    }
+    table.erase(2);
+
+    std::vector<std::pair<int, int>> entries {};
+    table.each([&](int key, int value) {
+        entries.emplace_back(key, value);
+    });
+    EXPECT_EQ(entries, (std::vector<std::pair<int, int>> {
+            { 0, 0 },
+            { 1, 10 },
+            { 3, 30 },
+            { 4, 40 },
+    }));
+}
+
+TEST_F(resolution_table_test, clear) {
+    resolution_table<int, int> table {};
+    table.insert_or_assign(1, 1);
+    table.clear();
+    EXPECT_EQ(table.size(), 0);
+    EXPECT_EQ(table.find(1), nullptr);
+
+    table.insert_or_assign(1, 2);
+    ASSERT_TRUE(table.find(1));
+    EXPECT_EQ(*table.find(1), 2);
+}
+
+TEST_F(resolution_table_test, erase_release) {
+    resolution_table<std::shared_ptr<int>, std::shared_ptr<int>> table {};
+    auto key = std::make_shared<int>(1);
+    auto value = std::make_shared<int>(2);
+    table.insert_or_assign(key, value);
+    EXPECT_EQ(key.use_count(), 2);
+    EXPECT_EQ(value.use_count(), 2);
+
+    EXPECT_TRUE(table.erase(key));
+    EXPECT_EQ(key.use_count(), 1);
+    EXPECT_EQ(value.use_count(), 1);
+}
+
+TEST_F(resolution_table_test, erase_reuse) {
+    resolution_table<int, int> table {};
+    for (int i = 0; i < 5; ++i) {
+        table.insert_or_assign(i, i * 10);
+    }
+    auto const* stored = table.find(2);
+    table.erase(2);
+
+    // reuses the ordinal of the erased entry
+    auto&& reused = table.insert_or_assign(5, 50);
+    EXPECT_EQ(std::addressof(reused), stored);
+
+    std::vector<std::pair<int, int>> entries {};
+    table.each([&](int key, int value) {
+        entries.emplace_back(key, value);
+    });
+    EXPECT_EQ(entries, (std::vector<std::pair<int, int>> {
+            { 0, 0 },
+            { 1, 10 },
+            { 5, 50 },
+            { 3, 30 },
+            { 4, 40 },
+    }));
+}
+
+TEST_F(resolution_table_test, erase_churn) {
+    resolution_table<int, int, colliding_hash> table {};
+    auto&& first = table.insert_or_assign(0, 0);
+    for (int i = 1; i < 1'000; ++i) {
+        table.insert_or_assign(i, i);
+        auto const* stored = table.find(i);
+        ASSERT_TRUE(table.erase(i));
+
+        // the same slot is used again and again
+        auto&& next = table.insert_or_assign(-i, -i);
+        EXPECT_EQ(std::addressof(next), stored);
+        ASSERT_TRUE(table.erase(-i));
+    }
+    EXPECT_EQ(table.size(), 1);
+    EXPECT_EQ(table.find(0), std::addressof(first));
+}
+
+} // namespace yugawara::analyzer::details
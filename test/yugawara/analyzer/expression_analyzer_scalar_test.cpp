@@ -1952,4 +1952,42 @@ TEST_F(expression_analyzer_scalar_test, extension_quantified_compare_invalid) {
     EXPECT_TRUE(find(expr.left(), code::inconsistent_type)) << ::takatori::util::print_support { analyzer.diagnostics() };
 }
 
+TEST_F(expression_analyzer_scalar_test, retain_expressions) {
+    auto left = decl(t::int4 {});
+    s::binary expr {
+            s::binary_operator::add,
+            vref { left },
+            vref { decl(t::int4 {}) },
+    };
+    auto r = analyzer.resolve(expr, true, repo);
+    EXPECT_EQ(*r, t::int4());
+
+    analyzer.retain_expressions();
+    EXPECT_FALSE(analyzer.expressions().find(expr));
+
+    auto reused = analyzer.resolve(expr, true, repo);
+    EXPECT_EQ(*reused, t::int4());
+    EXPECT_TRUE(analyzer.expressions().find(expr));
+    EXPECT_TRUE(ok());
+}
+
+TEST_F(expression_analyzer_scalar_test, retain_expressions_operand_changed) {
+    auto left = decl(t::int4 {});
+    s::binary expr {
+            s::binary_operator::add,
+            vref { left },
+            vref { decl(t::int4 {}) },
+    };
+    auto r = analyzer.resolve(expr, true, repo);
+    EXPECT_EQ(*r, t::int4());
+
+    analyzer.retain_expressions();
+    analyzer.variables().bind(left, t::int8 {}, true);
+
+    // the operand type was changed
+    auto changed = analyzer.resolve(expr, true, repo);
+    EXPECT_EQ(*changed, t::int8());
+    EXPECT_TRUE(ok());
+}
+
 } // namespace yugawara::analyzer
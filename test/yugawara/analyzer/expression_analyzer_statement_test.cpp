@@ -5,6 +5,7 @@
 #include <takatori/document/basic_document.h>
 
 #include <takatori/type/primitive.h>
+#include <takatori/type/character.h>
 #include <takatori/type/date.h>
 #include <takatori/type/time_of_day.h>
 #include <takatori/type/time_point.h>
@@ -183,6 +184,46 @@ TEST_F(expression_analyzer_statement_test, write) {
     EXPECT_TRUE(ok());
 }
 
+TEST_F(expression_analyzer_statement_test, write_many_literals) {
+    statement::write stmt {
+            statement::write_kind::insert,
+            bindings(*i0),
+            {
+                    bindings(t0->columns()[0]),
+                    bindings(t0->columns()[1]),
+                    bindings(t0->columns()[2]),
+            },
+            {
+                    {
+                            scalar::immediate { v::int4 { 0 }, t::int4 {} },
+                            scalar::immediate { v::int4 { 1 }, t::int4 {} },
+                            scalar::immediate { v::int4 { 2 }, t::int4 {} },
+                    },
+                    {
+                            scalar::immediate { v::int4 { 3 }, t::int4 {} },
+                            scalar::immediate { v::int4 { 4 }, t::int4 {} },
+                            scalar::immediate { v::int4 { 5 }, t::int4 {} },
+                    },
+                    {
+                            scalar::immediate { v::int4 { 6 }, t::int4 {} },
+                            // inconsistent type after the column type was validated
+                            scalar::immediate { v::character { "x" }, t::character { t::varying } },
+                            scalar::immediate { v::int4 { 8 }, t::int4 {} },
+                    },
+            }
+    };
+    static_cast<void>(analyzer.resolve(stmt, true));
+    ASSERT_EQ(analyzer.diagnostics().size(), 1);
+    EXPECT_EQ(analyzer.diagnostics()[0].code(), code::inconsistent_type);
+
+    for (auto&& tuple : stmt.tuples()) {
+        for (auto&& element : tuple.elements()) {
+            EXPECT_TRUE(analyzer.expressions().find(element));
+        }
+    }
+    EXPECT_EQ(analyzer.expressions().find(stmt.tuples()[1].elements()[0]).type(), t::int4());
+}
+
 TEST_F(expression_analyzer_statement_test, create_table) {
     auto schema = std::make_shared<schema::declaration>("s");
     statement::create_table stmt {
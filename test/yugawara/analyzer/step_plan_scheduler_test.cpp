@@ -0,0 +1,219 @@
+#include <yugawara/analyzer/step_plan_scheduler.h>
+
+#include <gtest/gtest.h>
+
+#include <takatori/type/primitive.h>
+
+#include <takatori/relation/scan.h>
+#include <takatori/relation/values.h>
+#include <takatori/relation/emit.h>
+
+#include <takatori/plan/graph.h>
+#include <takatori/plan/process.h>
+#include <takatori/plan/forward.h>
+
+#include <yugawara/binding/factory.h>
+#include <yugawara/storage/configurable_provider.h>
+
+#include <yugawara/analyzer/details/collect_step_relations.h>
+
+#include <yugawara/testing/utils.h>
+
+namespace yugawara::analyzer {
+
+// import test utils
+using namespace ::yugawara::testing;
+
+class step_plan_scheduler_test : public ::testing::Test {
+protected:
+    binding::factory bindings;
+    storage::configurable_provider storages;
+
+    std::shared_ptr<storage::table> t0 = storages.add_table({
+            "T0",
+            {
+                    { "C0", t::int4() },
+            },
+    });
+    std::shared_ptr<storage::index> i0 = storages.add_index({ t0, "I0", });
+
+    plan::process& values(plan::graph_type& p, std::size_t count, plan::exchange& destination) {
+        auto&& process = p.insert(plan::process {});
+        std::vector<relation::values::row> rows {};
+        for (std::size_t i = 0; i < count; ++i) {
+            rows.emplace_back(relation::values::row { constant(static_cast<int>(i)) });
+        }
+        auto& r0 = process.operators().insert(relation::values {
+                { bindings.stream_variable(), },
+                std::move(rows),
+        });
+        auto& r1 = process.operators().insert(offer {
+                bindings(destination),
+        });
+        r0.output() >> r1.input();
+        return process;
+    }
+
+    plan::process& forward(plan::graph_type& p, plan::exchange& source, plan::exchange* destination) {
+        auto&& process = p.insert(plan::process {});
+        auto& r0 = process.operators().insert(take_flat {
+                bindings(source),
+        });
+        if (destination != nullptr) {
+            auto& r1 = process.operators().insert(offer {
+                    bindings(*destination),
+            });
+            r0.output() >> r1.input();
+        } else {
+            auto& r1 = process.operators().insert(relation::emit {});
+            r0.output() >> r1.input();
+        }
+        return process;
+    }
+};
+
+TEST_F(step_plan_scheduler_test, simple) {
+    /*
+     * [values:3]:p0 -\
+     *                 e0 - [take_flat]:p2 - e1 - [take_flat]:p3
+     * [values:5]:p1 -/
+     */
+    plan::graph_type p;
+    auto&& e0 = p.insert(plan::forward {});
+    auto&& e1 = p.insert(plan::forward {});
+    auto&& p0 = values(p, 3, e0);
+    auto&& p1 = values(p, 5, e0);
+    auto&& p2 = forward(p, e0, std::addressof(e1));
+    auto&& p3 = forward(p, e1, nullptr);
+    details::collect_step_relations(p);
+
+    step_plan_scheduler scheduler { 4, 2 };
+    auto results = scheduler(p);
+    ASSERT_EQ(results.size(), 4);
+
+    auto&& s0 = results.at(std::addressof(p0));
+    EXPECT_EQ(s0.level(), 0);
+    EXPECT_FALSE(s0.critical());
+    EXPECT_EQ(s0.estimated_rows(), 3);
+    EXPECT_EQ(s0.parallelism(), 2);
+
+    auto&& s1 = results.at(std::addressof(p1));
+    EXPECT_EQ(s1.level(), 0);
+    EXPECT_TRUE(s1.critical());
+    EXPECT_EQ(s1.estimated_rows(), 5);
+    EXPECT_EQ(s1.parallelism(), 3);
+
+    auto&& s2 = results.at(std::addressof(p2));
+    EXPECT_EQ(s2.level(), 1);
+    EXPECT_TRUE(s2.critical());
+    EXPECT_EQ(s2.estimated_rows(), 8);
+    EXPECT_EQ(s2.parallelism(), 4);
+
+    auto&& s3 = results.at(std::addressof(p3));
+    EXPECT_EQ(s3.level(), 2);
+    EXPECT_TRUE(s3.critical());
+    EXPECT_EQ(s3.estimated_rows(), 8);
+    EXPECT_EQ(s3.parallelism(), 4);
+}
+
+TEST_F(step_plan_scheduler_test, critical_tie_level) {
+    /*
+     * [values:3]:p0 - e0 - [take_flat]:p1
+     * [values:2]:p2 - e1 - [take_flat]:p3 - e2 - [take_flat]:p4
+     */
+    plan::graph_type p;
+    auto&& e0 = p.insert(plan::forward {});
+    auto&& e1 = p.insert(plan::forward {});
+    auto&& e2 = p.insert(plan::forward {});
+    auto&& p0 = values(p, 3, e0);
+    auto&& p1 = forward(p, e0, nullptr);
+    auto&& p2 = values(p, 2, e1);
+    auto&& p3 = forward(p, e1, std::addressof(e2));
+    auto&& p4 = forward(p, e2, nullptr);
+    details::collect_step_relations(p);
+
+    step_plan_scheduler scheduler { 4, 2 };
+    auto results = scheduler(p);
+    ASSERT_EQ(results.size(), 5);
+
+    // both paths weigh 6, but the latter is deeper
+    EXPECT_FALSE(results.at(std::addressof(p0)).critical());
+    EXPECT_FALSE(results.at(std::addressof(p1)).critical());
+    EXPECT_TRUE(results.at(std::addressof(p2)).critical());
+    EXPECT_TRUE(results.at(std::addressof(p3)).critical());
+    EXPECT_TRUE(results.at(std::addressof(p4)).critical());
+}
+
+TEST_F(step_plan_scheduler_test, critical_tie_order) {
+    /*
+     * [values:3]:p0 - e0 - [take_flat]:p1
+     * [values:3]:p2 - e1 - [take_flat]:p3
+     */
+    plan::graph_type p;
+    auto&& e0 = p.insert(plan::forward {});
+    auto&& e1 = p.insert(plan::forward {});
+    auto&& p0 = values(p, 3, e0);
+    auto&& p1 = forward(p, e0, nullptr);
+    auto&& p2 = values(p, 3, e1);
+    auto&& p3 = forward(p, e1, nullptr);
+    details::collect_step_relations(p);
+
+    step_plan_scheduler scheduler { 4, 2 };
+    auto results = scheduler(p);
+    ASSERT_EQ(results.size(), 4);
+
+    // both paths weigh 6 at the same level, then the former comes first
+    EXPECT_TRUE(results.at(std::addressof(p0)).critical());
+    EXPECT_TRUE(results.at(std::addressof(p1)).critical());
+    EXPECT_FALSE(results.at(std::addressof(p2)).critical());
+    EXPECT_FALSE(results.at(std::addressof(p3)).critical());
+}
+
+TEST_F(step_plan_scheduler_test, unknown) {
+    /*
+     * [scan]:p0 -\
+     *             e0 - [take_flat]:p2
+     * [values:5]:p1 -/
+     */
+    plan::graph_type p;
+    auto&& e0 = p.insert(plan::forward {});
+    auto&& p0 = p.insert(plan::process {});
+    {
+        auto& r0 = p0.operators().insert(relation::scan {
+                bindings(*i0),
+                {
+                        { bindings(t0->columns()[0]), bindings.stream_variable() },
+                },
+                {},
+                {},
+                {},
+        });
+        auto& r1 = p0.operators().insert(offer {
+                bindings(e0),
+        });
+        r0.output() >> r1.input();
+    }
+    auto&& p1 = values(p, 5, e0);
+    auto&& p2 = forward(p, e0, nullptr);
+    details::collect_step_relations(p);
+
+    step_plan_scheduler scheduler { 4, 2 };
+    auto results = scheduler(p);
+    ASSERT_EQ(results.size(), 3);
+
+    // the scan is not estimated without index estimator
+    auto&& s0 = results.at(std::addressof(p0));
+    EXPECT_EQ(s0.level(), 0);
+    EXPECT_EQ(s0.estimated_rows(), std::nullopt);
+    EXPECT_EQ(s0.parallelism(), 1);
+
+    auto&& s1 = results.at(std::addressof(p1));
+    EXPECT_EQ(s1.estimated_rows(), 5);
+
+    auto&& s2 = results.at(std::addressof(p2));
+    EXPECT_EQ(s2.level(), 1);
+    EXPECT_EQ(s2.estimated_rows(), std::nullopt);
+    EXPECT_EQ(s2.parallelism(), 1);
+}
+
+} // namespace yugawara::analyzer
@@ -0,0 +1,191 @@
+#include <yugawara/analyzer/variable_layout_planner.h>
+
+#include <gtest/gtest.h>
+
+#include <unordered_map>
+
+#include <takatori/graph/graph.h>
+
+#include <takatori/scalar/variable_reference.h>
+
+#include <takatori/relation/project.h>
+#include <takatori/relation/buffer.h>
+#include <takatori/relation/step/offer.h>
+#include <takatori/relation/step/take_flat.h>
+
+#include <takatori/plan/forward.h>
+
+#include <yugawara/binding/factory.h>
+
+#include <yugawara/analyzer/block_builder.h>
+#include <yugawara/analyzer/block_algorithm.h>
+
+namespace yugawara::analyzer {
+
+namespace relation = ::takatori::relation;
+namespace scalar = ::takatori::scalar;
+using take = relation::step::take_flat;
+using offer = relation::step::offer;
+using buffer = relation::buffer;
+
+using rgraph = ::takatori::graph::graph<relation::expression>;
+
+class variable_layout_planner_test : public ::testing::Test {
+public:
+    binding::factory bindings;
+    ::takatori::plan::forward f1 {
+            bindings.exchange_column(),
+            bindings.exchange_column(),
+            bindings.exchange_column(),
+    };
+    ::takatori::plan::forward f2 {
+            bindings.exchange_column(),
+            bindings.exchange_column(),
+            bindings.exchange_column(),
+    };
+    ::takatori::plan::forward f3 {
+            bindings.exchange_column(),
+    };
+
+    std::unordered_map<::takatori::descriptor::variable, variable_layout_planner::shape> shapes {};
+
+    variable_layout_planner::shape_provider provider() {
+        return [this](::takatori::descriptor::variable const& variable) {
+            if (auto it = shapes.find(variable); it != shapes.end()) {
+                return it->second;
+            }
+            return variable_layout_planner::shape { 4, 4 };
+        };
+    }
+
+    static std::size_t offset(variable_layout const& layout, ::takatori::descriptor::variable const& variable) {
+        auto slot = layout.find(variable);
+        if (!slot) {
+            ADD_FAILURE() << variable;
+            return static_cast<std::size_t>(-1);
+        }
+        return slot->offset();
+    }
+};
+
+TEST_F(variable_layout_planner_test, alignment) {
+    rgraph rg;
+
+    auto&& c1 = bindings.stream_variable("c1");
+    auto&& c2 = bindings.stream_variable("c2");
+    auto&& c3 = bindings.stream_variable("c3");
+    auto&& r1 = rg.insert(take {
+            bindings.exchange(f1),
+            {
+                    { f1.columns()[0], c1 },
+                    { f1.columns()[1], c2 },
+                    { f1.columns()[2], c3 },
+            },
+    });
+    auto&& r2 = rg.insert(offer {
+            bindings.exchange(f2),
+            {
+                    { c1, f2.columns()[0] },
+                    { c2, f2.columns()[1] },
+                    { c3, f2.columns()[2] },
+            },
+    });
+    r1.output() >> r2.input();
+    shapes.emplace(c1, variable_layout_planner::shape { 1, 1 });
+    shapes.emplace(c2, variable_layout_planner::shape { 8, 8 });
+    shapes.emplace(c3, variable_layout_planner::shape { 4, 4 });
+
+    auto bg = block_builder::build(rg);
+    variable_liveness_analyzer liveness { bg };
+    variable_layout_planner planner { bg, liveness, provider() };
+
+    ASSERT_EQ(bg.size(), 1);
+    auto&& b0 = *find_unique_head(bg); // r1 .. r2
+    auto&& n0 = planner.inspect(b0);
+
+    EXPECT_EQ(n0.record_size(), 16);
+    EXPECT_EQ(n0.record_alignment(), 8);
+    ASSERT_EQ(n0.slots().size(), 3);
+    EXPECT_EQ(*n0.find(c2), (variable_slot { 0, 8, 8 }));
+    EXPECT_EQ(*n0.find(c3), (variable_slot { 8, 4, 4 }));
+    EXPECT_EQ(*n0.find(c1), (variable_slot { 12, 1, 1 }));
+}
+
+TEST_F(variable_layout_planner_test, buffer) {
+    rgraph rg;
+
+    auto&& c1 = bindings.stream_variable("c1");
+    auto&& c2 = bindings.stream_variable("c2");
+    auto&& r1 = rg.insert(take {
+            bindings.exchange(f1),
+            {
+                    { f1.columns()[0], c1 },
+                    { f1.columns()[1], c2 },
+            },
+    });
+    auto&& r2 = rg.insert(buffer { 2 });
+    auto&& x = bindings.stream_variable("x");
+    auto&& r3 = rg.insert(relation::project {
+            relation::project::column {
+                    scalar::variable_reference { c1 },
+                    x,
+            },
+    });
+    auto&& r4 = rg.insert(offer {
+            bindings.exchange(f2),
+            {
+                    { x, f2.columns()[0] },
+            },
+    });
+    auto&& y = bindings.stream_variable("y");
+    auto&& r5 = rg.insert(relation::project {
+            relation::project::column {
+                    scalar::variable_reference { c2 },
+                    y,
+            },
+    });
+    auto&& r6 = rg.insert(offer {
+            bindings.exchange(f3),
+            {
+                    { y, f3.columns()[0] },
+            },
+    });
+    r1.output() >> r2.input();
+    r2.output_ports()[0] >> r3.input();
+    r3.output() >> r4.input();
+    r2.output_ports()[1] >> r5.input();
+    r5.output() >> r6.input();
+
+    auto bg = block_builder::build(rg);
+    variable_liveness_analyzer liveness { bg };
+    variable_layout_planner planner { bg, liveness, provider() };
+
+    ASSERT_EQ(bg.size(), 3);
+    auto&& b0 = *find_unique_head(bg); // r1 .. r2
+    auto&& b1 = b0.downstream(r2.output_ports()[0]); // r3 .. r4
+    auto&& b2 = b0.downstream(r2.output_ports()[1]); // r5 .. r6
+
+    auto&& n0 = planner.inspect(b0);
+    auto&& n1 = planner.inspect(b1);
+    auto&& n2 = planner.inspect(b2);
+
+    // x and y never alive at the same time, so that one of them can reuse a slot
+    EXPECT_EQ(n0.record_size(), 12);
+    EXPECT_EQ(n1.record_size(), 12);
+    EXPECT_EQ(n2.record_size(), 12);
+
+    ASSERT_EQ(n0.slots().size(), 2);
+    EXPECT_NE(offset(n0, c1), offset(n0, c2));
+
+    // c2 has been killed in b1
+    ASSERT_EQ(n1.slots().size(), 2);
+    EXPECT_NE(offset(n1, c1), offset(n1, x));
+    EXPECT_EQ(offset(n1, c1), offset(n0, c1));
+
+    // c1 has been killed in b2
+    ASSERT_EQ(n2.slots().size(), 2);
+    EXPECT_NE(offset(n2, c2), offset(n2, y));
+    EXPECT_EQ(offset(n2, c2), offset(n0, c2));
+}
+
+} // namespace yugawara::analyzer
@@ -487,6 +487,71 @@ TEST_F(variable_liveness_analyzer_test, buffer) {
     }), no_error);
 }
 
+TEST_F(variable_liveness_analyzer_test, buffer_last_use) {
+    rgraph rg;
+
+    auto&& c1 = bindings.stream_variable("c1");
+    auto&& c2 = bindings.stream_variable("c2");
+    auto&& c3 = bindings.stream_variable("c3");
+    auto&& r1 = rg.insert(take {
+            bindings.exchange(f1),
+            {
+                    { f1.columns()[0], c1 },
+                    { f1.columns()[1], c2 },
+                    { f1.columns()[2], c3 },
+            },
+    });
+    auto&& r2 = rg.insert(relation::filter {
+            scalar::variable_reference { c3 }
+    });
+    auto&& r3 = rg.insert(buffer { 2 });
+    auto&& r4 = rg.insert(offer {
+            bindings.exchange(f2),
+            {
+                    { c1, f2.columns()[0] },
+                    { c1, f2.columns()[1] },
+                    { c1, f2.columns()[2] },
+            },
+    });
+    auto&& r5 = rg.insert(offer {
+            bindings.exchange(f3),
+            {
+                    { c2, f3.columns()[0] },
+                    { c2, f3.columns()[1] },
+                    { c2, f3.columns()[2] },
+            },
+    });
+    r1.output() >> r2.input();
+    r2.output() >> r3.input();
+    r3.output_ports()[0] >> r4.input();
+    r3.output_ports()[1] >> r5.input();
+
+    auto bg = block_builder::build(rg);
+    variable_liveness_analyzer analyzer { bg };
+
+    ASSERT_EQ(bg.size(), 3);
+    auto&& b0 = *find_unique_head(bg); // r1 .. r3
+    auto&& b1 = b0.downstream(r3.output_ports()[0]); // r4
+    auto&& b2 = b0.downstream(r3.output_ports()[1]); // r5
+
+    // c3 is last used in the branching block, so that it is killed in each branch
+    auto&& n0 = analyzer.inspect(b0);
+    EXPECT_EQ(eq(n0.kill(), {
+    }), no_error);
+
+    auto&& n1 = analyzer.inspect(b1);
+    EXPECT_EQ(eq(n1.kill(), {
+            c2,
+            c3,
+    }), no_error);
+
+    auto&& n2 = analyzer.inspect(b2);
+    EXPECT_EQ(eq(n2.kill(), {
+            c1,
+            c3,
+    }), no_error);
+}
+
 TEST_F(variable_liveness_analyzer_test, identify) {
     rgraph rg;
 
@@ -1,5 +1,7 @@
 #include <yugawara/compiler.h>
 
+#include <limits>
+
 #include <gtest/gtest.h>
 
 #include <takatori/type/primitive.h>
@@ -20,6 +22,8 @@
 #include <takatori/relation/intermediate/aggregate.h>
 #include <takatori/relation/step/join.h>
 
+#include <takatori/scalar/function_call.h>
+
 #include <takatori/plan/group.h>
 
 #include <takatori/statement/execute.h>
@@ -37,6 +41,8 @@
 #include <yugawara/binding/factory.h>
 #include <yugawara/storage/configurable_provider.h>
 #include <yugawara/variable/declaration.h>
+#include <yugawara/function/declaration.h>
+#include <yugawara/aggregate/declaration.h>
 
 #include <yugawara/extension/scalar/subquery.h>
 #include <yugawara/extension/scalar/exists.h>
@@ -121,6 +127,23 @@ protected:
         return {};
     }
 
+    static std::size_t depth(scalar::expression const& expr) {
+        std::size_t result = 0;
+        std::vector<std::pair<scalar::expression const*, std::size_t>> stack {};
+        stack.emplace_back(std::addressof(expr), 1);
+        while (!stack.empty()) {
+            auto [current, level] = stack.back();
+            stack.pop_back();
+            result = std::max(result, level);
+            if (current->kind() == scalar::binary::tag) {
+                auto&& binary = downcast<scalar::binary>(*current);
+                stack.emplace_back(std::addressof(binary.left()), level + 1);
+                stack.emplace_back(std::addressof(binary.right()), level + 1);
+            }
+        }
+        return result;
+    }
+
     static void dump(compiler_result const& r) {
         std::cout << ::testing::UnitTest::GetInstance()->current_test_info()->name() << ": ";
         ::takatori::serializer::json_printer printer { std::cout };
@@ -166,6 +189,11 @@ TEST_F(compiler_test, graph_emit) {
     EXPECT_EQ(result.type_of(bindings(t0c0)), t::int4());
     EXPECT_EQ(result.type_of(c0p0), t::int4());
 
+    auto dependencies = result.dependencies();
+    EXPECT_TRUE(dependencies.depends_on(*i0));
+    EXPECT_TRUE(dependencies.depends_on(static_cast<storage::relation const&>(*t0)));
+    EXPECT_TRUE(dependencies.functions().empty());
+
     dump(result);
 
     // inspection
@@ -226,7 +254,7 @@ TEST_F(compiler_test, graph_update) {
     filter.output() >> project.input();
     project.output() >> out.input();
 
-    storages->add_index({
+    auto i1 = storages->add_index({
             t0,
             "I0C1",
             {
@@ -285,6 +313,90 @@ TEST_F(compiler_test, graph_update) {
         EXPECT_EQ(result.type_of(b.right()), t::int4());
     }
 
+    // both the index to find and the index to write
+    auto dependencies = result.dependencies();
+    EXPECT_TRUE(dependencies.depends_on(*i0));
+    EXPECT_TRUE(dependencies.depends_on(*i1));
+    EXPECT_EQ(dependencies.indices().size(), 2);
+    EXPECT_EQ(dependencies.relations().size(), 1);
+
+    dump(result);
+}
+
+TEST_F(compiler_test, graph_dependencies) {
+    /*
+     * SELECT c0, count(*) FROM t0 WHERE c0 = f(c1) AND c1 = :q0 GROUP BY c0
+     */
+    auto f0 = std::make_shared<function::declaration>(function::declaration {
+            function::declaration::minimum_user_function_id + 1,
+            "f",
+            t::int4 {},
+            {
+                    t::int4 {},
+            },
+    });
+    auto q0 = std::make_shared<variable::declaration>(variable::declaration {
+            "q0",
+            t::int4 {},
+    });
+    auto a0 = std::make_shared<aggregate::declaration>(aggregate::declaration {
+            aggregate::declaration::minimum_user_function_id + 1,
+            "count",
+            t::int8 {},
+            {},
+            true,
+    });
+
+    relation::graph_type r;
+    auto c0 = bindings.stream_variable("c0");
+    auto c1 = bindings.stream_variable("c1");
+    auto&& in = r.insert(relation::scan {
+            bindings(*i0),
+            {
+                    { bindings(t0c0), c0 },
+                    { bindings(t0c1), c1 },
+            },
+    });
+    auto&& filter = r.insert(relation::filter {
+            land(
+                    compare(
+                            varref { c0 },
+                            scalar::function_call {
+                                    bindings(f0),
+                                    {
+                                            varref { c1 },
+                                    },
+                            }),
+                    compare(varref { c1 }, varref { bindings(q0) })),
+    });
+    auto x0 = bindings.stream_variable("x0");
+    auto&& aggregate = r.insert(relation::intermediate::aggregate {
+            { c0 },
+            {
+                    { bindings(a0), {}, x0 },
+            },
+    });
+    auto&& out = r.insert(relation::emit { c0, x0 });
+    in.output() >> filter.input();
+    filter.output() >> aggregate.input();
+    aggregate.output() >> out.input();
+
+    auto result = compiler()(options(), std::move(r));
+    ASSERT_TRUE(result) << diagnostics(result);
+
+    auto dependencies = result.dependencies();
+    EXPECT_TRUE(dependencies.depends_on(*i0));
+    EXPECT_TRUE(dependencies.depends_on(static_cast<storage::relation const&>(*t0)));
+
+    ASSERT_EQ(dependencies.functions().size(), 1);
+    EXPECT_TRUE(dependencies.depends_on(*f0));
+
+    ASSERT_EQ(dependencies.variables().size(), 1);
+    EXPECT_TRUE(dependencies.depends_on(*q0));
+
+    ASSERT_EQ(dependencies.aggregates().size(), 1);
+    EXPECT_TRUE(dependencies.depends_on(*a0));
+
     dump(result);
 }
 
@@ -359,6 +471,13 @@ TEST_F(compiler_test, write) {
         EXPECT_EQ(result.type_of(vs[1]), t::int4());
         EXPECT_EQ(result.type_of(vs[2]), t::int4());
     }
+
+    auto dependencies = result.dependencies();
+    EXPECT_TRUE(dependencies.depends_on(*i0));
+    EXPECT_TRUE(dependencies.depends_on(static_cast<storage::relation const&>(*t0)));
+    EXPECT_TRUE(dependencies.variables().empty());
+    EXPECT_TRUE(dependencies.functions().empty());
+    EXPECT_TRUE(dependencies.aggregates().empty());
 }
 
 TEST_F(compiler_test, write_error) {
@@ -1770,4 +1889,179 @@ TEST_F(compiler_test, feat_quantified_compare_filter) {
     dump(result);
 }
 
+TEST_F(compiler_test, feat_large_in_list) {
+    /*
+     * SELECT c0 FROM t0 WHERE c0 IN (4999, 4998, ..., 0, 0)
+     */
+    constexpr std::size_t count = 5'000;
+    relation::graph_type r;
+    auto c0 = bindings.stream_variable("c0");
+    auto&& in = r.insert(relation::scan {
+            bindings(*i0),
+            {
+                    { bindings(t0c0), c0 },
+            },
+    });
+    std::unique_ptr<scalar::expression> condition = std::make_unique<scalar::compare>(
+            compare(varref { c0 }, constant(static_cast<int>(count - 1))));
+    for (std::size_t i = 1; i <= count; ++i) {
+        condition = std::make_unique<scalar::binary>(
+                scalar::binary_operator::conditional_or,
+                std::move(condition),
+                std::make_unique<scalar::compare>(
+                        compare(varref { c0 }, constant(static_cast<int>(count - std::min(i + 1, count))))));
+    }
+    auto&& filter = r.insert(relation::filter { std::move(condition) });
+    auto&& out = r.insert(relation::emit { c0 });
+    in.output() >> filter.input();
+    filter.output() >> out.input();
+
+    auto result = compiler()(options(), std::move(r));
+    ASSERT_TRUE(result) << diagnostics(result);
+
+    // the duplicated term was removed, and the disjunction became a balanced tree
+    EXPECT_EQ(depth(filter.condition()), 14);
+    EXPECT_EQ(result.type_of(filter.condition()), t::boolean());
+}
+
+TEST_F(compiler_test, feat_deep_conjunction) {
+    /*
+     * SELECT c0 FROM t0 WHERE c0 <> 0 AND c0 <> 1 AND ... AND c0 <> 9999
+     */
+    constexpr std::size_t count = 10'000;
+    relation::graph_type r;
+    auto c0 = bindings.stream_variable("c0");
+    auto&& in = r.insert(relation::scan {
+            bindings(*i0),
+            {
+                    { bindings(t0c0), c0 },
+            },
+    });
+    std::unique_ptr<scalar::expression> condition = std::make_unique<scalar::compare>(
+            compare(varref { c0 }, constant(0), scalar::comparison_operator::not_equal));
+    for (std::size_t i = 1; i < count; ++i) {
+        condition = std::make_unique<scalar::binary>(
+                scalar::binary_operator::conditional_and,
+                std::move(condition),
+                std::make_unique<scalar::compare>(
+                        compare(varref { c0 }, constant(static_cast<int>(i)), scalar::comparison_operator::not_equal)));
+    }
+    auto&& filter = r.insert(relation::filter { std::move(condition) });
+    auto&& out = r.insert(relation::emit { c0 });
+    in.output() >> filter.input();
+    filter.output() >> out.input();
+
+    auto result = compiler()(options(), std::move(r));
+    ASSERT_TRUE(result) << diagnostics(result);
+
+    auto&& c = downcast<statement::execute>(result.statement());
+    ASSERT_EQ(c.execution_plan().size(), 1);
+    auto&& p0 = find(c.execution_plan(), in);
+
+    // the compiled conditions are still balanced trees
+    std::size_t filters = 0;
+    for (auto&& expr : p0.operators()) {
+        if (expr.kind() == relation::filter::tag) {
+            auto&& f = downcast<relation::filter>(expr);
+            EXPECT_LE(depth(f.condition()), 15);
+            EXPECT_EQ(result.type_of(f.condition()), t::boolean());
+            ++filters;
+        }
+    }
+    EXPECT_GE(filters, 1);
+}
+
+TEST_F(compiler_test, feat_broadcast_size_limit) {
+    auto t1 = storages->add_table({
+            "T1",
+            {
+                    { "C0", t::int4() },
+                    { "C1", t::int4() },
+            },
+    });
+    auto i1 = storages->add_index({ t1, "I1", });
+
+    // T0 has 10G rows, and T1 has 100M rows
+    class table_size_estimator : public analyzer::index_estimator {
+    public:
+        [[nodiscard]] result operator()(
+                storage::index const& index,
+                ::takatori::util::sequence_view<search_key const>,
+                ::takatori::util::sequence_view<sort_key const>,
+                ::takatori::util::sequence_view<column_ref const>) const override {
+            if (index.simple_name() == "I0") {
+                return { 1.0, 10'000'000'000ULL, {} };
+            }
+            return { 1.0, 100'000'000ULL, {} };
+        }
+    };
+    indices = std::make_shared<table_size_estimator>();
+
+    /*
+     * SELECT T0.C0, T1.C0 FROM T0 LEFT OUTER JOIN T1 ON T0.C0 = T1.C0 AND T1.C1 = 0
+     */
+    auto build = [&]() {
+        relation::graph_type r;
+        auto l0 = bindings.stream_variable("l0");
+        auto l1 = bindings.stream_variable("l1");
+        auto&& inl = r.insert(relation::scan {
+                bindings(*i0),
+                {
+                        { bindings(t0c0), l0 },
+                        { bindings(t0c1), l1 },
+                },
+        });
+        auto r0 = bindings.stream_variable("r0");
+        auto r1 = bindings.stream_variable("r1");
+        auto&& inr = r.insert(relation::scan {
+                bindings(*i1),
+                {
+                        { bindings(t1->columns()[0]), r0 },
+                        { bindings(t1->columns()[1]), r1 },
+                },
+        });
+        auto&& join = r.insert(relation::intermediate::join {
+                relation::join_kind::left_outer,
+                land(
+                        compare(varref(l0), varref(r0)),
+                        compare(varref(r1), constant(0))),
+        });
+        auto&& out = r.insert(relation::emit { l0, r0 });
+        inl.output() >> join.left();
+        inr.output() >> join.right();
+        join.output() >> out.input();
+        return r;
+    };
+    auto count_broadcast = [](statement::execute const& stmt) {
+        std::size_t result = 0;
+        for (auto&& step : stmt.execution_plan()) {
+            if (step.kind() == plan::step_kind::broadcast) {
+                ++result;
+            }
+        }
+        return result;
+    };
+
+    auto opts = options();
+    opts.runtime_features().erase(runtime_feature::index_join);
+
+    // broadcasting T1 is cheaper than co-group, but it exceeds the limit
+    {
+        auto result = compiler()(opts, build());
+        ASSERT_TRUE(result) << diagnostics(result);
+
+        auto&& c = downcast<statement::execute>(result.statement());
+        EXPECT_EQ(count_broadcast(c), 0);
+        dump(result);
+    }
+    opts.broadcast_build_size_limit() = std::numeric_limits<std::size_t>::max();
+    {
+        auto result = compiler()(opts, build());
+        ASSERT_TRUE(result) << diagnostics(result);
+
+        auto&& c = downcast<statement::execute>(result.statement());
+        EXPECT_EQ(count_broadcast(c), 1);
+    }
+}
+
 } // namespace yugawara
@@ -112,6 +112,53 @@ TEST_F(function_configurable_provider_test, each_name) {
     EXPECT_EQ(r[1]->definition_id(), declaration::minimum_system_function_id + 3);
 }
 
+TEST_F(function_configurable_provider_test, each_order) {
+    auto p1 = std::make_shared<configurable_provider>();
+    p1->add({
+            declaration::minimum_system_function_id + 1,
+            "b",
+            t::int4(),
+            {
+                    t::int4(),
+            },
+    });
+    p1->add({
+            declaration::minimum_system_function_id + 2,
+            "a",
+            t::int4(),
+            {
+                    t::int8(),
+            },
+    });
+    p1->add({
+            declaration::minimum_system_function_id + 3,
+            "a",
+            t::int4(),
+            {
+                    t::int4(),
+            },
+    });
+
+    // ordered by their name
+    std::vector<declaration const*> r;
+    p1->each([&](auto d){
+        r.emplace_back(d.get());
+    });
+    ASSERT_EQ(r.size(), 3);
+    EXPECT_EQ(r[0]->definition_id(), declaration::minimum_system_function_id + 2);
+    EXPECT_EQ(r[1]->definition_id(), declaration::minimum_system_function_id + 3);
+    EXPECT_EQ(r[2]->definition_id(), declaration::minimum_system_function_id + 1);
+
+    // ordered by their addition, even if the latter is more specific
+    std::vector<declaration const*> overloads;
+    p1->each("a", 1, [&](auto d){
+        overloads.emplace_back(d.get());
+    });
+    ASSERT_EQ(overloads.size(), 2);
+    EXPECT_EQ(overloads[0]->definition_id(), declaration::minimum_system_function_id + 2);
+    EXPECT_EQ(overloads[1]->definition_id(), declaration::minimum_system_function_id + 3);
+}
+
 TEST_F(function_configurable_provider_test, each_parent) {
     auto p1 = std::make_shared<configurable_provider>();
     auto p2 = std::make_shared<configurable_provider>(p1);
@@ -199,4 +246,220 @@ TEST_F(function_configurable_provider_test, each_name_parent) {
     EXPECT_EQ(r[1]->definition_id(), declaration::minimum_system_function_id + 3);
 }
 
+TEST_F(function_configurable_provider_test, find) {
+    auto p1 = std::make_shared<configurable_provider>();
+    auto& f1 = p1->add({
+            declaration::minimum_system_function_id + 1,
+            "f",
+            t::int4(),
+            {
+                    t::int4(),
+            },
+    });
+    auto& f2 = p1->add({
+            declaration::minimum_system_function_id + 2,
+            "f",
+            t::int8(),
+            {
+                    t::int8(),
+            },
+    });
+    auto& f3 = p1->add({
+            declaration::minimum_system_function_id + 3,
+            "f",
+            t::float8(),
+            {
+                    t::float8(),
+            },
+    });
+
+    EXPECT_EQ(p1->find("f", { std::make_shared<t::int4>() }), f1);
+    EXPECT_EQ(p1->find("f", { std::make_shared<t::int8>() }), f2);
+    EXPECT_EQ(p1->find("f", { std::make_shared<t::float4>() }), f3);
+    EXPECT_EQ(p1->find("f", { std::make_shared<t::character>(t::varying) }), nullptr);
+    EXPECT_EQ(p1->find("f", {}), nullptr);
+    EXPECT_EQ(p1->find("g", { std::make_shared<t::int4>() }), nullptr);
+}
+
+TEST_F(function_configurable_provider_test, find_ambiguous) {
+    auto p1 = std::make_shared<configurable_provider>();
+    p1->add({
+            declaration::minimum_system_function_id + 1,
+            "f",
+            t::int8(),
+            {
+                    t::int8(),
+                    t::float8(),
+            },
+    });
+    p1->add({
+            declaration::minimum_system_function_id + 2,
+            "f",
+            t::int8(),
+            {
+                    t::float8(),
+                    t::int8(),
+            },
+    });
+
+    EXPECT_EQ(p1->find("f", { std::make_shared<t::int4>(), std::make_shared<t::int4>() }), nullptr);
+}
+
+TEST_F(function_configurable_provider_test, find_parent) {
+    auto p1 = std::make_shared<configurable_provider>();
+    auto p2 = std::make_shared<configurable_provider>(p1);
+
+    auto& f1 = p1->add({
+            declaration::minimum_system_function_id + 1,
+            "f",
+            t::int4(),
+            {
+                    t::int4(),
+            },
+    });
+    auto& f2 = p1->add({
+            declaration::minimum_system_function_id + 2,
+            "g",
+            t::int4(),
+            {
+                    t::int4(),
+            },
+    });
+    auto& f3 = p2->add({
+            declaration::minimum_system_function_id + 3,
+            "g",
+            t::float8(),
+            {
+                    t::float8(),
+            },
+    });
+
+    EXPECT_EQ(p2->find("f", { std::make_shared<t::int4>() }), f1);
+    // declarations in the child hide ones in the parent
+    EXPECT_EQ(p2->find("g", { std::make_shared<t::int4>() }), f3);
+    EXPECT_EQ(p1->find("g", { std::make_shared<t::int4>() }), f2);
+}
+
+TEST_F(function_configurable_provider_test, find_grandparent) {
+    auto p1 = std::make_shared<configurable_provider>();
+    auto p2 = std::make_shared<configurable_provider>(p1);
+    auto p3 = std::make_shared<configurable_provider>(p2);
+
+    p1->add({
+            declaration::minimum_system_function_id + 1,
+            "g",
+            t::int4(),
+            {
+                    t::int4(),
+            },
+    });
+    auto& f2 = p2->add({
+            declaration::minimum_system_function_id + 2,
+            "g",
+            t::float8(),
+            {
+                    t::float8(),
+            },
+    });
+
+    // declarations in the parent also hide ones in the grandparent
+    EXPECT_EQ(p3->find("g", { std::make_shared<t::int4>() }), f2);
+}
+
+TEST_F(function_configurable_provider_test, find_invalidate) {
+    auto p1 = std::make_shared<configurable_provider>();
+    auto& f1 = p1->add({
+            declaration::minimum_system_function_id + 1,
+            "f",
+            t::int8(),
+            {
+                    t::int8(),
+            },
+    });
+    EXPECT_EQ(p1->find("f", { std::make_shared<t::int4>() }), f1);
+
+    auto& f2 = p1->add({
+            declaration::minimum_system_function_id + 2,
+            "f",
+            t::int4(),
+            {
+                    t::int4(),
+            },
+    });
+    EXPECT_EQ(p1->find("f", { std::make_shared<t::int4>() }), f2);
+
+    EXPECT_TRUE(p1->remove(*f2));
+    EXPECT_EQ(p1->find("f", { std::make_shared<t::int4>() }), f1);
+}
+
+TEST_F(function_configurable_provider_test, find_cache_eviction) {
+    auto p1 = std::make_shared<configurable_provider>(nullptr, 2);
+    auto& f1 = p1->add({
+            declaration::minimum_system_function_id + 1,
+            "f",
+            t::int8(),
+            {
+                    t::int8(),
+            },
+    });
+    auto& f2 = p1->add({
+            declaration::minimum_system_function_id + 2,
+            "f",
+            t::float8(),
+            {
+                    t::float8(),
+            },
+    });
+
+    // overflows the cache
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_EQ(p1->find("f", { std::make_shared<t::int1>() }), f1);
+        EXPECT_EQ(p1->find("f", { std::make_shared<t::int4>() }), f1);
+        EXPECT_EQ(p1->find("f", { std::make_shared<t::float4>() }), f2);
+    }
+
+    auto& f3 = p1->add({
+            declaration::minimum_system_function_id + 3,
+            "f",
+            t::int4(),
+            {
+                    t::int4(),
+            },
+    });
+    EXPECT_EQ(p1->find("f", { std::make_shared<t::int1>() }), f3);
+    EXPECT_EQ(p1->find("f", { std::make_shared<t::int4>() }), f3);
+    EXPECT_EQ(p1->find("f", { std::make_shared<t::float4>() }), f2);
+}
+
+TEST_F(function_configurable_provider_test, epoch) {
+    auto p1 = std::make_shared<configurable_provider>();
+    auto p2 = std::make_shared<configurable_provider>(p1);
+    EXPECT_EQ(p2->epoch(), 0);
+
+    auto&& f1 = p1->add({
+            declaration::minimum_system_function_id + 1,
+            "f",
+            t::int4(),
+            {
+                    t::int4(),
+            },
+    });
+    auto e1 = p2->epoch();
+    EXPECT_GT(e1, 0);
+
+    p2->add({
+            declaration::minimum_system_function_id + 2,
+            "g",
+            t::int4(),
+            {
+                    t::int4(),
+            },
+    });
+    auto e2 = p2->epoch();
+    EXPECT_GT(e2, e1);
+
+    EXPECT_TRUE(p1->remove(*f1));
+    EXPECT_GT(p2->epoch(), e2);
+}
+
 } // namespace yugawara::function
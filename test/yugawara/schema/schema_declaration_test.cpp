@@ -2,6 +2,8 @@
 
 #include <gtest/gtest.h>
 
+#include <takatori/type/primitive.h>
+
 #include <takatori/util/downcast.h>
 
 #include <yugawara/storage/null_provider.h>
@@ -66,4 +68,74 @@ TEST_F(schema_declaration_test, output) {
     std::cout << d << std::endl;
 }
 
+TEST_F(schema_declaration_test, epoch) {
+    auto st = std::make_shared<storage::configurable_provider>();
+    auto va = std::make_shared<variable::configurable_provider>();
+    auto fn = std::make_shared<function::configurable_provider>();
+    auto sf = std::make_shared<aggregate::configurable_provider>();
+    auto ty = std::make_shared<type::configurable_provider>();
+
+    declaration d { 1, "s", st, va, fn, sf, ty };
+    auto e0 = d.epoch();
+
+    st->add_table(storage::table { "T0" });
+    auto e1 = d.epoch();
+    EXPECT_GT(e1, e0);
+
+    va->add({ "v0", ::takatori::type::int4 {} });
+    auto e2 = d.epoch();
+    EXPECT_GT(e2, e1);
+
+    fn->add({
+            function::declaration::minimum_user_function_id + 1,
+            "f",
+            ::takatori::type::int4 {},
+            {},
+    });
+    auto e3 = d.epoch();
+    EXPECT_GT(e3, e2);
+
+    sf->add({
+            aggregate::declaration::minimum_user_function_id + 1,
+            "a",
+            ::takatori::type::int4 {},
+            {},
+    });
+    EXPECT_GT(d.epoch(), e3);
+}
+
+TEST_F(schema_declaration_test, epoch_replace_provider) {
+    auto st = std::make_shared<storage::configurable_provider>();
+    st->add_table(storage::table { "T0" });
+    st->add_table(storage::table { "T1" });
+    auto fn = std::make_shared<function::configurable_provider>();
+    fn->add({
+            function::declaration::minimum_user_function_id + 1,
+            "f",
+            ::takatori::type::int4 {},
+            {},
+    });
+
+    declaration d { 1, "s", st, {}, fn };
+    auto e0 = d.epoch();
+
+    // the new providers have smaller epochs than the old ones
+    d.storage_provider(std::make_shared<storage::configurable_provider>());
+    auto e1 = d.epoch();
+    EXPECT_GT(e1, e0);
+
+    d.function_provider(std::make_shared<function::configurable_provider>());
+    auto e2 = d.epoch();
+    EXPECT_GT(e2, e1);
+
+    // back to the original one
+    d.storage_provider(st);
+    auto e3 = d.epoch();
+    EXPECT_GT(e3, e2);
+
+    // clear the provider
+    d.function_provider({});
+    EXPECT_GT(d.epoch(), e3);
+}
+
 } // namespace yugawara::schema
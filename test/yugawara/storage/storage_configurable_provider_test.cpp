@@ -490,6 +490,172 @@ TEST_F(storage_configurable_provider_test, find_primary_index_shortcircuit_table
     EXPECT_FALSE(p1->find_primary_index(*parent));
 }
 
+TEST_F(storage_configurable_provider_test, find_primary_index_parent) {
+    auto p1 = std::make_shared<configurable_provider>();
+    auto&& parent = p1->add_table({
+            "TBL",
+            {
+                    { "C1", t::int4() },
+            },
+    });
+    auto&& element = p1->add_index({
+            parent,
+            "IDX",
+            {
+                    parent->columns()[0],
+            },
+            {},
+            {
+                    index_feature::primary,
+            },
+    });
+    auto p2 = std::make_shared<configurable_provider>(p1);
+    EXPECT_EQ(p2->find_primary_index(*parent), element);
+    EXPECT_FALSE(p2->find_primary_index(*origin));
+}
+
+TEST_F(storage_configurable_provider_test, find_primary_index_remove) {
+    auto p1 = std::make_shared<configurable_provider>();
+    auto&& parent = p1->add_table({
+            "TBL",
+            {
+                    { "C1", t::int4() },
+            },
+    });
+    auto&& e1 = p1->add_index({
+            parent,
+            "I1",
+            {
+                    parent->columns()[0],
+            },
+            {},
+            {
+                    index_feature::primary,
+            },
+    });
+    auto&& e2 = p1->add_index({
+            parent,
+            parent->simple_name(),
+            {
+                    parent->columns()[0],
+            },
+            {},
+            {
+                    index_feature::primary,
+            },
+    });
+    EXPECT_EQ(p1->find_primary_index(*parent), e2);
+
+    EXPECT_TRUE(p1->remove_index(parent->simple_name()));
+    EXPECT_EQ(p1->find_primary_index(*parent), e1);
+
+    EXPECT_TRUE(p1->remove_index("I1"));
+    EXPECT_FALSE(p1->find_primary_index(*parent));
+}
+
+TEST_F(storage_configurable_provider_test, each_table_index) {
+    auto p1 = std::make_shared<configurable_provider>();
+    auto&& e1 = p1->add_index({
+            origin,
+            "I1",
+            {
+                    c1,
+            },
+    });
+    p1->add_index({
+            origin,
+            "I2",
+            {
+                    c1,
+            },
+    });
+
+    auto p2 = std::make_shared<configurable_provider>(p1);
+    auto&& other = p2->add_table({
+            "TBL",
+            {
+                    { "C1", t::int4() },
+            },
+    });
+    auto&& e2 = p2->add_index({
+            origin,
+            "I2",
+            {
+                    c1,
+            },
+    }, true); // hiding
+    p2->add_index({
+            other,
+            "I3",
+            {
+                    other->columns()[0],
+            },
+    });
+
+    std::vector<std::shared_ptr<index const>> saw;
+    p2->each_table_index(*origin, [&](auto id, auto& element) {
+        if (id != element->simple_name()) {
+            throw std::runtime_error("fail");
+        }
+        saw.emplace_back(element);
+    });
+    EXPECT_EQ(saw.size(), 2);
+    EXPECT_NE(std::find(saw.begin(), saw.end(), e1), saw.end());
+    EXPECT_NE(std::find(saw.begin(), saw.end(), e2), saw.end());
+}
+
+TEST_F(storage_configurable_provider_test, snapshot) {
+    auto p1 = std::make_shared<snapshot_configurable_provider>();
+    auto&& parent = p1->add_table({
+            "TBL",
+            {
+                    { "C1", t::int4() },
+            },
+    });
+    auto&& element = p1->add_index({
+            parent,
+            parent->simple_name(),
+            {
+                    parent->columns()[0],
+            },
+            {},
+            {
+                    index_feature::primary,
+            },
+    });
+    EXPECT_EQ(p1->find_table("TBL"), parent);
+    EXPECT_EQ(p1->find_index("TBL"), element);
+    EXPECT_EQ(p1->find_primary_index(*parent), element);
+
+    std::vector<std::shared_ptr<index const>> saw;
+    p1->each_table_index(*parent, [&](auto, auto& e) {
+        saw.emplace_back(e);
+    });
+    ASSERT_EQ(saw.size(), 1);
+    EXPECT_EQ(saw[0], element);
+
+    EXPECT_TRUE(p1->remove_index("TBL"));
+    EXPECT_FALSE(p1->find_index("TBL"));
+    EXPECT_FALSE(p1->find_primary_index(*parent));
+}
+
+TEST_F(storage_configurable_provider_test, epoch) {
+    auto p1 = std::make_shared<configurable_provider>();
+    auto p2 = std::make_shared<configurable_provider>(p1);
+    EXPECT_EQ(p2->epoch(), 0);
+
+    p1->add_table(table { "T1" });
+    auto e1 = p2->epoch();
+    EXPECT_GT(e1, 0);
+
+    p2->add_table(table { "T2" });
+    auto e2 = p2->epoch();
+    EXPECT_GT(e2, e1);
+
+    EXPECT_TRUE(p1->remove_relation("T1"));
+    EXPECT_GT(p2->epoch(), e2);
+}
+
 TEST_F(storage_configurable_provider_test, add_index_conflict) {
     auto p1 = std::make_shared<configurable_provider>();
     auto&& element = p1->add_index({
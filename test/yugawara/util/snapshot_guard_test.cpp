@@ -0,0 +1,83 @@
+#include <yugawara/util/snapshot_guard.h>
+
+#include <map>
+#include <shared_mutex>
+#include <stdexcept>
+#include <string>
+
+#include <gtest/gtest.h>
+
+namespace yugawara::util {
+
+class snapshot_guard_test : public ::testing::Test {};
+
+using map_type = std::map<std::string, int>;
+
+TEST_F(snapshot_guard_test, lock) {
+    snapshot_guard<map_type, std::shared_mutex> guard {};
+    static_assert(!decltype(guard)::lock_free_read);
+    {
+        auto contents = guard.write();
+        contents->emplace("a", 1);
+    }
+    EXPECT_EQ(guard.version(), 1);
+
+    auto contents = guard.read();
+    ASSERT_EQ(contents->size(), 1);
+    EXPECT_EQ(contents->at("a"), 1);
+}
+
+TEST_F(snapshot_guard_test, snapshot) {
+    snapshot_guard<map_type, snapshot_mutex> guard {};
+    static_assert(decltype(guard)::lock_free_read);
+
+    auto before = guard.read();
+    {
+        auto contents = guard.write();
+        contents->emplace("a", 1);
+    }
+    auto after = guard.read();
+
+    // readers keep the snapshot when they start reading
+    EXPECT_EQ(before->size(), 0);
+    ASSERT_EQ(after->size(), 1);
+    EXPECT_EQ(after->at("a"), 1);
+}
+
+TEST_F(snapshot_guard_test, snapshot_batch) {
+    snapshot_guard<map_type, snapshot_mutex> guard {};
+    for (int i = 0; i < 10; ++i) {
+        auto contents = guard.write();
+        contents->emplace(std::to_string(i), i);
+    }
+    EXPECT_EQ(guard.version(), 10);
+
+    // the first reader publishes all modifications at once
+    auto first = guard.read();
+    ASSERT_EQ(first->size(), 10);
+    EXPECT_EQ(first->at("9"), 9);
+
+    // the subsequent readers share the same snapshot
+    auto second = guard.read();
+    EXPECT_EQ(std::addressof(*second), std::addressof(*first));
+}
+
+TEST_F(snapshot_guard_test, snapshot_exception) {
+    snapshot_guard<map_type, snapshot_mutex> guard {};
+    try {
+        auto contents = guard.write();
+        contents->emplace("a", 1);
+        throw std::runtime_error { "testing" };
+    } catch (std::runtime_error const&) {
+        // ignore
+    }
+    // the modification is not published
+    EXPECT_EQ(guard.read()->size(), 0);
+    {
+        auto contents = guard.write();
+        contents->emplace("b", 2);
+    }
+    EXPECT_EQ(guard.read()->size(), 2);
+}
+
+} // namespace yugawara::util
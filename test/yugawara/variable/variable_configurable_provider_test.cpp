@@ -108,4 +108,21 @@ TEST_F(variable_configurable_provider_test, each_parent) {
     EXPECT_EQ(v[2], v23.get());
 }
 
+TEST_F(variable_configurable_provider_test, epoch) {
+    auto p1 = std::make_shared<configurable_provider>();
+    auto p2 = std::make_shared<configurable_provider>(p1);
+    EXPECT_EQ(p2->epoch(), 0);
+
+    auto v1 = p1->add({ "v1", c(1), });
+    auto e1 = p2->epoch();
+    EXPECT_GT(e1, 0);
+
+    p2->add({ "v2", c(2), });
+    auto e2 = p2->epoch();
+    EXPECT_GT(e2, e1);
+
+    EXPECT_TRUE(p1->remove(*v1));
+    EXPECT_GT(p2->epoch(), e2);
+}
+
 } // namespace yugawara::variable